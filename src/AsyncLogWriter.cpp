@@ -0,0 +1,39 @@
+#include "AsyncLogWriter.h"
+
+#if ENABLE_ASYNC_LOGGING
+#include "sleep.h"
+
+// Backstop in case a wakeup raced with us going idle
+#define ASYNC_LOG_IDLE_MS 1000
+
+AsyncLogWriter *asyncLogWriter;
+
+AsyncLogWriter::AsyncLogWriter() : concurrency::OSThread("AsyncLog")
+{
+    deepSleepObserver.observe(&notifyDeepSleep);
+    rebootObserver.observe(&notifyReboot);
+    DEBUG_PORT.setDeferLogs(true, &AsyncLogWriter::wake);
+}
+
+void AsyncLogWriter::wake()
+{
+    if (asyncLogWriter)
+        asyncLogWriter->setIntervalFromNow(ASYNC_LOG_FLUSH_MS);
+}
+
+void AsyncLogWriter::flush()
+{
+    DEBUG_PORT.drainDeferredLogs();
+}
+
+int32_t AsyncLogWriter::runOnce()
+{
+    return DEBUG_PORT.drainDeferredLogs(ASYNC_LOG_BATCH) ? 0 : ASYNC_LOG_IDLE_MS;
+}
+
+int AsyncLogWriter::beforeSleepOrReboot(void *unused)
+{
+    flush();
+    return 0;
+}
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "configuration.h"
+
+#if ENABLE_ASYNC_LOGGING
+#include "Observer.h"
+#include "concurrency/OSThread.h"
+
+// How long after the first message lands in an empty ring we write it out, lets a burst be written in one go
+#ifndef ASYNC_LOG_FLUSH_MS
+#define ASYNC_LOG_FLUSH_MS 20
+#endif
+
+// Messages written per run, so a full ring can't hold up the main loop for long
+#ifndef ASYNC_LOG_BATCH
+#define ASYNC_LOG_BATCH 16
+#endif
+
+/**
+ * Writes out the log messages that RedirectablePrint captured into its ring.
+ *
+ * With ENABLE_ASYNC_LOGGING a LOG_* call only copies its format and arguments, the vsnprintf and the (slow) serial,
+ * syslog and BLE output happen here at low priority instead of inside whatever time critical code logged.
+ * Anything still queued is written before reboot or sleep.
+ */
+class AsyncLogWriter : private concurrency::OSThread
+{
+  public:
+    AsyncLogWriter();
+
+    /// Write everything that is queued right now
+    void flush();
+
+  protected:
+    int32_t runOnce() override;
+
+  private:
+    static void wake();
+
+    int beforeSleepOrReboot(void *unused);
+
+    CallbackObserver<AsyncLogWriter, void *> deepSleepObserver =
+        CallbackObserver<AsyncLogWriter, void *>(this, &AsyncLogWriter::beforeSleepOrReboot);
+    CallbackObserver<AsyncLogWriter, void *> rebootObserver =
+        CallbackObserver<AsyncLogWriter, void *>(this, &AsyncLogWriter::beforeSleepOrReboot);
+};
+
+extern AsyncLogWriter *asyncLogWriter;
+#endif
@@ -53,12 +53,29 @@ extern MemGet memGet;
 #define LOG_TRACE(...) SEGGER_RTT_printf(0, __VA_ARGS__)
 #else
 #if defined(DEBUG_PORT) && !defined(DEBUG_MUTE)
+// MESHTASTIC_EXCLUDE_LOG_<level> compiles that level out entirely, its arguments are not even evaluated
+#if MESHTASTIC_EXCLUDE_LOG_DEBUG
+#define LOG_DEBUG(...)
+#else
 #define LOG_DEBUG(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
+#if MESHTASTIC_EXCLUDE_LOG_INFO
+#define LOG_INFO(...)
+#else
 #define LOG_INFO(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_INFO, __VA_ARGS__)
+#endif
+#if MESHTASTIC_EXCLUDE_LOG_WARN
+#define LOG_WARN(...)
+#else
 #define LOG_WARN(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_WARN, __VA_ARGS__)
+#endif
 #define LOG_ERROR(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_ERROR, __VA_ARGS__)
 #define LOG_CRIT(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_CRIT, __VA_ARGS__)
+#if MESHTASTIC_EXCLUDE_LOG_TRACE
+#define LOG_TRACE(...)
+#else
 #define LOG_TRACE(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_TRACE, __VA_ARGS__)
+#endif
 #else
 #define LOG_DEBUG(...)
 #define LOG_INFO(...)
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Durations in usecs, kept as a log2 histogram: bucket b counts 2^b..2^(b+1)-1 usecs, the last bucket everything above.
+ *
+ * Gives percentiles in 2 bytes per bucket instead of a sample buffer.  Used for the per-thread run times (ThreadProfile)
+ * and the per-hop packet latencies (PacketLatency).
+ */
+template <int N> struct Log2Histogram {
+    static constexpr int NUM_BUCKETS = N;
+
+    uint32_t count = 0;
+    uint64_t totalUs = 0;
+    uint32_t maxUs = 0;
+    uint16_t buckets[NUM_BUCKETS] = {};
+
+    void record(uint32_t us)
+    {
+        count++;
+        totalUs += us;
+        if (us > maxUs)
+            maxUs = us;
+
+        int b = 31 - __builtin_clz(us | 1);
+        if (b >= NUM_BUCKETS)
+            b = NUM_BUCKETS - 1;
+
+        // Halve everything rather than saturate, the distribution is what matters
+        if (buckets[b] == UINT16_MAX)
+            for (auto &n : buckets)
+                n /= 2;
+        buckets[b]++;
+    }
+
+    /// @return upper bound of the duration (usecs) that percent of the samples stayed under
+    uint32_t percentileUs(uint8_t percent) const
+    {
+        uint32_t total = 0;
+        for (auto n : buckets)
+            total += n;
+        if (!total)
+            return 0;
+
+        uint32_t wanted = (total * percent + 99) / 100, seen = 0;
+        for (int b = 0; b < NUM_BUCKETS - 1; b++) {
+            seen += buckets[b];
+            if (seen >= wanted)
+                return (2UL << b) - 1;
+        }
+        return maxUs;
+    }
+};
@@ -0,0 +1,436 @@
+#include "LogRing.h"
+#include <cstring>
+#include <stdio.h>
+
+namespace
+{
+
+enum class Length : uint8_t { None, hh, h, l, ll, j, z, t, L };
+
+/// One printf conversion, as found by parseSpec()
+struct Spec {
+    const char *prefixStart; // flags, width and precision (just after the '%')
+    const char *prefixEnd;   // start of the length modifier
+    const char *lengthEnd;   // the conversion character
+    bool starWidth;
+    bool starPrecision;
+    int precision; // -1 if none was given, or not yet known for a '*'
+    Length length;
+    char conv; // '\0' if the format ended in the middle of the spec
+};
+
+/// Parse the conversion starting at p (just after the '%'), @return the first character after it
+const char *parseSpec(const char *p, Spec &s)
+{
+    s.prefixStart = p;
+    s.starWidth = s.starPrecision = false;
+    s.precision = -1;
+    while (*p && strchr("-+ #0", *p))
+        p++;
+    if (*p == '*') {
+        s.starWidth = true;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9')
+            p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            s.starPrecision = true;
+            p++;
+        } else {
+            s.precision = 0;
+            while (*p >= '0' && *p <= '9')
+                s.precision = s.precision * 10 + (*p++ - '0');
+        }
+    }
+    s.prefixEnd = p;
+
+    s.length = Length::None;
+    switch (*p) {
+    case 'h':
+        p++;
+        s.length = (*p == 'h') ? Length::hh : Length::h;
+        if (*p == 'h')
+            p++;
+        break;
+    case 'l':
+        p++;
+        s.length = (*p == 'l') ? Length::ll : Length::l;
+        if (*p == 'l')
+            p++;
+        break;
+    case 'j':
+        s.length = Length::j;
+        p++;
+        break;
+    case 'z':
+        s.length = Length::z;
+        p++;
+        break;
+    case 't':
+        s.length = Length::t;
+        p++;
+        break;
+    case 'L':
+        s.length = Length::L;
+        p++;
+        break;
+    }
+    s.lengthEnd = p;
+
+    s.conv = *p;
+    if (*p)
+        p++;
+    return p;
+}
+
+bool isSignedConv(char c)
+{
+    return c == 'd' || c == 'i';
+}
+
+bool isUnsignedConv(char c)
+{
+    return c == 'u' || c == 'o' || c == 'x' || c == 'X';
+}
+
+bool isFloatConv(char c)
+{
+    return c == 'f' || c == 'F' || c == 'e' || c == 'E' || c == 'g' || c == 'G' || c == 'a' || c == 'A';
+}
+
+int64_t readSigned(Length length, va_list &arg)
+{
+    switch (length) {
+    case Length::l:
+        return va_arg(arg, long);
+    case Length::ll:
+        return va_arg(arg, long long);
+    case Length::j:
+        return va_arg(arg, intmax_t);
+    case Length::z:
+        return (ptrdiff_t)va_arg(arg, size_t);
+    case Length::t:
+        return va_arg(arg, ptrdiff_t);
+    default:
+        return va_arg(arg, int); // char and short were promoted to int
+    }
+}
+
+uint64_t readUnsigned(Length length, va_list &arg)
+{
+    switch (length) {
+    case Length::l:
+        return va_arg(arg, unsigned long);
+    case Length::ll:
+        return va_arg(arg, unsigned long long);
+    case Length::j:
+        return va_arg(arg, uintmax_t);
+    case Length::z:
+        return va_arg(arg, size_t);
+    case Length::t:
+        return (size_t)va_arg(arg, ptrdiff_t);
+    default:
+        return va_arg(arg, unsigned int);
+    }
+}
+
+/// Bounded writer for building a record
+struct RecordWriter {
+    uint8_t *buf;
+    size_t len;
+    bool overflow;
+
+    void put(const void *src, size_t n)
+    {
+        if (len + n > LOG_RING_MAX_RECORD) {
+            overflow = true;
+            return;
+        }
+        memcpy(buf + len, src, n);
+        len += n;
+    }
+
+    /// Copy a string, truncating it (rather than failing) if it is too long for the space left
+    void putString(const char *s, size_t maxLen)
+    {
+        size_t room = (len < LOG_RING_MAX_RECORD) ? LOG_RING_MAX_RECORD - len : 0;
+        if (room == 0) {
+            overflow = true;
+            return;
+        }
+        size_t n = strnlen(s, maxLen);
+        if (n > room - 1)
+            n = room - 1;
+        memcpy(buf + len, s, n);
+        buf[len + n] = '\0';
+        len += n + 1;
+    }
+
+    template <typename T> void putValue(T v) { put(&v, sizeof(v)); }
+};
+
+/// Reader for a record that has been copied out of the ring
+struct RecordReader {
+    const uint8_t *p;
+
+    template <typename T> T get()
+    {
+        T v;
+        memcpy(&v, p, sizeof(v));
+        p += sizeof(v);
+        return v;
+    }
+
+    const char *getString()
+    {
+        const char *s = (const char *)p;
+        p += strlen(s) + 1;
+        return s;
+    }
+};
+
+/// Format a single argument, spec has the length modifier already adjusted for what we pass
+int formatArg(char *out, size_t outLen, const char *spec, const Spec &s, RecordReader &r)
+{
+    if (isSignedConv(s.conv)) {
+        int64_t v = r.get<int64_t>();
+        switch (s.length) {
+        case Length::l:
+            return snprintf(out, outLen, spec, (long)v);
+        case Length::ll:
+            return snprintf(out, outLen, spec, (long long)v);
+        case Length::j:
+            return snprintf(out, outLen, spec, (intmax_t)v);
+        case Length::z:
+        case Length::t:
+            return snprintf(out, outLen, spec, (ptrdiff_t)v);
+        default:
+            return snprintf(out, outLen, spec, (int)v);
+        }
+    } else if (isUnsignedConv(s.conv)) {
+        uint64_t v = r.get<uint64_t>();
+        switch (s.length) {
+        case Length::l:
+            return snprintf(out, outLen, spec, (unsigned long)v);
+        case Length::ll:
+            return snprintf(out, outLen, spec, (unsigned long long)v);
+        case Length::j:
+            return snprintf(out, outLen, spec, (uintmax_t)v);
+        case Length::z:
+        case Length::t:
+            return snprintf(out, outLen, spec, (size_t)v);
+        default:
+            return snprintf(out, outLen, spec, (unsigned int)v);
+        }
+    } else if (isFloatConv(s.conv)) {
+        return snprintf(out, outLen, spec, r.get<double>());
+    }
+
+    switch (s.conv) {
+    case 'c':
+        return snprintf(out, outLen, spec, (int)r.get<int64_t>());
+    case 's':
+        return snprintf(out, outLen, spec, r.getString());
+    case 'p':
+        return snprintf(out, outLen, spec, (void *)(uintptr_t)r.get<uint64_t>());
+    default:
+        return 0; // %n and anything we don't understand print nothing
+    }
+}
+
+} // namespace
+
+bool LogRing::canDefer(const char *format)
+{
+    // Leave room for the header and at least a few arguments
+    return strnlen(format, LOG_RING_MAX_RECORD) < LOG_RING_MAX_RECORD / 2;
+}
+
+bool LogRing::push(const char *logLevel, const char *source, uint32_t ms, const char *format, va_list arg)
+{
+    if (!canDefer(format))
+        return false;
+
+    uint8_t rec[LOG_RING_MAX_RECORD];
+    RecordWriter w = {rec, sizeof(uint16_t), false}; // length prefix is filled in last
+
+    w.putValue(ms);
+    w.putValue(logLevel);
+    w.putString(source ? source : "", LOG_RING_SOURCE_LEN - 1);
+    w.putString(format, LOG_RING_MAX_RECORD);
+
+    va_list copy;
+    va_copy(copy, arg);
+    for (const char *p = format; *p && !w.overflow;) {
+        if (*p++ != '%')
+            continue;
+        if (*p == '%') {
+            p++;
+            continue;
+        }
+
+        Spec s;
+        p = parseSpec(p, s);
+        if (s.starWidth)
+            w.putValue<int64_t>(va_arg(copy, int));
+        if (s.starPrecision) {
+            s.precision = va_arg(copy, int); // negative means none, same as printf
+            w.putValue<int64_t>(s.precision);
+        }
+
+        if (isSignedConv(s.conv)) {
+            w.putValue<int64_t>(readSigned(s.length, copy));
+        } else if (isUnsignedConv(s.conv)) {
+            w.putValue<uint64_t>(readUnsigned(s.length, copy));
+        } else if (isFloatConv(s.conv)) {
+            // long double gets narrowed, nobody logs anything that needs more than a double
+            w.putValue<double>(s.length == Length::L ? (double)va_arg(copy, long double) : va_arg(copy, double));
+        } else {
+            switch (s.conv) {
+            case 'c':
+                w.putValue<int64_t>(va_arg(copy, int));
+                break;
+            case 's':
+                if (s.length == Length::l) {
+                    va_arg(copy, void *); // wide strings aren't worth supporting
+                    w.putString("?", 1);
+                } else {
+                    // With a precision the argument need not be nul terminated (e.g. payload bytes), never read past it
+                    const char *str = va_arg(copy, const char *);
+                    w.putString(str ? str : "(null)", s.precision >= 0 ? (size_t)s.precision : LOG_RING_MAX_RECORD);
+                }
+                break;
+            case 'p':
+                w.putValue<uint64_t>((uintptr_t)va_arg(copy, void *));
+                break;
+            case 'n':
+                va_arg(copy, void *);
+                break;
+            }
+        }
+    }
+    va_end(copy);
+
+    if (w.overflow)
+        return false;
+
+    uint16_t len = w.len;
+    memcpy(rec, &len, sizeof(len));
+
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (len > LOG_RING_SIZE - (h - t))
+        return false;
+
+    copyIn(h, rec, len);
+    head.store(h + len, std::memory_order_release);
+    return true;
+}
+
+bool LogRing::pop(Entry &entry, char *buf, size_t bufLen)
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (t == h)
+        return false;
+
+    uint16_t len;
+    uint8_t rec[LOG_RING_MAX_RECORD];
+    copyOut(t, (uint8_t *)&len, sizeof(len));
+    if (len < sizeof(len) || len > LOG_RING_MAX_RECORD || len > h - t) {
+        // Only a producer breaking the one-at-a-time rule gets us here, nothing in the ring can be trusted
+        tail.store(h, std::memory_order_release);
+        return false;
+    }
+    copyOut(t, rec, len);
+    tail.store(t + len, std::memory_order_release); // we work from our private copy from here on
+
+    RecordReader r = {rec + sizeof(len)};
+    entry.millis = r.get<uint32_t>();
+    entry.logLevel = r.get<const char *>();
+    strncpy(entry.source, r.getString(), sizeof(entry.source) - 1);
+    entry.source[sizeof(entry.source) - 1] = '\0';
+    const char *format = r.getString();
+
+    if (bufLen == 0)
+        return true;
+
+    size_t o = 0;
+    auto advance = [&](int n) {
+        if (n > 0)
+            o += ((size_t)n < bufLen - o) ? (size_t)n : bufLen - o - 1;
+    };
+
+    for (const char *p = format; *p && o < bufLen - 1;) {
+        if (*p != '%') {
+            const char *next = strchr(p, '%');
+            size_t n = next ? (size_t)(next - p) : strlen(p);
+            if (n > bufLen - 1 - o)
+                n = bufLen - 1 - o;
+            memcpy(buf + o, p, n);
+            o += n;
+            p += n;
+            continue;
+        }
+
+        p++;
+        if (*p == '%') {
+            buf[o++] = '%';
+            p++;
+            continue;
+        }
+
+        Spec s;
+        const char *specStart = p - 1;
+        p = parseSpec(p, s);
+        if (!s.conv) {
+            advance(snprintf(buf + o, bufLen - o, "%s", specStart)); // malformed tail, show it as is
+            break;
+        }
+
+        // Rebuild the spec with any '*' replaced by the captured value
+        char spec[32];
+        size_t n = 0;
+        spec[n++] = '%';
+        for (const char *q = s.prefixStart; q < s.prefixEnd && n < sizeof(spec) - 16; q++) {
+            if (*q != '*') {
+                spec[n++] = *q;
+                continue;
+            }
+            int v = (int)r.get<int64_t>();
+            if (v < 0 && n > 0 && spec[n - 1] == '.')
+                n--; // a negative precision means no precision at all
+            else
+                n += snprintf(spec + n, sizeof(spec) - n, "%d", v);
+        }
+        if (isSignedConv(s.conv) || isUnsignedConv(s.conv)) {
+            for (const char *q = s.prefixEnd; q < s.lengthEnd; q++)
+                spec[n++] = *q;
+        }
+        spec[n++] = s.conv;
+        spec[n] = '\0';
+
+        advance(formatArg(buf + o, bufLen - o, spec, s, r));
+    }
+    buf[o] = '\0';
+    return true;
+}
+
+void LogRing::copyIn(uint32_t pos, const uint8_t *src, size_t len)
+{
+    size_t start = pos % LOG_RING_SIZE;
+    size_t first = (len < LOG_RING_SIZE - start) ? len : LOG_RING_SIZE - start;
+    memcpy(storage + start, src, first);
+    memcpy(storage, src + first, len - first);
+}
+
+void LogRing::copyOut(uint32_t pos, uint8_t *dest, size_t len) const
+{
+    size_t start = pos % LOG_RING_SIZE;
+    size_t first = (len < LOG_RING_SIZE - start) ? len : LOG_RING_SIZE - start;
+    memcpy(dest, storage + start, first);
+    memcpy(dest + first, storage, len - first);
+}
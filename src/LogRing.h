@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bytes of storage for deferred log messages, a typical record is 40-100 bytes
+#ifndef LOG_RING_SIZE
+#ifdef ARCH_PORTDUINO
+#define LOG_RING_SIZE (32 * 1024)
+#else
+#define LOG_RING_SIZE 4096
+#endif
+#endif
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+
+// Largest single record (header, format text and arguments), longer %s arguments get truncated to fit
+#define LOG_RING_MAX_RECORD 256
+
+// Room for the thread name stored with each record
+#define LOG_RING_SOURCE_LEN 16
+
+/**
+ * A ring of not yet formatted log messages.
+ *
+ * push() copies the format text plus the raw printf arguments (%s strings are copied too, since the caller's buffer
+ * won't live that long) which is far cheaper than running vsnprintf.  pop() does the actual formatting later, on
+ * whichever thread drains the ring.
+ *
+ * The format text is copied rather than just keeping the pointer because plenty of LOG_* callers pass a buffer
+ * built at runtime instead of a literal.
+ *
+ * One producer and one consumer can use the ring at the same time without locking.  If there are several producers
+ * they must serialize their push() calls.
+ */
+class LogRing
+{
+  public:
+    /// Everything about a popped message except its text
+    struct Entry {
+        const char *logLevel; // one of the MESHTASTIC_LOG_LEVEL_* strings
+        uint32_t millis;      // when the message was captured
+        char source[LOG_RING_SOURCE_LEN];
+    };
+
+    /**
+     * Store a message for later formatting.
+     * @param source name of the thread which logged this, can be null
+     * @return false if the message was dropped because the ring is full or the format is too long to defer
+     */
+    bool push(const char *logLevel, const char *source, uint32_t ms, const char *format, va_list arg);
+
+    /**
+     * Format the oldest message into buf (always nul terminated, no trailing newline is added) and remove it.
+     * @return false if the ring was empty
+     */
+    bool pop(Entry &entry, char *buf, size_t bufLen);
+
+    /// @return true if the format is short enough that push() can defer it
+    static bool canDefer(const char *format);
+
+    bool isEmpty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+    /// Bytes currently waiting to be drained
+    size_t used() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+    static constexpr size_t capacity() { return LOG_RING_SIZE; }
+
+#ifndef PIO_UNIT_TESTING
+  private:
+#endif
+    uint8_t storage[LOG_RING_SIZE];
+
+    // Free running byte counts, only ever written by the producer (head) or the consumer (tail)
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+
+    void copyIn(uint32_t pos, const uint8_t *src, size_t len);
+    void copyOut(uint32_t pos, uint8_t *dest, size_t len) const;
+};
@@ -13,9 +13,10 @@
 #define MESSAGE_TEXT_POOL_SIZE (MAX_MESSAGES_SAVED * MAX_MESSAGE_SIZE)
 #endif
 
-// Default autosave interval 2 hours, override per device later with -DMESSAGE_AUTOSAVE_INTERVAL_SEC=300 (etc)
+// Default autosave interval 5 minutes (saves only append new messages to the log), override per device with
+// -DMESSAGE_AUTOSAVE_INTERVAL_SEC=3600 (etc)
 #ifndef MESSAGE_AUTOSAVE_INTERVAL_SEC
-#define MESSAGE_AUTOSAVE_INTERVAL_SEC (2 * 60 * 60)
+#define MESSAGE_AUTOSAVE_INTERVAL_SEC (5 * 60)
 #endif
 
 // Global message text pool and state
@@ -93,20 +94,11 @@ template <typename T> static inline void pushWithLimit(std::deque<T> &queue, T &
 
 MessageStore::MessageStore(const std::string &label)
 {
-    filename = "/Messages_" + label + ".msgs";
+    filename = "/Messages_" + label + ".log";
+    legacyFilename = "/Messages_" + label + ".msgs";
     resetMessagePool(); // initialize text pool on boot
 }
 
-// Live message handling (RAM only)
-void MessageStore::addLiveMessage(StoredMessage &&msg)
-{
-    pushWithLimit(liveMessages, std::move(msg));
-}
-void MessageStore::addLiveMessage(const StoredMessage &msg)
-{
-    pushWithLimit(liveMessages, msg);
-}
-
 #if ENABLE_MESSAGE_PERSISTENCE
 static bool g_messageStoreHasUnsavedChanges = false;
 static uint32_t g_lastAutoSaveMs = 0; // last time we actually saved
@@ -161,6 +153,27 @@ static inline void autosaveTick(MessageStore *store)
 }
 #endif
 
+// Live message handling (RAM, persisted by the next saveToFlash())
+void MessageStore::addLiveMessage(StoredMessage &&msg)
+{
+    msg.id = nextId++;
+#if ENABLE_MESSAGE_PERSISTENCE
+    // The history limit is about to push out the oldest message, the log needs an explicit tombstone for it
+    if (liveMessages.size() >= MAX_MESSAGES_SAVED && liveMessages.front().id <= lastPersistedId)
+        pendingTombstones.push_back(liveMessages.front().id);
+#endif
+    pushWithLimit(liveMessages, std::move(msg));
+    changeCount++;
+#if ENABLE_MESSAGE_PERSISTENCE
+    markMessageStoreUnsaved();
+#endif
+}
+void MessageStore::addLiveMessage(const StoredMessage &msg)
+{
+    StoredMessage copy = msg;
+    addLiveMessage(std::move(copy));
+}
+
 // Add from incoming/outgoing packet
 const StoredMessage &MessageStore::addFromPacket(const meshtastic_MeshPacket &packet)
 {
@@ -189,11 +202,7 @@ const StoredMessage &MessageStore::addFromPacket(const meshtastic_MeshPacket &pa
         sm.ackStatus = AckStatus::ACKED;
     }
 
-    addLiveMessage(sm);
-
-#if ENABLE_MESSAGE_PERSISTENCE
-    markMessageStoreUnsaved();
-#endif
+    addLiveMessage(std::move(sm));
 
     return liveMessages.back();
 }
@@ -218,94 +227,345 @@ void MessageStore::addFromString(uint32_t sender, uint8_t channelIndex, const st
     // Outgoing messages always start with unknown ack status
     sm.ackStatus = AckStatus::NONE;
 
-    addLiveMessage(sm);
+    addLiveMessage(std::move(sm));
+}
 
 #if ENABLE_MESSAGE_PERSISTENCE
-    markMessageStoreUnsaved();
+
+// Compact the log once it holds this many records (adds + tombstones + ack updates)
+#ifndef MESSAGE_LOG_COMPACT_RECORDS
+#define MESSAGE_LOG_COMPACT_RECORDS (4 * MAX_MESSAGES_SAVED)
 #endif
-}
 
-#if ENABLE_MESSAGE_PERSISTENCE
+// On-flash message log.
+//
+// The file starts with MESSAGE_LOG_MAGIC, followed by records:
+//   MessageLogRecordHeader | payload (header.length bytes) | uint32_t CRC32 of header + payload
+// Records are only ever appended, so persisting a message costs O(message) rather than a rewrite of the history.
+// Replaying the log in order rebuilds liveMessages.  A record that is short or fails its CRC ends the replay (torn
+// write at power loss), and the next save compacts the log back into a clean snapshot.
+#define MESSAGE_LOG_MAGIC 0x314C534D // "MSL1"
+
+enum class MessageLogRecordKind : uint8_t {
+    ADD = 1,    // MessageLogAdd followed by the text
+    DELETE = 2, // MessageLogDelete (tombstone)
+    ACK = 3     // MessageLogAck
+};
 
-// Compact, fixed-size on-flash representation using offset + length
-struct __attribute__((packed)) StoredMessageRecord {
+struct __attribute__((packed)) MessageLogRecordHeader {
+    uint8_t kind;    // MessageLogRecordKind
+    uint16_t length; // payload bytes following this header
+};
+
+struct __attribute__((packed)) MessageLogAdd {
+    uint32_t id;
     uint32_t timestamp;
     uint32_t sender;
     uint8_t channelIndex;
     uint32_t dest;
     uint8_t isBootRelative;
-    uint8_t ackStatus;           // static_cast<uint8_t>(AckStatus)
-    uint8_t type;                // static_cast<uint8_t>(MessageType)
-    uint16_t textLength;         // message length
-    char text[MAX_MESSAGE_SIZE]; // store actual text here
+    uint8_t ackStatus; // static_cast<uint8_t>(AckStatus)
+    uint8_t type;      // static_cast<uint8_t>(MessageType)
+};
+
+struct __attribute__((packed)) MessageLogDelete {
+    uint32_t id;
+};
+
+struct __attribute__((packed)) MessageLogAck {
+    uint32_t id;
+    uint8_t ackStatus;
 };
 
-// Serialize one StoredMessage to flash
-static inline void writeMessageRecord(SafeFile &f, const StoredMessage &m)
+// Largest possible record: an ADD with a full length message
+#define MESSAGE_LOG_MAX_RECORD                                                                                                   \
+    (sizeof(MessageLogRecordHeader) + sizeof(MessageLogAdd) + MAX_MESSAGE_SIZE + sizeof(uint32_t))
+
+// Encode one record into buf (which must hold MESSAGE_LOG_MAX_RECORD bytes), returns its size
+static size_t encodeLogRecord(uint8_t *buf, MessageLogRecordKind kind, const void *payload, size_t payloadLen,
+                              const char *text = nullptr, size_t textLen = 0)
+{
+    MessageLogRecordHeader header = {static_cast<uint8_t>(kind), static_cast<uint16_t>(payloadLen + textLen)};
+    size_t pos = 0;
+    memcpy(buf + pos, &header, sizeof(header));
+    pos += sizeof(header);
+    memcpy(buf + pos, payload, payloadLen);
+    pos += payloadLen;
+    if (textLen) {
+        memcpy(buf + pos, text, textLen);
+        pos += textLen;
+    }
+    uint32_t crc = SafeFile::updateCRC(0, buf, pos);
+    memcpy(buf + pos, &crc, sizeof(crc));
+    return pos + sizeof(crc);
+}
+
+static size_t encodeAddRecord(uint8_t *buf, const StoredMessage &m)
 {
-    StoredMessageRecord rec = {};
-    rec.timestamp = m.timestamp;
-    rec.sender = m.sender;
-    rec.channelIndex = m.channelIndex;
-    rec.dest = m.dest;
-    rec.isBootRelative = m.isBootRelative;
-    rec.ackStatus = static_cast<uint8_t>(m.ackStatus);
-    rec.type = static_cast<uint8_t>(m.type);
-    rec.textLength = m.textLength;
+    MessageLogAdd add = {};
+    add.id = m.id;
+    add.timestamp = m.timestamp;
+    add.sender = m.sender;
+    add.channelIndex = m.channelIndex;
+    add.dest = m.dest;
+    add.isBootRelative = m.isBootRelative;
+    add.ackStatus = static_cast<uint8_t>(m.ackStatus);
+    add.type = static_cast<uint8_t>(m.type);
 
-    // Copy the actual text into the record from RAM pool
     const char *txt = getTextFromPool(m.textOffset);
-    strncpy(rec.text, txt, MAX_MESSAGE_SIZE - 1);
-    rec.text[MAX_MESSAGE_SIZE - 1] = '\0';
-
-    f.write(reinterpret_cast<const uint8_t *>(&rec), sizeof(rec));
+    size_t len = strnlen(txt, MAX_MESSAGE_SIZE - 1);
+    return encodeLogRecord(buf, MessageLogRecordKind::ADD, &add, sizeof(add), txt, len);
 }
 
-// Deserialize one StoredMessage from flash; returns false on short read
-static inline bool readMessageRecord(File &f, StoredMessage &m)
+// A message being replayed from the log.  Text is held aside until replay finishes, so messages that get deleted
+// later in the log never take up (or wrap) the shared text pool.
+struct ReplayedMessage {
+    StoredMessage msg;
+    std::string text;
+};
+
+// Read and verify the next record, returns false on a torn / corrupt record
+static bool readLogRecord(File &f, MessageLogRecordHeader &header, uint8_t *payload)
 {
-    StoredMessageRecord rec = {};
-    if (f.readBytes(reinterpret_cast<char *>(&rec), sizeof(rec)) != sizeof(rec))
+    uint8_t buf[MESSAGE_LOG_MAX_RECORD];
+    if (f.read(buf, sizeof(header)) != (int)sizeof(header))
+        return false;
+    memcpy(&header, buf, sizeof(header));
+    if (header.length > sizeof(MessageLogAdd) + MAX_MESSAGE_SIZE)
         return false;
 
-    m.timestamp = rec.timestamp;
-    m.sender = rec.sender;
-    m.channelIndex = rec.channelIndex;
-    m.dest = rec.dest;
-    m.isBootRelative = rec.isBootRelative;
-    m.ackStatus = static_cast<AckStatus>(rec.ackStatus);
-    m.type = static_cast<MessageType>(rec.type);
-    m.textLength = rec.textLength;
+    size_t rest = header.length + sizeof(uint32_t);
+    if (f.read(buf + sizeof(header), rest) != (int)rest)
+        return false;
 
-    // 💡 Re-store text into pool and update offset
-    m.textLength = strnlen(rec.text, MAX_MESSAGE_SIZE - 1);
-    m.textOffset = storeTextInPool(rec.text, m.textLength);
+    uint32_t crc;
+    memcpy(&crc, buf + sizeof(header) + header.length, sizeof(crc));
+    if (crc != SafeFile::updateCRC(0, buf, sizeof(header) + header.length))
+        return false;
 
+    memcpy(payload, buf + sizeof(header), header.length);
     return true;
 }
 
-void MessageStore::saveToFlash()
+// Apply one verified record to the replay buffer
+static void applyLogRecord(std::deque<ReplayedMessage> &replay, const MessageLogRecordHeader &header, const uint8_t *payload,
+                           uint32_t &maxId)
+{
+    switch (static_cast<MessageLogRecordKind>(header.kind)) {
+    case MessageLogRecordKind::ADD: {
+        if (header.length < sizeof(MessageLogAdd))
+            return;
+        MessageLogAdd add;
+        memcpy(&add, payload, sizeof(add));
+
+        ReplayedMessage r;
+        r.msg.id = add.id;
+        r.msg.timestamp = add.timestamp;
+        r.msg.sender = add.sender;
+        r.msg.channelIndex = add.channelIndex;
+        r.msg.dest = add.dest;
+        r.msg.isBootRelative = add.isBootRelative;
+        r.msg.ackStatus = static_cast<AckStatus>(add.ackStatus);
+        r.msg.type = static_cast<MessageType>(add.type);
+        r.text.assign(reinterpret_cast<const char *>(payload) + sizeof(add), header.length - sizeof(add));
+        pushWithLimit(replay, std::move(r));
+
+        if (add.id > maxId)
+            maxId = add.id;
+        break;
+    }
+    case MessageLogRecordKind::DELETE: {
+        if (header.length < sizeof(MessageLogDelete))
+            return;
+        MessageLogDelete del;
+        memcpy(&del, payload, sizeof(del));
+        for (auto it = replay.begin(); it != replay.end(); ++it) {
+            if (it->msg.id == del.id) {
+                replay.erase(it);
+                break;
+            }
+        }
+        break;
+    }
+    case MessageLogRecordKind::ACK: {
+        if (header.length < sizeof(MessageLogAck))
+            return;
+        MessageLogAck ack;
+        memcpy(&ack, payload, sizeof(ack));
+        for (auto &r : replay) {
+            if (r.msg.id == ack.id)
+                r.msg.ackStatus = static_cast<AckStatus>(ack.ackStatus);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+bool MessageStore::appendToLog(const uint8_t *records, size_t len, uint32_t n)
+{
+#ifdef FSCom
+    concurrency::LockGuard guard(spiLock);
+
+    // Whatever goes wrong, the records are only in RAM now: rewrite the log from there at the next save
+    bool okay = false;
+    if (FSCom.exists(filename.c_str())) { // If not, compactLog() creates it with a header
+        auto f = FSCom.open(filename.c_str(), FILE_O_APPEND);
+        if (!f) {
+            LOG_ERROR("MessageStore: can't open %s for append", filename.c_str());
+        } else {
+            okay = f.write(records, len) == len;
+            f.close();
+            if (!okay)
+                LOG_ERROR("MessageStore: short write to %s", filename.c_str());
+        }
+    }
+
+    if (!okay) {
+        needsCompaction = true;
+        markMessageStoreUnsaved();
+        return false;
+    }
+    logRecordCount += n;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MessageStore::compactLog()
 {
 #ifdef FSCom
-    // Ensure root exists
+    std::string tmpFilename = filename + ".tmp";
+
     spiLock->lock();
-    FSCom.mkdir("/");
+    FSCom.remove(tmpFilename.c_str());
+    auto f = FSCom.open(tmpFilename.c_str(), FILE_O_WRITE);
+    if (!f) {
+        spiLock->unlock();
+        LOG_ERROR("MessageStore: can't create %s", tmpFilename.c_str());
+        return;
+    }
+
+    uint32_t magic = MESSAGE_LOG_MAGIC;
+    bool okay = f.write(reinterpret_cast<const uint8_t *>(&magic), sizeof(magic)) == sizeof(magic);
+
+    uint8_t buf[MESSAGE_LOG_MAX_RECORD];
+    for (const auto &m : liveMessages) {
+        size_t len = encodeAddRecord(buf, m);
+        okay &= f.write(buf, len) == len;
+    }
+    f.close();
     spiLock->unlock();
 
-    SafeFile f(filename.c_str(), false);
+    if (!okay || !renameFile(tmpFilename.c_str(), filename.c_str())) {
+        LOG_ERROR("MessageStore: compaction of %s failed", filename.c_str());
+        return;
+    }
 
     spiLock->lock();
-    uint8_t count = static_cast<uint8_t>(liveMessages.size());
-    if (count > MAX_MESSAGES_SAVED)
-        count = MAX_MESSAGES_SAVED;
-    f.write(&count, 1);
+    if (FSCom.exists(legacyFilename.c_str()))
+        FSCom.remove(legacyFilename.c_str()); // Fully migrated to the log format
+    spiLock->unlock();
 
-    for (uint8_t i = 0; i < count; ++i) {
-        writeMessageRecord(f, liveMessages[i]);
+    LOG_DEBUG("MessageStore: compacted %u log records into %u", logRecordCount, (uint32_t)liveMessages.size());
+    logRecordCount = liveMessages.size();
+    needsCompaction = false;
+#endif
+}
+
+// Size of an encoded tombstone
+#define MESSAGE_LOG_DELETE_RECORD (sizeof(MessageLogRecordHeader) + sizeof(MessageLogDelete) + sizeof(uint32_t))
+
+// Encode a tombstone for a message id onto the end of a batch of records
+static void encodeDeleteRecord(std::vector<uint8_t> &batch, uint32_t id)
+{
+    uint8_t buf[MESSAGE_LOG_DELETE_RECORD];
+    MessageLogDelete del = {id};
+    size_t len = encodeLogRecord(buf, MessageLogRecordKind::DELETE, &del, sizeof(del));
+    batch.insert(batch.end(), buf, buf + len);
+}
+
+void MessageStore::logDeletions(const std::deque<StoredMessage> &erased)
+{
+    if (!erased.empty())
+        changeCount++;
+
+    // All the tombstones go out in one append, rather than opening the log once per message
+    std::vector<uint8_t> batch;
+    uint32_t n = 0;
+    for (const auto &m : erased) {
+        if (m.id > lastPersistedId)
+            continue; // Never made it to flash, nothing to tombstone
+        encodeDeleteRecord(batch, m.id);
+        n++;
     }
-    spiLock->unlock();
+    if (n)
+        appendToLog(batch.data(), batch.size(), n); // On failure the next save compacts, leaving these out
+}
 
-    f.close();
+void MessageStore::setAckStatus(uint32_t id, AckStatus status)
+{
+    for (auto &m : liveMessages) {
+        if (m.id != id)
+            continue;
+        if (m.ackStatus == status)
+            return;
+        m.ackStatus = status;
+        changeCount++;
+
+        if (id <= lastPersistedId) {
+            uint8_t buf[sizeof(MessageLogRecordHeader) + sizeof(MessageLogAck) + sizeof(uint32_t)];
+            MessageLogAck ack = {id, static_cast<uint8_t>(status)};
+            size_t len = encodeLogRecord(buf, MessageLogRecordKind::ACK, &ack, sizeof(ack));
+            appendToLog(buf, len, 1);
+        }
+        return;
+    }
+}
+
+void MessageStore::saveToFlash()
+{
+#ifdef FSCom
+    uint32_t unsaved = 0;
+    for (const auto &m : liveMessages) {
+        if (m.id > lastPersistedId)
+            unsaved++;
+    }
+
+    bool persisted = false;
+    if (needsCompaction || logRecordCount + unsaved > MESSAGE_LOG_COMPACT_RECORDS) {
+        compactLog();
+        persisted = !needsCompaction;
+    } else if (unsaved || !pendingTombstones.empty()) {
+        // Tombstones first, then the new messages, all in a single append
+        std::vector<uint8_t> batch;
+        batch.reserve(pendingTombstones.size() * MESSAGE_LOG_DELETE_RECORD + unsaved * MESSAGE_LOG_MAX_RECORD);
+        for (uint32_t id : pendingTombstones)
+            encodeDeleteRecord(batch, id);
+
+        uint8_t buf[MESSAGE_LOG_MAX_RECORD];
+        for (const auto &m : liveMessages) {
+            if (m.id <= lastPersistedId)
+                continue;
+            size_t len = encodeAddRecord(buf, m);
+            batch.insert(batch.end(), buf, buf + len);
+        }
+
+        persisted = appendToLog(batch.data(), batch.size(), pendingTombstones.size() + unsaved);
+        if (!persisted) {
+            compactLog(); // Log missing or damaged, start over from RAM
+            persisted = !needsCompaction;
+        }
+    } else {
+        persisted = true;
+    }
+
+    if (persisted) {
+        lastPersistedId = nextId - 1;
+        pendingTombstones.clear();
+    }
 #endif
 
     // Reset autosave state after any save
@@ -313,18 +573,24 @@ void MessageStore::saveToFlash()
     g_lastAutoSaveMs = millis();
 }
 
-void MessageStore::loadFromFlash()
+// Deserialize one message from the snapshot format used by older firmware
+void MessageStore::loadLegacyFile()
 {
-    std::deque<StoredMessage>().swap(liveMessages);
-    resetMessagePool(); // reset pool when loading
-
 #ifdef FSCom
-    concurrency::LockGuard guard(spiLock);
-
-    if (!FSCom.exists(filename.c_str()))
-        return;
+    // Compact, fixed-size representation (old format): uint8_t count, then count of these
+    struct __attribute__((packed)) LegacyMessageRecord {
+        uint32_t timestamp;
+        uint32_t sender;
+        uint8_t channelIndex;
+        uint32_t dest;
+        uint8_t isBootRelative;
+        uint8_t ackStatus;
+        uint8_t type;
+        uint16_t textLength;
+        char text[MAX_MESSAGE_SIZE];
+    };
 
-    auto f = FSCom.open(filename.c_str(), FILE_O_READ);
+    auto f = FSCom.open(legacyFilename.c_str(), FILE_O_READ);
     if (!f)
         return;
 
@@ -334,13 +600,84 @@ void MessageStore::loadFromFlash()
         count = MAX_MESSAGES_SAVED;
 
     for (uint8_t i = 0; i < count; ++i) {
-        StoredMessage m;
-        if (!readMessageRecord(f, m))
+        LegacyMessageRecord rec = {};
+        if (f.readBytes(reinterpret_cast<char *>(&rec), sizeof(rec)) != sizeof(rec))
             break;
+
+        StoredMessage m;
+        m.id = nextId++;
+        m.timestamp = rec.timestamp;
+        m.sender = rec.sender;
+        m.channelIndex = rec.channelIndex;
+        m.dest = rec.dest;
+        m.isBootRelative = rec.isBootRelative;
+        m.ackStatus = static_cast<AckStatus>(rec.ackStatus);
+        m.type = static_cast<MessageType>(rec.type);
+        m.textLength = strnlen(rec.text, MAX_MESSAGE_SIZE - 1);
+        m.textOffset = storeTextInPool(rec.text, m.textLength);
         liveMessages.push_back(m);
     }
 
     f.close();
+    LOG_INFO("MessageStore: migrating %u messages from %s", (uint32_t)liveMessages.size(), legacyFilename.c_str());
+#endif
+}
+
+void MessageStore::loadFromFlash()
+{
+    std::deque<StoredMessage>().swap(liveMessages);
+    resetMessagePool(); // reset pool when loading
+    changeCount++;
+    logRecordCount = 0;
+    needsCompaction = false;
+
+#ifdef FSCom
+    spiLock->lock();
+    bool haveLog = FSCom.exists(filename.c_str());
+    bool haveLegacy = !haveLog && FSCom.exists(legacyFilename.c_str());
+
+    if (haveLegacy) {
+        loadLegacyFile();
+        needsCompaction = true; // Write it back out in the log format
+    } else if (haveLog) {
+        auto f = FSCom.open(filename.c_str(), FILE_O_READ);
+        if (f) {
+            uint32_t magic = 0;
+            std::deque<ReplayedMessage> replay;
+            uint32_t maxId = 0;
+
+            if (f.read(reinterpret_cast<uint8_t *>(&magic), sizeof(magic)) == (int)sizeof(magic) &&
+                magic == MESSAGE_LOG_MAGIC) {
+                MessageLogRecordHeader header;
+                uint8_t payload[sizeof(MessageLogAdd) + MAX_MESSAGE_SIZE];
+                while (f.available() > 0) {
+                    if (!readLogRecord(f, header, payload)) {
+                        // Torn or corrupt tail, appending after it would hide later records
+                        needsCompaction = true;
+                        break;
+                    }
+                    applyLogRecord(replay, header, payload, maxId);
+                    logRecordCount++;
+                }
+            } else {
+                LOG_WARN("MessageStore: %s has a bad header, discarding", filename.c_str());
+                needsCompaction = true;
+            }
+            f.close();
+
+            for (auto &r : replay) {
+                r.msg.textLength = r.text.size();
+                r.msg.textOffset = storeTextInPool(r.text.c_str(), r.text.size());
+                liveMessages.push_back(r.msg);
+            }
+            nextId = maxId + 1;
+        }
+    }
+    spiLock->unlock();
+
+    lastPersistedId = nextId - 1;
+    if (needsCompaction)
+        compactLog();
 #endif
     // Loading messages does not trigger an autosave
     g_messageStoreHasUnsavedChanges = false;
@@ -351,34 +688,49 @@ void MessageStore::loadFromFlash()
 // If persistence is disabled, these functions become no-ops
 void MessageStore::saveToFlash() {}
 void MessageStore::loadFromFlash() {}
+void MessageStore::setAckStatus(uint32_t id, AckStatus status)
+{
+    for (auto &m : liveMessages) {
+        if (m.id == id && m.ackStatus != status) {
+            m.ackStatus = status;
+            changeCount++;
+        }
+    }
+}
+void MessageStore::logDeletions(const std::deque<StoredMessage> &erased)
+{
+    if (!erased.empty())
+        changeCount++;
+}
 #endif
 
-// Clear all messages (RAM + persisted queue)
+// Clear all messages (RAM + persisted log)
 void MessageStore::clearAllMessages()
 {
     std::deque<StoredMessage>().swap(liveMessages);
     resetMessagePool();
-
-#ifdef FSCom
-    SafeFile f(filename.c_str(), false);
-    uint8_t count = 0;
-    f.write(&count, 1); // write "0 messages"
-    f.close();
-#endif
+    changeCount++;
 
 #if ENABLE_MESSAGE_PERSISTENCE
+    compactLog(); // An empty log
+    lastPersistedId = nextId - 1;
+    pendingTombstones.clear();
     g_messageStoreHasUnsavedChanges = false;
     g_lastAutoSaveMs = millis();
 #endif
 }
 
 // Internal helper: erase first or last message matching a predicate
-template <typename Predicate> static void eraseIf(std::deque<StoredMessage> &deque, Predicate pred, bool fromBack = false)
+// Returns the erased messages, so they can be tombstoned in the flash log
+template <typename Predicate>
+static std::deque<StoredMessage> eraseIf(std::deque<StoredMessage> &deque, Predicate pred, bool fromBack = false)
 {
+    std::deque<StoredMessage> erased;
     if (fromBack) {
         // Iterate from the back and erase all matches from the end
         for (auto it = deque.rbegin(); it != deque.rend();) {
             if (pred(*it)) {
+                erased.push_front(*it);
                 it = std::deque<StoredMessage>::reverse_iterator(deque.erase(std::next(it).base()));
             } else {
                 ++it;
@@ -388,34 +740,33 @@ template <typename Predicate> static void eraseIf(std::deque<StoredMessage> &deq
         // Manual forward search to erase all matches
         for (auto it = deque.begin(); it != deque.end();) {
             if (pred(*it)) {
+                erased.push_back(*it);
                 it = deque.erase(it);
             } else {
                 ++it;
             }
         }
     }
+    return erased;
 }
 
-// Delete oldest message (RAM + persisted queue)
+// Delete oldest message (RAM + tombstone in the flash log)
 void MessageStore::deleteOldestMessage()
 {
-    eraseIf(liveMessages, [](StoredMessage &) { return true; });
-    saveToFlash();
+    logDeletions(eraseIf(liveMessages, [](StoredMessage &) { return true; }));
 }
 
 // Delete oldest message in a specific channel
 void MessageStore::deleteOldestMessageInChannel(uint8_t channel)
 {
     auto pred = [channel](const StoredMessage &m) { return m.type == MessageType::BROADCAST && m.channelIndex == channel; };
-    eraseIf(liveMessages, pred);
-    saveToFlash();
+    logDeletions(eraseIf(liveMessages, pred));
 }
 
 void MessageStore::deleteAllMessagesInChannel(uint8_t channel)
 {
     auto pred = [channel](const StoredMessage &m) { return m.type == MessageType::BROADCAST && m.channelIndex == channel; };
-    eraseIf(liveMessages, pred, false /* delete ALL, not just first */);
-    saveToFlash();
+    logDeletions(eraseIf(liveMessages, pred, false /* delete ALL, not just first */));
 }
 
 void MessageStore::deleteAllMessagesWithPeer(uint32_t peer)
@@ -427,8 +778,7 @@ void MessageStore::deleteAllMessagesWithPeer(uint32_t peer)
         uint32_t other = (m.sender == local) ? m.dest : m.sender;
         return other == peer;
     };
-    eraseIf(liveMessages, pred, false);
-    saveToFlash();
+    logDeletions(eraseIf(liveMessages, pred, false));
 }
 
 // Delete oldest message in a direct chat with a node
@@ -440,8 +790,7 @@ void MessageStore::deleteOldestMessageWithPeer(uint32_t peer)
         uint32_t other = (m.sender == nodeDB->getNodeNum()) ? m.dest : m.sender;
         return other == peer;
     };
-    eraseIf(liveMessages, pred);
-    saveToFlash();
+    logDeletions(eraseIf(liveMessages, pred));
 }
 
 std::deque<StoredMessage> MessageStore::getChannelMessages(uint8_t channel) const
@@ -483,6 +832,14 @@ void MessageStore::upgradeBootRelativeTimestamps()
                 uint32_t bootOffset = nowSecs - bootNow;
                 m.timestamp += bootOffset;
                 m.isBootRelative = false;
+                changeCount++;
+#if ENABLE_MESSAGE_PERSISTENCE
+                if (m.id <= lastPersistedId) {
+                    // Already logged with the old timestamp, rewrite the log at the next save
+                    needsCompaction = true;
+                    markMessageStoreUnsaved();
+                }
+#endif
             }
         }
     };
@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <deque>
 #include <string>
+#include <vector>
 
 // How many messages are stored (RAM + flash).
 // Define -DMESSAGE_HISTORY_LIMIT=N in build_flags to control memory usage.
@@ -65,10 +66,12 @@ struct StoredMessage {
     uint16_t textOffset; // Offset into global text pool (valid only after loadFromFlash())
     uint16_t textLength; // Length of text in bytes
 
+    uint32_t id; // Assigned by MessageStore, identifies this message in the on-flash log
+
     // Default constructor initializes all fields safely
     StoredMessage()
         : timestamp(0), sender(0), channelIndex(0), dest(0xffffffff), type(MessageType::BROADCAST), isBootRelative(false),
-          ackStatus(AckStatus::NONE), textOffset(0), textLength(0)
+          ackStatus(AckStatus::NONE), textOffset(0), textLength(0), id(0)
     {
     }
 };
@@ -87,10 +90,15 @@ class MessageStore
     const StoredMessage &addFromPacket(const meshtastic_MeshPacket &mp);                // Incoming/outgoing → RAM only
     void addFromString(uint32_t sender, uint8_t channelIndex, const std::string &text); // Manual add
 
-    // Persistence methods (used only on boot/shutdown)
-    void saveToFlash();   // Save messages to flash
+    // Persistence methods
+    // Flash holds an append-only log: saving appends only messages added since the last save, deletions append
+    // tombstones.  The log is rewritten (compacted) once it has grown well past the live message count.
+    void saveToFlash();   // Append unsaved messages to flash (compacting if needed)
     void loadFromFlash(); // Load messages from flash
 
+    // Update delivery status of one of our messages, persisting just the change
+    void setAckStatus(uint32_t id, AckStatus status);
+
     // Clear all messages (RAM + persisted queue + text pool)
     void clearAllMessages();
 
@@ -111,6 +119,9 @@ class MessageStore
     // Upgrade boot-relative timestamps once RTC is valid
     void upgradeBootRelativeTimestamps();
 
+    // Changes whenever live messages are added, removed or updated, so the UI knows to redraw
+    uint32_t getChangeCount() const { return changeCount; }
+
     // Retrieve the C-string text for a stored message
     static const char *getText(const StoredMessage &msg);
 
@@ -122,7 +133,20 @@ class MessageStore
 
   private:
     std::deque<StoredMessage> liveMessages; // Single in-RAM message buffer (also used for persistence)
-    std::string filename;                   // Flash filename for persistence
+    std::string filename;                   // Flash filename for the message log
+    std::string legacyFilename;             // Full-snapshot file written by older firmware, migrated on load
+
+    uint32_t nextId = 1;          // Id handed to the next message added
+    uint32_t lastPersistedId = 0; // Every message with an id up to this one is already in the log
+    uint32_t logRecordCount = 0;  // Records currently in the log, used to decide when to compact
+    bool needsCompaction = false; // Log has a torn tail or holds stale data (e.g. healed timestamps)
+    std::vector<uint32_t> pendingTombstones; // Persisted messages pushed out by the history limit, not yet logged
+    uint32_t changeCount = 0;
+
+    void compactLog();                                                // Rewrite the log from liveMessages
+    bool appendToLog(const uint8_t *records, size_t len, uint32_t n); // Append n already-encoded records
+    void logDeletions(const std::deque<StoredMessage> &erased);       // Append tombstones for persisted messages
+    void loadLegacyFile();                                            // Read the old snapshot format
 };
 
 #if ENABLE_MESSAGE_PERSISTENCE
@@ -48,6 +48,25 @@ size_t RedirectablePrint::write(uint8_t c)
               // serial port said (which could be zero)
 }
 
+/// ANSI colour for a log level, compared by first letter since these are called for every line
+static const char *levelColor(const char *logLevel, bool includeTrace)
+{
+    switch (logLevel[0]) {
+    case 'D':
+        return "\u001b[34m";
+    case 'I':
+        return "\u001b[32m";
+    case 'W':
+        return "\u001b[33m";
+    case 'E':
+        return "\u001b[31m";
+    case 'T':
+        return includeTrace ? "\u001b[35m" : nullptr;
+    default:
+        return nullptr;
+    }
+}
+
 size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_list arg)
 {
     va_list copy;
@@ -79,14 +98,9 @@ size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_l
             printBuf[f] = '#';
     }
     if (color && logLevel != nullptr) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
-            Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
-            Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
-            Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
-            Print::write("\u001b[31m", 5);
+        const char *levelCode = levelColor(logLevel, false);
+        if (levelCode)
+            Print::write(levelCode, 5);
     }
     len = Print::write(printBuf, len);
     if (color && logLevel != nullptr) {
@@ -107,20 +121,15 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
 
     // include the header
     if (color) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
-            Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
-            Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
-            Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
-            Print::write("\u001b[31m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0)
-            Print::write("\u001b[35m", 5);
+        const char *levelCode = levelColor(logLevel, true);
+        if (levelCode)
+            Print::write(levelCode, 5);
     }
 
+    uint32_t logMillis = getLogMillis();
     uint32_t rtc_sec = getValidTime(RTCQuality::RTCQualityDevice, true); // display local time on logfile
     if (rtc_sec > 0) {
+        rtc_sec -= (millis() - logMillis) / 1000; // deferred messages show when they were logged, not written
         long hms = rtc_sec % SEC_PER_DAY;
         // hms += tz.tz_dsttime * SEC_PER_HOUR;
         // hms -= tz.tz_minuteswest * SEC_PER_MIN;
@@ -137,13 +146,13 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
         if (color) {
             ::printf("\u001b[0m");
         }
-        ::printf("| %02d:%02d:%02d %u ", hour, min, sec, millis() / 1000);
+        ::printf("| %02d:%02d:%02d %u ", hour, min, sec, logMillis / 1000);
 #else
         printf("%s ", logLevel);
         if (color) {
             printf("\u001b[0m");
         }
-        printf("| %02d:%02d:%02d %u ", hour, min, sec, millis() / 1000);
+        printf("| %02d:%02d:%02d %u ", hour, min, sec, logMillis / 1000);
 #endif
     } else {
 #ifdef ARCH_PORTDUINO
@@ -151,21 +160,19 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
         if (color) {
             ::printf("\u001b[0m");
         }
-        ::printf("| ??:??:?? %u ", millis() / 1000);
+        ::printf("| ??:??:?? %u ", logMillis / 1000);
 #else
         printf("%s ", logLevel);
         if (color) {
             printf("\u001b[0m");
         }
-        printf("| ??:??:?? %u ", millis() / 1000);
+        printf("| ??:??:?? %u ", logMillis / 1000);
 #endif
     }
-    auto thread = concurrency::OSThread::currentThread;
-    if (thread) {
+    const char *source = getLogSource();
+    if (source) {
         print("[");
-        // printf("%p ", thread);
-        // assert(thread->ThreadName.length());
-        print(thread->ThreadName);
+        print(source);
         print("] ");
     }
 
@@ -206,9 +213,9 @@ void RedirectablePrint::log_to_syslog(const char *logLevel, const char *format,
         default:
             ll = 0;
         }
-        auto thread = concurrency::OSThread::currentThread;
-        if (thread) {
-            syslog.vlogf(ll, thread->ThreadName.c_str(), format, arg);
+        const char *source = getLogSource();
+        if (source) {
+            syslog.vlogf(ll, source, format, arg);
         } else {
             syslog.vlogf(ll, format, arg);
         }
@@ -238,12 +245,12 @@ void RedirectablePrint::log_to_ble(const char *logLevel, const char *format, va_
                 message = new char[len + 1];
                 vsnprintf(message, len + 1, format, arg);
             }
-            auto thread = concurrency::OSThread::currentThread;
+            const char *source = getLogSource();
             meshtastic_LogRecord logRecord = meshtastic_LogRecord_init_zero;
             logRecord.level = getLogLevel(logLevel);
             strcpy(logRecord.message, message);
-            if (thread)
-                strcpy(logRecord.source, thread->ThreadName.c_str());
+            if (source)
+                strncpy(logRecord.source, source, sizeof(logRecord.source) - 1);
             logRecord.time = getValidTime(RTCQuality::RTCQualityDevice, true);
 
             uint8_t *buffer = new uint8_t[meshtastic_LogRecord_size];
@@ -264,6 +271,50 @@ void RedirectablePrint::log_to_ble(const char *logLevel, const char *format, va_
 #endif
 }
 
+const char *RedirectablePrint::getLogSource() const
+{
+#if ENABLE_ASYNC_LOGGING
+    if (deferredSource)
+        return *deferredSource ? deferredSource : nullptr;
+#endif
+    auto thread = concurrency::OSThread::currentThread;
+    return thread ? thread->ThreadName.c_str() : nullptr;
+}
+
+uint32_t RedirectablePrint::getLogMillis() const
+{
+#if ENABLE_ASYNC_LOGGING
+    if (deferredSource)
+        return deferredMillis;
+#endif
+    return millis();
+}
+
+bool RedirectablePrint::lockPrint()
+{
+#ifdef HAS_FREE_RTOS
+    return inDebugPrint != nullptr && xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE;
+#elif defined(ARCH_PORTDUINO)
+    return !inDebugPrint.exchange(true, std::memory_order_acquire);
+#else
+    if (inDebugPrint)
+        return false;
+    inDebugPrint = true;
+    return true;
+#endif
+}
+
+void RedirectablePrint::unlockPrint()
+{
+#ifdef HAS_FREE_RTOS
+    xSemaphoreGive(inDebugPrint);
+#elif defined(ARCH_PORTDUINO)
+    inDebugPrint.store(false, std::memory_order_release);
+#else
+    inDebugPrint = false;
+#endif
+}
+
 meshtastic_LogRecord_Level RedirectablePrint::getLogLevel(const char *logLevel)
 {
     meshtastic_LogRecord_Level ll = meshtastic_LogRecord_Level_UNSET; // default to unset
@@ -289,14 +340,6 @@ meshtastic_LogRecord_Level RedirectablePrint::getLogLevel(const char *logLevel)
 
 void RedirectablePrint::log(const char *logLevel, const char *format, ...)
 {
-
-    // append \n to format
-    size_t len = strlen(format);
-    char *newFormat = new char[len + 2];
-    strcpy(newFormat, format);
-    newFormat[len] = '\n';
-    newFormat[len + 1] = '\0';
-
 #if ARCH_PORTDUINO
     // level trace is special, two possible ways to handle it.
     if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
@@ -310,33 +353,45 @@ void RedirectablePrint::log(const char *logLevel, const char *format, ...)
             va_end(arg);
         }
         if (portduino_config.logoutputlevel < level_trace && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
-            delete[] newFormat;
             return;
         }
     }
     if (portduino_config.logoutputlevel < level_debug && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
         return;
     } else if (portduino_config.logoutputlevel < level_info && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0) {
-        delete[] newFormat;
         return;
     } else if (portduino_config.logoutputlevel < level_warn && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0) {
-        delete[] newFormat;
         return;
     }
 #endif
     if (moduleConfig.serial.override_console_serial_port && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
         return;
     }
 
-#ifdef HAS_FREE_RTOS
-    if (inDebugPrint != nullptr && xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE) {
-#else
-    if (!inDebugPrint) {
-        inDebugPrint = true;
+#if ENABLE_ASYNC_LOGGING
+    if (deferLogs) {
+        va_list arg;
+        va_start(arg, format);
+        bool handled = logDeferred(logLevel, format, arg);
+        va_end(arg);
+        if (handled)
+            return;
+    }
 #endif
 
+    // append \n to format
+    size_t len = strlen(format);
+    char *newFormat = new char[len + 2];
+    strcpy(newFormat, format);
+    newFormat[len] = '\n';
+    newFormat[len + 1] = '\0';
+
+    if (lockPrint()) {
+#if ENABLE_ASYNC_LOGGING
+        // Anything still queued was logged before this, so it goes out first
+        while (drainOne())
+            ;
+#endif
         va_list arg;
         va_start(arg, format);
 
@@ -345,17 +400,101 @@ void RedirectablePrint::log(const char *logLevel, const char *format, ...)
         log_to_ble(logLevel, newFormat, arg);
 
         va_end(arg);
-#ifdef HAS_FREE_RTOS
-        xSemaphoreGive(inDebugPrint);
-#else
-        inDebugPrint = false;
-#endif
+        unlockPrint();
     }
 
     delete[] newFormat;
     return;
 }
 
+#if ENABLE_ASYNC_LOGGING
+bool RedirectablePrint::logDeferred(const char *logLevel, const char *format, va_list arg)
+{
+    // Errors are rare and are what we most need to see if we are about to crash, so don't hold them back
+    if (logLevel[0] == 'E' || logLevel[0] == 'C' || !LogRing::canDefer(format))
+        return false;
+
+    if (!lockPrint())
+        return true; // same as the synchronous path, a message logged while printing is lost
+
+    bool limited = logLevel[0] == 'D' || logLevel[0] == 'T';
+    if (limited) {
+        uint32_t now = millis();
+        uint32_t elapsed = now - rateRefillMs;
+        uint32_t earned = (elapsed >= ASYNC_LOG_RATE_BURST * 1000 / ASYNC_LOG_RATE_LIMIT) ? ASYNC_LOG_RATE_BURST
+                                                                                           : elapsed * ASYNC_LOG_RATE_LIMIT / 1000;
+        if (earned > 0) {
+            rateTokens = (rateTokens + earned > ASYNC_LOG_RATE_BURST) ? ASYNC_LOG_RATE_BURST : rateTokens + earned;
+            // Keep the fraction of a token we haven't earned yet, unless the bucket is full anyway
+            rateRefillMs = (rateTokens == ASYNC_LOG_RATE_BURST) ? now : rateRefillMs + earned * 1000 / ASYNC_LOG_RATE_LIMIT;
+        }
+    }
+
+    bool wake = false;
+    if (limited && rateTokens == 0) {
+        droppedRateLimited++;
+    } else {
+        auto thread = concurrency::OSThread::currentThread;
+        wake = deferred.isEmpty();
+        if (deferred.push(logLevel, thread ? thread->ThreadName.c_str() : nullptr, millis(), format, arg)) {
+            if (limited)
+                rateTokens--;
+        } else {
+            droppedFull++;
+        }
+    }
+
+    unlockPrint();
+    if (wake && onDeferred)
+        onDeferred();
+    return true;
+}
+
+void RedirectablePrint::writeFormatted(const char *logLevel, const char *format, ...)
+{
+    va_list arg;
+    va_start(arg, format);
+    log_to_serial(logLevel, format, arg);
+    log_to_syslog(logLevel, format, arg);
+    log_to_ble(logLevel, format, arg);
+    va_end(arg);
+}
+
+bool RedirectablePrint::drainOne()
+{
+    static char message[ASYNC_LOG_LINE_LEN]; // only used with inDebugPrint held
+    LogRing::Entry entry;
+
+    if (!deferred.pop(entry, message, sizeof(message))) {
+        if (droppedFull || droppedRateLimited) {
+            writeFormatted(MESHTASTIC_LOG_LEVEL_WARN, "Dropped %u log messages (%u ring full, %u rate limited)\n",
+                           (unsigned)(droppedFull + droppedRateLimited), (unsigned)droppedFull, (unsigned)droppedRateLimited);
+            droppedFull = droppedRateLimited = 0;
+        }
+        return false;
+    }
+
+    deferredSource = entry.source;
+    deferredMillis = entry.millis;
+    writeFormatted(entry.logLevel, "%s\n", message);
+    deferredSource = nullptr;
+    return true;
+}
+
+bool RedirectablePrint::drainDeferredLogs(size_t maxMessages)
+{
+    for (size_t i = 0; i < maxMessages; i++) {
+        if (!lockPrint())
+            return true; // someone else is printing, try again later
+        bool wrote = drainOne();
+        unlockPrint();
+        if (!wrote)
+            return false;
+    }
+    return hasDeferredLogs();
+}
+#endif
+
 void RedirectablePrint::hexDump(const char *logLevel, unsigned char *buf, uint16_t len)
 {
     const char alphabet[17] = "0123456789abcdef";
@@ -381,7 +520,7 @@ void RedirectablePrint::hexDump(const char *logLevel, unsigned char *buf, uint16
         uint8_t index = i / 16;
         sprintf(s, "%03x", index);
         s[3] = '.';
-        log(logLevel, s);
+        log(logLevel, "%s", s);
     }
     log(logLevel, "    +------------------------------------------------+ +----------------+");
 }
@@ -2,8 +2,28 @@
 
 #include "../freertosinc.h"
 #include "mesh/generated/meshtastic/mesh.pb.h"
+#if ENABLE_ASYNC_LOGGING
+#include "LogRing.h"
+
+// DEBUG and TRACE messages allowed into the ring per second, and how many can burst past that
+#ifndef ASYNC_LOG_RATE_LIMIT
+#define ASYNC_LOG_RATE_LIMIT 50
+#endif
+#ifndef ASYNC_LOG_RATE_BURST
+#define ASYNC_LOG_RATE_BURST 200
+#endif
+
+// Longest line a deferred message is formatted to
+#ifndef ASYNC_LOG_LINE_LEN
+#define ASYNC_LOG_LINE_LEN 256
+#endif
+#endif
 #include <Print.h>
+#ifdef ARCH_PORTDUINO
+#include <atomic>
+#endif
 #include <stdarg.h>
+#include <stdint.h>
 #include <string>
 
 /**
@@ -18,9 +38,29 @@ class RedirectablePrint : public Print
 #ifdef HAS_FREE_RTOS
     SemaphoreHandle_t inDebugPrint = nullptr;
     StaticSemaphore_t _MutexStorageSpace;
+#elif defined(ARCH_PORTDUINO)
+    std::atomic<bool> inDebugPrint{false}; // Logged from other threads too (web server, packet capture), so set atomically
 #else
     volatile bool inDebugPrint = false;
 #endif
+
+#if ENABLE_ASYNC_LOGGING
+    LogRing deferred;
+    bool deferLogs = false;
+    void (*onDeferred)() = nullptr; // called when a message lands in an empty ring
+
+    // Token bucket limiting how many DEBUG/TRACE messages per second make it into the ring
+    uint32_t rateTokens = ASYNC_LOG_RATE_BURST;
+    uint32_t rateRefillMs = 0;
+
+    // Messages lost since the last report, only touched with inDebugPrint held
+    uint32_t droppedFull = 0;
+    uint32_t droppedRateLimited = 0;
+
+    // Set while a deferred message is being written, so the sinks report when it was logged and by whom
+    const char *deferredSource = nullptr;
+    uint32_t deferredMillis = 0;
+#endif
   public:
     explicit RedirectablePrint(Print *_dest) : dest(_dest) {}
 
@@ -48,12 +88,51 @@ class RedirectablePrint : public Print
 
     std::string mt_sprintf(const std::string fmt_str, ...);
 
+#if ENABLE_ASYNC_LOGGING
+    /**
+     * Start capturing log messages into a ring instead of formatting them on the spot.  Someone (AsyncLogWriter)
+     * must then call drainDeferredLogs() regularly.  ERROR and CRIT messages are still written synchronously (after
+     * everything queued ahead of them) so they survive a crash.
+     */
+    void setDeferLogs(bool defer, void (*onFirstDeferred)() = nullptr)
+    {
+        onDeferred = onFirstDeferred;
+        deferLogs = defer;
+    }
+
+    /// Format and write up to maxMessages captured messages
+    /// @return true if there are still messages waiting
+    bool drainDeferredLogs(size_t maxMessages = SIZE_MAX);
+
+    bool hasDeferredLogs() const { return !deferred.isEmpty(); }
+#endif
+
   protected:
     /// Subclasses can override if they need to change how we format over the serial port
     virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
     meshtastic_LogRecord_Level getLogLevel(const char *logLevel);
 
+    /// Name of the thread the message being written was logged from, or nullptr
+    const char *getLogSource() const;
+
+    /// millis() of when the message being written was logged
+    uint32_t getLogMillis() const;
+
   private:
+    bool lockPrint();
+    void unlockPrint();
+
+#if ENABLE_ASYNC_LOGGING
+    /// @return false if the message could not be deferred and should be written the normal way
+    bool logDeferred(const char *logLevel, const char *format, va_list arg);
+
+    /// Write a message to all sinks, call with inDebugPrint held
+    void writeFormatted(const char *logLevel, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+    /// Pop and write one message, call with inDebugPrint held
+    bool drainOne();
+#endif
+
     void log_to_syslog(const char *logLevel, const char *format, va_list arg);
     void log_to_ble(const char *logLevel, const char *format, va_list arg);
 };
\ No newline at end of file
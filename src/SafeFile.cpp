@@ -1,4 +1,6 @@
 #include "SafeFile.h"
+#include <ErriezCRC32.h>
+#include <string.h>
 
 #ifdef FSCom
 
@@ -32,12 +34,19 @@ SafeFile::SafeFile(const char *_filename, bool fullAtomic)
 {
 }
 
+uint32_t SafeFile::updateCRC(uint32_t crc, const uint8_t *buffer, size_t size)
+{
+    // crc32Update() works on the un-finalized (inverted) value, so undo/redo the final xor to allow chaining
+    return crc32Final(crc32Update(buffer, size, ~crc));
+}
+
 size_t SafeFile::write(uint8_t ch)
 {
     if (!f)
         return 0;
 
-    hash ^= ch;
+    crc = updateCRC(crc, &ch, 1);
+    length++;
     return f.write(ch);
 }
 
@@ -46,15 +55,15 @@ size_t SafeFile::write(const uint8_t *buffer, size_t size)
     if (!f)
         return 0;
 
-    for (size_t i = 0; i < size; i++) {
-        hash ^= buffer[i];
-    }
+    crc = updateCRC(crc, buffer, size);
+    length += size;
     return f.write((uint8_t const *)buffer, size); // This nasty cast is _IMPORTANT_ otherwise the correct adafruit method does
                                                    // not get used (they made a mistake in their typing)
 }
 
 /**
- * Atomically close the file (overwriting any old version) and readback the contents to confirm the hash matches
+ * Append our footer and atomically close the file (overwriting any old version), sometimes reading back the contents to
+ * confirm the CRC matches
  *
  * @return false for failure
  */
@@ -63,15 +72,27 @@ bool SafeFile::close()
     if (!f)
         return false;
 
+    SafeFileFooter footer = {SAFEFILE_FOOTER_KEY, 3 * sizeof(uint32_t), SAFEFILE_FOOTER_MAGIC, length, crc};
+    bool withFooter = maxSize == 0 || length + sizeof(footer) <= maxSize;
+
     spiLock->lock();
+    bool footerOkay = !withFooter || f.write((uint8_t const *)&footer, sizeof(footer)) == sizeof(footer);
     f.close();
     spiLock->unlock();
 
+    if (!footerOkay) {
+        LOG_ERROR("Can't write footer to %s", filename.c_str());
+        return false;
+    }
+
 #ifdef ARCH_NRF52
     return true;
 #endif
-    if (!testReadback())
+#if SAFEFILE_READBACK_INTERVAL > 0
+    static uint32_t closeCount;
+    if (closeCount++ % SAFEFILE_READBACK_INTERVAL == 0 && !testReadback())
         return false;
+#endif
 
     // Rename or overwrite (atomic operation)
     String filenameTmp = filename;
@@ -84,7 +105,7 @@ bool SafeFile::close()
     return true;
 }
 
-/// Read our (closed) tempfile back in and compare the hash
+/// Read our (closed) tempfile back in and compare the CRC
 bool SafeFile::testReadback()
 {
     concurrency::LockGuard g(spiLock);
@@ -97,19 +118,51 @@ bool SafeFile::testReadback()
         return false;
     }
 
-    int c = 0;
-    uint8_t test_hash = 0;
-    while ((c = f2.read()) >= 0) {
-        test_hash ^= (uint8_t)c;
+    size_t payloadLength;
+    uint32_t footerCrc = 0;
+    bool hasFooter = readFooter(f2, payloadLength, footerCrc);
+
+    uint8_t buf[64];
+    uint32_t test_crc = 0;
+    size_t remaining = payloadLength;
+    while (remaining > 0) {
+        int n = f2.read(buf, remaining < sizeof(buf) ? remaining : sizeof(buf));
+        if (n <= 0)
+            break;
+        test_crc = updateCRC(test_crc, buf, n);
+        remaining -= n;
     }
     f2.close();
 
-    if (test_hash != hash) {
-        LOG_ERROR("Readback failed hash mismatch");
+    bool footerOkay = hasFooter ? footerCrc == crc : (maxSize != 0 && length + sizeof(SafeFileFooter) > maxSize);
+    if (!footerOkay || remaining != 0 || payloadLength != length || test_crc != crc) {
+        LOG_ERROR("Readback failed CRC mismatch");
         return false;
     }
 
     return true;
 }
 
-#endif
\ No newline at end of file
+bool SafeFile::readFooter(File &file, size_t &payloadLength, uint32_t &crc)
+{
+    size_t size = file.size();
+    payloadLength = size;
+    if (size < sizeof(SafeFileFooter))
+        return false;
+
+    static const uint8_t key[] = SAFEFILE_FOOTER_KEY;
+    SafeFileFooter footer = {};
+    bool found = file.seek(size - sizeof(footer)) &&
+                 file.read((uint8_t *)&footer, sizeof(footer)) == (int)sizeof(footer) &&
+                 memcmp(footer.key, key, sizeof(key)) == 0 && footer.size == 3 * sizeof(uint32_t) &&
+                 footer.magic == SAFEFILE_FOOTER_MAGIC && footer.length == size - sizeof(footer);
+    file.seek(0);
+
+    if (found) {
+        payloadLength = footer.length;
+        crc = footer.crc;
+    }
+    return found;
+}
+
+#endif
@@ -6,6 +6,27 @@
 
 #ifdef FSCom
 
+// How often close() rereads a freshly written file to double check it.  1 means every file (the old behaviour), N means
+// one in every N saves, 0 never.  The CRC footer still lets loaders detect corruption when the readback is skipped.
+#ifndef SAFEFILE_READBACK_INTERVAL
+#define SAFEFILE_READBACK_INTERVAL 16
+#endif
+
+#define SAFEFILE_FOOTER_MAGIC 0x31434653 // "SFC1"
+
+// The footer is framed as a length delimited protobuf field, numbered as high as protobuf allows so it won't ever collide
+// with a real one.  Firmware from before the footer skips it as an unknown field, so a downgrade still loads our files.
+#define SAFEFILE_FOOTER_KEY {0xFA, 0xFF, 0xFF, 0xFF, 0x0F} // varint of (536870911 << 3) | PB_WT_STRING
+
+/// Trailer appended by SafeFile::close(), so readers can find where the payload ends and validate it
+struct __attribute__((packed)) SafeFileFooter {
+    uint8_t key[5];  // SAFEFILE_FOOTER_KEY
+    uint8_t size;    // Length of the field: the 12 bytes below
+    uint32_t magic;  // SAFEFILE_FOOTER_MAGIC
+    uint32_t length; // Number of payload bytes preceding this footer
+    uint32_t crc;    // CRC32 of those payload bytes
+};
+
 /**
  * This class provides 'safe'/paranoid file writing.
  *
@@ -13,14 +34,16 @@
  * be very careful about how we write files.  This class provides a restricted (Stream only) writing API for writing to files.
  *
  * Notably:
- * - we keep a simple xor hash of all characters that were written.
- * - We do not allow seeking (because we want to maintain our hash)
+ * - we keep a CRC32 of all bytes as they are written, and store it in a small SafeFileFooter after the payload.  The footer
+ * reads as an unknown field to protobuf decoders, so files stay loadable by firmware which doesn't know about it.
+ * - We do not allow seeking (because we want to maintain our CRC)
  * - we provide an close() method which is similar to close but returns false if we were unable to successfully write the
  * file.  Also this method
- * - atomically replaces any old version of the file on the disk with our new file (after first rereading the file from the disk
- * to confirm the hash matches)
+ * - atomically replaces any old version of the file on the disk with our new file.  Every SAFEFILE_READBACK_INTERVAL
+ * saves we first reread the file from the disk to confirm the CRC matches, otherwise validation is left to the loader
+ * (see readFooter()).
  * - Some files are super huge so we can't do the full atomic rename/copy (because of filesystem size limits).  If !fullAtomic
- * then we still do the readback to verify file is valid so higher level code can handle failures.
+ * then the footer still lets higher level code detect a bad file when it is loaded.
  */
 class SafeFile : public Print
 {
@@ -31,20 +54,42 @@ class SafeFile : public Print
     virtual size_t write(const uint8_t *buffer, size_t size);
 
     /**
-     * Atomically close the file (deleting any old versions) and readback the contents to confirm the hash matches
+     * Leave the footer off if it would make the file longer than maxSize.  Older firmware decodes protobuf files only up to
+     * the message's maximum encoded size, and would fail on a footer cut short there.
+     */
+    void setMaxSize(size_t maxSize) { this->maxSize = maxSize; }
+
+    /**
+     * Append our footer and atomically close the file (deleting any old versions), sometimes reading back the contents
+     * to confirm the CRC matches
      *
      * @return false for failure
      */
     bool close();
 
+    /**
+     * Look for a SafeFileFooter at the end of an already open file, leaving the read position at the start of the file.
+     * Caller must hold spiLock.
+     *
+     * @param payloadLength set to the number of bytes preceding the footer, or the whole file size if there is no footer
+     * @param crc set to the CRC32 stored in the footer
+     * @return false if the file has no (valid) footer, e.g. because it was written by an older firmware
+     */
+    static bool readFooter(File &file, size_t &payloadLength, uint32_t &crc);
+
+    /// Feed more bytes into a running CRC32, start with crc = 0
+    static uint32_t updateCRC(uint32_t crc, const uint8_t *buffer, size_t size);
+
   private:
-    /// Read our (closed) tempfile back in and compare the hash
+    /// Read our (closed) tempfile back in and compare the CRC
     bool testReadback();
 
     String filename;
     File f;
     bool fullAtomic;
-    uint8_t hash = 0;
+    uint32_t crc = 0;
+    uint32_t length = 0;
+    size_t maxSize = 0; // 0 for no limit
 };
 
-#endif
\ No newline at end of file
+#endif
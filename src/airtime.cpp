@@ -1,9 +1,98 @@
 #include "airtime.h"
+#include "CongestionControl.h"
 #include "NodeDB.h"
 #include "configuration.h"
+#include <algorithm>
+#ifdef ARCH_PORTDUINO
+#include "mesh/PacketLatency.h"
+#endif
 
 AirTime *airTime = NULL;
 
+void AirtimeWindow::add(uint32_t ms)
+{
+    uint32_t total = ms + remainder;
+    uint32_t toAdd = total / MS_PER_UNIT;
+    remainder = total % MS_PER_UNIT;
+
+    // Fill up the current second, then the ones before it.  A second can't be busier than 100%, anything beyond a
+    // whole window of that is dropped.
+    uint16_t i = current;
+    for (uint32_t n = 0; toAdd && n < AIRTIME_WINDOW_SECONDS; n++) {
+        uint32_t add = std::min(toAdd, (uint32_t)(1000 / MS_PER_UNIT - units[i]));
+        units[i] += add;
+        toAdd -= add;
+        i = i ? i - 1 : AIRTIME_WINDOW_SECONDS - 1;
+    }
+}
+
+void AirtimeWindow::tick()
+{
+    current = (current + 1) % AIRTIME_WINDOW_SECONDS;
+    units[current] = 0;
+}
+
+uint32_t AirtimeWindow::sumMs(uint32_t seconds) const
+{
+    seconds = std::min(seconds, (uint32_t)AIRTIME_WINDOW_SECONDS);
+
+    uint32_t sum = 0;
+    uint16_t i = current;
+    for (uint32_t n = 0; n < seconds; n++) {
+        sum += units[i];
+        i = i ? i - 1 : AIRTIME_WINDOW_SECONDS - 1;
+    }
+    return sum * MS_PER_UNIT;
+}
+
+float AirtimeWindow::percent(uint32_t seconds) const
+{
+    seconds = std::min(seconds, (uint32_t)AIRTIME_WINDOW_SECONDS);
+    return seconds ? (float(sumMs(seconds)) / float(seconds * 1000)) * 100 : 0;
+}
+
+void AirtimeHeavyHitters::add(NodeNum from, uint32_t ms)
+{
+    Entry *smallest = nullptr;
+    for (uint8_t i = 0; i < used; i++) {
+        Entry &e = entries[i];
+        if (e.from == from) {
+            e.airtimeMs += ms;
+            if (e.packets < UINT16_MAX)
+                e.packets++;
+            return;
+        }
+        if (!smallest || e.airtimeMs < smallest->airtimeMs)
+            smallest = &e;
+    }
+
+    if (used < AIRTIME_TOP_NODES) {
+        entries[used++] = {from, ms, 0, 1};
+    } else {
+        // Take over the smallest counter, its count is now an upper bound of the error
+        *smallest = {from, smallest->airtimeMs + ms, smallest->airtimeMs, 1};
+    }
+}
+
+void AirtimeHeavyHitters::decay()
+{
+    for (uint8_t i = 0; i < used; i++) {
+        entries[i].airtimeMs /= 2;
+        entries[i].errorMs /= 2;
+        entries[i].packets /= 2;
+    }
+}
+
+size_t AirtimeHeavyHitters::getTop(Entry *out, size_t max) const
+{
+    size_t n = std::min(max, (size_t)used);
+    Entry sorted[AIRTIME_TOP_NODES];
+    std::copy(entries, entries + used, sorted);
+    std::sort(sorted, sorted + used, [](const Entry &a, const Entry &b) { return a.airtimeMs > b.airtimeMs; });
+    std::copy(sorted, sorted + n, out);
+    return n;
+}
+
 // Don't read out of this directly. Use the helper functions.
 
 uint32_t air_period_tx[PERIODS_TO_LOG];
@@ -29,6 +118,16 @@ void AirTime::logAirtime(reportTypes reportType, uint32_t airtime_ms)
 
     // Log all airtime type for channel utilization
     this->channelUtilization[this->getPeriodUtilMinute()] = channelUtilization[this->getPeriodUtilMinute()] + airtime_ms;
+
+    channelWindow.add(airtime_ms);
+    if (reportType == TX_LOG)
+        txWindow.add(airtime_ms);
+}
+
+void AirTime::logAirtime(reportTypes reportType, uint32_t airtime_ms, NodeNum from)
+{
+    logAirtime(reportType, airtime_ms);
+    topSenders.add(from, airtime_ms);
 }
 
 uint8_t AirTime::currentPeriodIndex()
@@ -102,16 +201,15 @@ uint32_t AirTime::getSecondsSinceBoot()
 
 float AirTime::channelUtilizationPercent()
 {
-    uint32_t sum = 0;
-    for (uint32_t i = 0; i < CHANNEL_UTILIZATION_PERIODS; i++) {
-        sum += this->channelUtilization[i];
-    }
-
-    return (float(sum) / float(CHANNEL_UTILIZATION_PERIODS * 10 * 1000)) * 100;
+    // The same minute as channelUtilization covers, but sliding by the second rather than by 10 seconds
+    return channelWindow.percent(CHANNEL_UTILIZATION_PERIODS * 10);
 }
 
 float AirTime::utilizationTXPercent()
 {
+    if (AIRTIME_WINDOW_SECONDS >= SECONDS_IN_MINUTE * MINUTES_IN_HOUR)
+        return txWindow.percent(SECONDS_IN_MINUTE * MINUTES_IN_HOUR);
+
     uint32_t sum = 0;
     for (uint32_t i = 0; i < MINUTES_IN_HOUR; i++) {
         sum += this->utilizationTX[i];
@@ -123,7 +221,11 @@ float AirTime::utilizationTXPercent()
 bool AirTime::isTxAllowedChannelUtil(bool polite)
 {
     uint8_t percentage = (polite ? polite_channel_util_percent : max_channel_util_percent);
-    if (channelUtilizationPercent() < percentage) {
+    float utilization = channelUtilizationPercent();
+    // Polite traffic also backs off during a burst, not just once it has pushed up the average of the whole minute
+    if (polite)
+        utilization = std::max(utilization, channelUtilizationPercent(AIRTIME_BURST_SECONDS));
+    if (utilization < percentage) {
         return true;
     } else {
         LOG_WARN("Ch. util >%d%%. Skip send", percentage);
@@ -159,10 +261,45 @@ uint8_t AirTime::getSilentMinutes(float txPercent, float dutyCycle)
 
 AirTime::AirTime() : concurrency::OSThread("AirTime"), airtimes({}) {}
 
+#ifdef ARCH_PORTDUINO
+std::string AirTime::toJson()
+{
+    std::lock_guard<std::mutex> guard(snapshotLock);
+    return snapshot.empty() ? "{}" : snapshot;
+}
+#endif
+
+std::string AirTime::buildJson()
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"window_seconds\":%u,\"channel_utilization_%us\":%.2f,\"channel_utilization_60s\":%.2f,"
+             "\"channel_utilization_window\":%.2f,\"utilization_tx\":%.2f,\"top_senders\":[",
+             (unsigned)AIRTIME_WINDOW_SECONDS, (unsigned)AIRTIME_BURST_SECONDS,
+             channelUtilizationPercent(AIRTIME_BURST_SECONDS), channelUtilizationPercent(60),
+             channelUtilizationPercent(AIRTIME_WINDOW_SECONDS), utilizationTXPercent());
+    std::string json = buf;
+
+    AirtimeHeavyHitters::Entry top[AIRTIME_TOP_NODES];
+    size_t n = getTopSenders(top, AIRTIME_TOP_NODES);
+    for (size_t i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "%s{\"from\":\"!%08x\",\"airtime_ms\":%u,\"error_ms\":%u,\"packets\":%u}", i ? "," : "",
+                 top[i].from, top[i].airtimeMs, top[i].errorMs, top[i].packets);
+        json += buf;
+    }
+    json += "]}";
+    return json;
+}
+
 int32_t AirTime::runOnce()
 {
     secSinceBoot++;
 
+    channelWindow.tick();
+    txWindow.tick();
+    if (secSinceBoot % AIRTIME_TOP_DECAY_SECONDS == 0)
+        topSenders.decay();
+
     uint8_t utilPeriod = this->getPeriodUtilMinute();
     uint8_t utilPeriodTX = this->getPeriodUtilHour();
 
@@ -206,5 +343,17 @@ int32_t AirTime::runOnce()
             this->utilizationTX[utilPeriodTX] = 0;
         }
     }
+
+    congestionControl.maybeUpdate(millis());
+
+#ifdef ARCH_PORTDUINO
+    // The web server runs on its own thread, so it is handed copies made here
+    std::string json = buildJson();
+    {
+        std::lock_guard<std::mutex> guard(snapshotLock);
+        snapshot.swap(json);
+    }
+    packetLatency.takeSnapshot();
+#endif
     return (1000 * 1);
 }
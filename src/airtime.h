@@ -1,10 +1,15 @@
 #pragma once
 
 #include "MeshRadio.h"
+#include "MeshTypes.h"
 #include "concurrency/OSThread.h"
 #include "configuration.h"
 #include <Arduino.h>
 #include <functional>
+#include <string>
+#ifdef ARCH_PORTDUINO
+#include <mutex>
+#endif
 
 /*
   TX_LOG      - Time on air this device has transmitted
@@ -33,8 +38,85 @@
 #define MS_IN_MINUTE (SECONDS_IN_MINUTE * 1000)
 #define MS_IN_HOUR (MINUTES_IN_HOUR * SECONDS_IN_MINUTE * 1000)
 
+// Length of the 1 second resolution airtime history (1 byte per second for TX and 1 for the whole channel)
+#ifndef AIRTIME_WINDOW_SECONDS
+#if defined(ARCH_PORTDUINO) || defined(ARCH_ESP32)
+#define AIRTIME_WINDOW_SECONDS 3600
+#elif defined(ARCH_STM32WL)
+#define AIRTIME_WINDOW_SECONDS 60
+#else
+#define AIRTIME_WINDOW_SECONDS 600
+#endif
+#endif
+
+// Short span used to spot bursts on the channel
+#define AIRTIME_BURST_SECONDS 10
+
+// Senders whose airtime we keep track of, and how often their totals are halved so old traffic fades out
+#define AIRTIME_TOP_NODES 8
+#define AIRTIME_TOP_DECAY_SECONDS (15 * 60)
+
 enum reportTypes { TX_LOG, RX_LOG, RX_ALL_LOG };
 
+/**
+ * Airtime per second over the last AIRTIME_WINDOW_SECONDS, so utilization over any span up to that is exact to the
+ * second instead of depending on where a coarse bucket happens to start.
+ *
+ * A packet is only logged once it is over, so airtime beyond what fits in the current second is put in the seconds
+ * before it, which is when the packet actually was on air.
+ */
+class AirtimeWindow
+{
+  public:
+    /// Add airtime that ended just now
+    void add(uint32_t ms);
+
+    /// Move on to the next second
+    void tick();
+
+    /// @return airtime of the last seconds (the current, partial, second included)
+    uint32_t sumMs(uint32_t seconds) const;
+
+    /// @return percentage of the last seconds that was used
+    float percent(uint32_t seconds) const;
+
+    static constexpr uint32_t MS_PER_UNIT = 4; // so that a full second fits in a byte
+
+  private:
+    uint8_t units[AIRTIME_WINDOW_SECONDS] = {};
+    uint16_t current = 0;  // index of the current second
+    uint8_t remainder = 0; // ms not yet worth a unit
+};
+
+/**
+ * The few senders responsible for the most airtime, with the Space-Saving algorithm: AIRTIME_TOP_NODES counters, and a
+ * new sender takes over the smallest one (inheriting its count as possible overestimate).  Any node using more than
+ * 1/AIRTIME_TOP_NODES of the counted airtime is guaranteed to be in the table.
+ */
+class AirtimeHeavyHitters
+{
+  public:
+    struct Entry {
+        NodeNum from;
+        uint32_t airtimeMs;
+        uint32_t errorMs; // how much of airtimeMs may belong to the senders this entry replaced
+        uint16_t packets;
+    };
+
+    void add(NodeNum from, uint32_t ms);
+
+    /// Halve every count, so the table follows recent traffic
+    void decay();
+
+    /// Copy the entries, biggest airtime first
+    /// @return the number of entries copied
+    size_t getTop(Entry *out, size_t max) const;
+
+  private:
+    Entry entries[AIRTIME_TOP_NODES] = {};
+    uint8_t used = 0;
+};
+
 void logAirtime(reportTypes reportType, uint32_t airtime_ms);
 
 uint32_t *airtimeReport(reportTypes reportType);
@@ -46,9 +128,25 @@ class AirTime : private concurrency::OSThread
     AirTime();
 
     void logAirtime(reportTypes reportType, uint32_t airtime_ms);
+    /// Same, and attribute the airtime to the node which sent the packet
+    void logAirtime(reportTypes reportType, uint32_t airtime_ms, NodeNum from);
     float channelUtilizationPercent();
     float utilizationTXPercent();
 
+    /// Channel utilization over the last seconds (at most AIRTIME_WINDOW_SECONDS), to one second resolution
+    float channelUtilizationPercent(uint32_t seconds) { return channelWindow.percent(seconds); }
+
+    /// The senders using the most airtime recently, biggest first
+    size_t getTopSenders(AirtimeHeavyHitters::Entry *out, size_t max) const { return topSenders.getTop(out, max); }
+
+    /// @return utilization over a few spans and the top senders as JSON, main thread only
+    std::string buildJson();
+
+#ifdef ARCH_PORTDUINO
+    /// @return what buildJson() gave at the last tick.  Safe to call from any thread (the web server).
+    std::string toJson();
+#endif
+
     float UtilizationPercentTX();
     uint32_t channelUtilization[CHANNEL_UTILIZATION_PERIODS] = {0};
     uint32_t utilizationTX[MINUTES_IN_HOUR] = {0};
@@ -71,6 +169,15 @@ class AirTime : private concurrency::OSThread
     uint8_t polite_channel_util_percent = 25;
     uint8_t polite_duty_cycle_percent = 50; // half of Duty Cycle allowance is ok for metadata
 
+    AirtimeWindow channelWindow; // everything on air, like channelUtilization
+    AirtimeWindow txWindow;      // what we transmitted, like utilizationTX
+    AirtimeHeavyHitters topSenders;
+
+#ifdef ARCH_PORTDUINO
+    std::mutex snapshotLock;
+    std::string snapshot;
+#endif
+
     struct airtimeStruct {
         uint32_t periodTX[PERIODS_TO_LOG];     // AirTime transmitted
         uint32_t periodRX[PERIODS_TO_LOG];     // AirTime received and repeated (Only valid mesh packets)
@@ -13,6 +13,29 @@ BinarySemaphorePosix::~BinarySemaphorePosix() {}
 /**
  * Returns false if we timed out
  */
+#ifdef ARCH_PORTDUINO
+bool BinarySemaphorePosix::take(uint32_t msec)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    bool r = signal.wait_for(guard, std::chrono::milliseconds(msec), [this] { return given; });
+    given = false;
+    return r;
+}
+
+void BinarySemaphorePosix::give()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        given = true;
+    }
+    signal.notify_one();
+}
+
+IRAM_ATTR void BinarySemaphorePosix::giveFromISR(BaseType_t *pxHigherPriorityTaskWoken)
+{
+    give();
+}
+#else
 bool BinarySemaphorePosix::take(uint32_t msec)
 {
     delay(msec); // FIXME
@@ -22,6 +45,7 @@ bool BinarySemaphorePosix::take(uint32_t msec)
 void BinarySemaphorePosix::give() {}
 
 IRAM_ATTR void BinarySemaphorePosix::giveFromISR(BaseType_t *pxHigherPriorityTaskWoken) {}
+#endif
 
 } // namespace concurrency
 
@@ -2,6 +2,11 @@
 
 #include "../freertosinc.h"
 
+#ifdef ARCH_PORTDUINO
+#include <condition_variable>
+#include <mutex>
+#endif
+
 namespace concurrency
 {
 
@@ -9,7 +14,12 @@ namespace concurrency
 
 class BinarySemaphorePosix
 {
-    // SemaphoreHandle_t semaphore;
+#ifdef ARCH_PORTDUINO
+    // 'Interrupts' are other host threads here (GPIO edge waits, the portduino pin emulation), so this has to be real
+    std::mutex lock;
+    std::condition_variable signal;
+    bool given = false;
+#endif
 
   public:
     BinarySemaphorePosix();
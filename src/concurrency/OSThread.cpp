@@ -37,14 +37,32 @@ OSThread::OSThread(const char *_name, uint32_t period, ThreadController *_contro
         bool added = controller->add(this);
         assert(added);
     }
+    if (controller == &mainController)
+        mainScheduler.add(this);
 }
 
 OSThread::~OSThread()
 {
+    if (controller == &mainController)
+        mainScheduler.remove(this);
     if (controller)
         controller->remove(this);
 }
 
+IRAM_ATTR void OSThread::reschedule()
+{
+    if (controller == &mainController) {
+        rescheduled = true;
+        mainScheduler.requestReschedule();
+    }
+}
+
+IRAM_ATTR void OSThread::setInterval(unsigned long _interval)
+{
+    Thread::setInterval(_interval);
+    reschedule();
+}
+
 /**
  * Wait a specified number msecs starting from the current time (rather than the last time we were run)
  */
@@ -55,6 +73,7 @@ void OSThread::setIntervalFromNow(unsigned long _interval)
 
     // Cache the next run based on the last_run
     _cached_next_run = millis() + interval;
+    reschedule();
 }
 
 bool OSThread::shouldRun(unsigned long time)
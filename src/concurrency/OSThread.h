@@ -6,6 +6,11 @@
 #include "Thread.h"
 #include "ThreadController.h"
 #include "concurrency/InterruptableDelay.h"
+#include "concurrency/Scheduler.h"
+#include "configuration.h"
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+#include "concurrency/ThreadProfile.h"
+#endif
 
 namespace concurrency
 {
@@ -30,8 +35,23 @@ extern InterruptableDelay mainDelay;
  */
 class OSThread : public Thread
 {
+    friend class Scheduler;
+
     ThreadController *controller;
 
+    int8_t heapIndex = -1;             // Our slot in the scheduler heap, -1 if not in it
+    bool parked = false;               // Due but disabled, see Scheduler
+    volatile bool rescheduled = false; // Our next run time changed since the scheduler last looked
+    uint64_t deadline = 0;             // Next run time on the scheduler clock
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+    ThreadProfile profile; // Filled in by the scheduler
+#endif
+
+    unsigned long getNextRunTime() const { return _cached_next_run; }
+
+    /// Let the scheduler know our next run time changed
+    void reschedule();
+
     /// Show debugging info for disabled threads
     static bool showDisabled;
 
@@ -60,6 +80,16 @@ class OSThread : public Thread
      */
     void setIntervalFromNow(unsigned long _interval);
 
+    /**
+     * Wait a specified number msecs starting from the last time we were run.  Safe to call from other tasks and ISRs.
+     */
+    void setInterval(unsigned long _interval);
+
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+    /// Run time statistics, see ThreadProfiler
+    const ThreadProfile &getProfile() const { return profile; }
+#endif
+
   protected:
     /**
      * The method that will be called each time our thread gets a chance to run
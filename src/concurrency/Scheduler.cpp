@@ -0,0 +1,234 @@
+#include "Scheduler.h"
+#include "OSThread.h"
+#include "configuration.h"
+#include <assert.h>
+
+namespace concurrency
+{
+
+Scheduler mainScheduler;
+
+uint64_t Scheduler::now()
+{
+    uint32_t ms = millis();
+    now64 += (uint32_t)(ms - lastMillis);
+    lastMillis = ms;
+    return now64;
+}
+
+uint64_t Scheduler::deadlineOf(const OSThread *t)
+{
+    // Same wrap-safe comparison as Thread::shouldRun(), anything overdue is due right now
+    int32_t wait = (int32_t)(t->getNextRunTime() - lastMillis);
+    return wait > 0 ? now64 + wait : now64;
+}
+
+void Scheduler::add(OSThread *t)
+{
+    now();
+    t->deadline = deadlineOf(t);
+    t->rescheduled = false;
+    push(t);
+}
+
+void Scheduler::remove(OSThread *t)
+{
+    if (t == running)
+        running = nullptr;
+    for (int i = 0; i < ranCount; i++)
+        if (ran[i] == t)
+            ran[i] = ran[--ranCount];
+    if (t->heapIndex >= 0)
+        erase(t->heapIndex);
+    for (int i = 0; i < parkedSize; i++)
+        if (parked[i] == t)
+            unpark(i);
+    t->parked = false;
+}
+
+void Scheduler::place(int i, OSThread *t)
+{
+    heap[i] = t;
+    t->heapIndex = i;
+}
+
+void Scheduler::siftUp(int i)
+{
+    OSThread *t = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap[parent]->deadline <= t->deadline)
+            break;
+        place(i, heap[parent]);
+        i = parent;
+    }
+    place(i, t);
+}
+
+void Scheduler::siftDown(int i)
+{
+    OSThread *t = heap[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= heapSize)
+            break;
+        if (child + 1 < heapSize && heap[child + 1]->deadline < heap[child]->deadline)
+            child++;
+        if (t->deadline <= heap[child]->deadline)
+            break;
+        place(i, heap[child]);
+        i = child;
+    }
+    place(i, t);
+}
+
+void Scheduler::push(OSThread *t)
+{
+    assert(heapSize < MAX_THREADS);
+    place(heapSize++, t);
+    siftUp(t->heapIndex);
+}
+
+OSThread *Scheduler::pop()
+{
+    OSThread *t = heap[0];
+    erase(0);
+    return t;
+}
+
+void Scheduler::erase(int i)
+{
+    OSThread *t = heap[i];
+    t->heapIndex = -1;
+    if (--heapSize == i)
+        return;
+
+    place(i, heap[heapSize]);
+    siftUp(i);
+    siftDown(heap[i] == t ? i : heap[i]->heapIndex);
+}
+
+void Scheduler::park(OSThread *t)
+{
+    t->parked = true;
+    parked[parkedSize++] = t;
+}
+
+void Scheduler::unpark(int i)
+{
+    parked[i]->parked = false;
+    parked[i] = parked[--parkedSize];
+}
+
+void Scheduler::applyReschedules()
+{
+    if (!rescheduleRequested)
+        return;
+    rescheduleRequested = false; // a flag raised while we sweep sets this again, so it's picked up next time
+
+    for (int i = 0; i < parkedSize;) {
+        OSThread *t = parked[i];
+        if (t->rescheduled) {
+            t->rescheduled = false;
+            unpark(i);
+            t->deadline = deadlineOf(t);
+            push(t);
+        } else {
+            i++;
+        }
+    }
+
+    // Collect first, re-keying moves entries around
+    OSThread *flagged[MAX_THREADS];
+    int numFlagged = 0;
+    for (int i = 0; i < heapSize; i++)
+        if (heap[i]->rescheduled)
+            flagged[numFlagged++] = heap[i];
+
+    for (int i = 0; i < numFlagged; i++) {
+        OSThread *t = flagged[i];
+        t->rescheduled = false;
+        uint64_t old = t->deadline;
+        t->deadline = deadlineOf(t);
+        if (t->deadline < old)
+            siftUp(t->heapIndex);
+        else
+            siftDown(t->heapIndex);
+    }
+}
+
+void Scheduler::logWaiting(uint64_t start)
+{
+    // Only when debugging, this visits every thread like the old polling loop did
+    for (int i = 0; i < heapSize; i++)
+        if (heap[i]->deadline > start && heap[i]->enabled)
+            LOG_DEBUG("Thread %s: wait %lu", heap[i]->ThreadName.c_str(), heap[i]->interval);
+}
+
+long Scheduler::runOrDelay()
+{
+    ranCount = 0;
+    now();
+    applyReschedules();
+
+    // Whoever got enabled again since last time is due right now
+    for (int i = 0; i < parkedSize;) {
+        OSThread *t = parked[i];
+        if (t->enabled) {
+            unpark(i);
+            t->deadline = now64;
+            push(t);
+        } else {
+            i++;
+        }
+    }
+
+    uint64_t start = now64;
+    if (OSThread::showWaiting)
+        logWaiting(start);
+    if (OSThread::showDisabled)
+        for (int i = 0; i < parkedSize; i++)
+            LOG_DEBUG("Thread %s: disabled", parked[i]->ThreadName.c_str());
+
+    while (heapSize > 0 && heap[0]->deadline <= start) {
+        OSThread *t = pop();
+        if (!t->enabled) {
+            if (OSThread::showDisabled)
+                LOG_DEBUG("Thread %s: disabled", t->ThreadName.c_str());
+            park(t);
+            continue;
+        }
+        if (OSThread::showRun)
+            LOG_DEBUG("Thread %s: run", t->ThreadName.c_str());
+
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+        uint32_t lateMs = now64 - t->deadline;
+        uint32_t startUs = micros();
+#endif
+        running = t;
+        t->run();
+        if (running == t) { // it might have been deleted by runOnce()
+            ran[ranCount++] = t;
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+            t->profile.record(micros() - startUs, lateMs);
+#endif
+        }
+        running = nullptr;
+
+        now();
+        applyReschedules();
+    }
+
+    for (int i = 0; i < ranCount; i++) {
+        ran[i]->rescheduled = false;
+        ran[i]->deadline = deadlineOf(ran[i]);
+        push(ran[i]);
+    }
+
+    if (heapSize == 0)
+        return INT32_MAX;
+    uint64_t next = heap[0]->deadline;
+    return next > now64 ? (long)(next - now64) : 0;
+}
+
+} // namespace concurrency
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "ThreadController.h"
+
+namespace concurrency
+{
+
+class OSThread;
+
+/**
+ * Runs the OSThreads of mainController in order of their next run time.
+ *
+ * ThreadController::runOrDelay() asks every registered thread shouldRun() on every loop iteration and then scans them all
+ * again to work out how long we may sleep.  Here the threads sit in a min-heap keyed by next run time, so an iteration only
+ * touches the threads that are actually due and the sleep time is simply the top of the heap.
+ *
+ * A thread whose next run time changes (setInterval(0) from a queue, setIntervalFromNow()...) only gets flagged, which is
+ * safe from any task or ISR.  The scheduler re-keys the flagged entries the next time it looks at the heap.
+ *
+ * Threads that are due but disabled by clearing OSThread::enabled directly are parked on a short list we check every loop,
+ * because nothing tells us when enabled is set again.
+ *
+ * OSThread::shouldRun() isn't called any more, the showRun, showWaiting and showDisabled diagnostics are logged from here.
+ */
+class Scheduler
+{
+  public:
+    void add(OSThread *t);
+    void remove(OSThread *t);
+
+    /// Called (from any context) after a thread's next run time changed
+    void requestReschedule() { rescheduleRequested = true; }
+
+    /**
+     * Run every thread which is due, each at most once
+     * @return msecs until the next thread is due
+     */
+    long runOrDelay();
+
+  private:
+    OSThread *heap[MAX_THREADS];
+    int heapSize = 0;
+
+    OSThread *parked[MAX_THREADS];
+    int parkedSize = 0;
+
+    /// The thread currently in runOnce(), cleared if it gets removed meanwhile
+    OSThread *running = nullptr;
+
+    /// Threads already run by this runOrDelay() call.  They go back into the heap at the end, so a thread asking to run
+    /// again right away can't starve the others
+    OSThread *ran[MAX_THREADS];
+    int ranCount = 0;
+
+    volatile bool rescheduleRequested = false;
+
+    /// millis() extended to 64 bits, so heap keys never wrap
+    uint64_t now64 = 0;
+    uint32_t lastMillis = 0;
+
+    uint64_t now();
+
+    /// Deadline of a thread on our 64 bit clock, from its Thread::_cached_next_run
+    uint64_t deadlineOf(const OSThread *t);
+
+    void push(OSThread *t);
+    OSThread *pop();
+    void erase(int i);
+    void siftUp(int i);
+    void siftDown(int i);
+    void place(int i, OSThread *t);
+
+    void park(OSThread *t);
+    void unpark(int i);
+
+    /// Re-key every thread flagged by setInterval() and friends
+    void applyReschedules();
+
+    /// OSThread::showWaiting: list the threads which aren't due yet
+    void logWaiting(uint64_t start);
+};
+
+extern Scheduler mainScheduler;
+
+} // namespace concurrency
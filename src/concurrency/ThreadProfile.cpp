@@ -0,0 +1,14 @@
+#include "ThreadProfile.h"
+
+namespace concurrency
+{
+
+void ThreadProfile::record(uint32_t runUs, uint32_t lateMs)
+{
+    Log2Histogram::record(runUs);
+    totalLateMs += lateMs;
+    if (lateMs > maxLateMs)
+        maxLateMs = lateMs;
+}
+
+} // namespace concurrency
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Log2Histogram.h"
+#include <stdint.h>
+
+namespace concurrency
+{
+
+/**
+ * Run time statistics for one OSThread, recorded by the Scheduler around every runOnce()
+ *
+ * Run times go into the histogram (count is the number of runs), the last bucket holds everything from ~0.5 sec up.  Late
+ * start is how long past its due time the thread actually got to run, i.e. how long something else was hogging the loop.
+ */
+struct ThreadProfile : Log2Histogram<20> {
+    uint64_t totalLateMs = 0;
+    uint32_t maxLateMs = 0;
+
+    void record(uint32_t runUs, uint32_t lateMs);
+};
+
+} // namespace concurrency
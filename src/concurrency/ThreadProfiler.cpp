@@ -0,0 +1,98 @@
+#include "ThreadProfiler.h"
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+
+#ifdef ARCH_PORTDUINO
+#include "Throttle.h"
+
+// Wake often enough to keep the web server's snapshot fresh, and log on the slower interval
+#define PROFILER_RUN_MS THREAD_PROFILER_SNAPSHOT_MS
+#else
+#define PROFILER_RUN_MS THREAD_PROFILER_LOG_INTERVAL_MS
+#endif
+
+namespace concurrency
+{
+
+ThreadProfiler *threadProfiler;
+
+#ifdef ARCH_PORTDUINO
+std::mutex ThreadProfiler::snapshotLock;
+std::string ThreadProfiler::snapshot;
+#endif
+
+ThreadProfiler::ThreadProfiler() : OSThread("ThreadProfiler", PROFILER_RUN_MS)
+{
+    if (PROFILER_RUN_MS == 0)
+        disable();
+#ifdef ARCH_PORTDUINO
+    lastLogMs = millis();
+#endif
+}
+
+int32_t ThreadProfiler::runOnce()
+{
+#ifdef ARCH_PORTDUINO
+    std::string json = buildJson();
+    {
+        std::lock_guard<std::mutex> guard(snapshotLock);
+        snapshot.swap(json);
+    }
+
+    if (THREAD_PROFILER_LOG_INTERVAL_MS == 0 || Throttle::isWithinTimespanMs(lastLogMs, THREAD_PROFILER_LOG_INTERVAL_MS))
+        return PROFILER_RUN_MS;
+    lastLogMs = millis();
+#endif
+    logProfiles();
+    return PROFILER_RUN_MS;
+}
+
+void ThreadProfiler::logProfiles()
+{
+    for (int i = 0; i < MAX_THREADS; i++) {
+        auto thread = static_cast<OSThread *>(mainController.get(i));
+        if (!thread || !thread->getProfile().count)
+            continue;
+
+        const ThreadProfile &p = thread->getProfile();
+        LOG_INFO("Thread %s: runs=%u total=%ums avg=%uus max=%uus p99<%uus late avg=%ums max=%ums", thread->ThreadName.c_str(),
+                 p.count, (uint32_t)(p.totalUs / 1000), (uint32_t)(p.totalUs / p.count), p.maxUs,
+                 p.percentileUs(99), (uint32_t)(p.totalLateMs / p.count), p.maxLateMs);
+    }
+}
+
+#ifdef ARCH_PORTDUINO
+std::string ThreadProfiler::toJson()
+{
+    std::lock_guard<std::mutex> guard(snapshotLock);
+    return snapshot.empty() ? "[]" : snapshot;
+}
+
+std::string ThreadProfiler::buildJson()
+{
+    std::string json = "[";
+    char entry[256];
+
+    for (int i = 0; i < MAX_THREADS; i++) {
+        auto thread = static_cast<OSThread *>(mainController.get(i));
+        if (!thread)
+            continue;
+
+        const ThreadProfile &p = thread->getProfile();
+        snprintf(entry, sizeof(entry),
+                 "%s{\"name\":\"%s\",\"enabled\":%s,\"invocations\":%u,\"total_us\":%llu,\"max_us\":%u,\"p99_us\":%u,"
+                 "\"total_late_ms\":%llu,\"max_late_ms\":%u}",
+                 json.size() > 1 ? "," : "", thread->ThreadName.c_str(), thread->enabled ? "true" : "false", p.count,
+                 (unsigned long long)p.totalUs, p.maxUs, p.percentileUs(99), (unsigned long long)p.totalLateMs, p.maxLateMs);
+        json += entry;
+    }
+
+    json += "]";
+    return json;
+}
+#endif
+
+} // namespace concurrency
+
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "concurrency/OSThread.h"
+#include <string>
+#ifdef ARCH_PORTDUINO
+#include <mutex>
+#endif
+
+// How often the per-thread run time statistics are written to the log, 0 to never log them
+#ifndef THREAD_PROFILER_LOG_INTERVAL_MS
+#define THREAD_PROFILER_LOG_INTERVAL_MS (10 * 60 * 1000)
+#endif
+
+// How often meshtasticd refreshes the statistics its web server hands out
+#ifndef THREAD_PROFILER_SNAPSHOT_MS
+#define THREAD_PROFILER_SNAPSHOT_MS (5 * 1000)
+#endif
+
+namespace concurrency
+{
+
+/**
+ * Reports the ThreadProfile of every OSThread: periodically to the log, and as JSON for the meshtasticd web server.
+ *
+ * Use it to find out which thread is stalling the main loop (and so delaying packet handling) in the field.
+ *
+ * Threads are created and deleted on the main thread, so only the main thread walks them.  The web server gets the
+ * last snapshot taken by runOnce().
+ */
+class ThreadProfiler : private OSThread
+{
+  public:
+    ThreadProfiler();
+
+    /// Log one line per thread that has run so far
+    static void logProfiles();
+
+#ifdef ARCH_PORTDUINO
+    /// @return a JSON array with the statistics of every thread, as of the last snapshot.  Safe to call from any thread.
+    static std::string toJson();
+#endif
+
+  protected:
+    int32_t runOnce() override;
+
+  private:
+#ifdef ARCH_PORTDUINO
+    /// Format every thread as JSON, main thread only
+    static std::string buildJson();
+
+    static std::mutex snapshotLock;
+    static std::string snapshot;
+
+    uint32_t lastLogMs = 0;
+#endif
+};
+
+extern ThreadProfiler *threadProfiler;
+
+} // namespace concurrency
@@ -47,6 +47,10 @@ EInkDisplay::EInkDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY
         shortSide = (shortSide | 7) + 1;
 
     this->displayBufferSize = longSide * (shortSide / 8);
+
+    // Send the whole image, by default
+    this->updateWidth = EINK_WIDTH;
+    this->updateHeight = EINK_HEIGHT;
 }
 
 /**
@@ -65,21 +69,21 @@ bool EInkDisplay::forceDisplay(uint32_t msecLimit)
     else
         return false;
 
-    // FIXME - only draw bits have changed (use backbuf similar to the other displays)
+    // Only the update region: pixels outside GxEPD2's window would be dropped anyway
     const bool flipped = config.display.flip_screen;
     // HACK for L1 EInk
 #if defined(SEEED_WIO_TRACKER_L1_EINK)
     // For SEEED_WIO_TRACKER_L1_EINK, setRotation(3) is correct but mirrored; flip both axes
-    for (uint32_t y = 0; y < displayHeight; y++) {
-        for (uint32_t x = 0; x < displayWidth; x++) {
+    for (uint32_t y = updateY; y < updateY + updateHeight; y++) {
+        for (uint32_t x = updateX; x < updateX + updateWidth; x++) {
             auto b = buffer[x + (y / 8) * displayWidth];
             auto isset = b & (1 << (y & 7));
             adafruitDisplay->drawPixel((displayWidth - 1) - x, (displayHeight - 1) - y, isset ? GxEPD_BLACK : GxEPD_WHITE);
         }
     }
 #else
-    for (uint32_t y = 0; y < displayHeight; y++) {
-        for (uint32_t x = 0; x < displayWidth; x++) {
+    for (uint32_t y = updateY; y < updateY + updateHeight; y++) {
+        for (uint32_t x = updateX; x < updateX + updateWidth; x++) {
             auto b = buffer[x + (y / 8) * displayWidth];
             auto isset = b & (1 << (y & 7));
             if (flipped)
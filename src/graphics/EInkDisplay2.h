@@ -67,6 +67,12 @@ class EInkDisplay : public OLEDDisplay
     void setDetected(uint8_t detected);
 
   protected:
+    // Region of the image which forceDisplay() sends to the panel. The whole display, unless EInkDynamicDisplay narrows it
+    uint16_t updateX = 0;
+    uint16_t updateY = 0;
+    uint16_t updateWidth = 0;
+    uint16_t updateHeight = 0;
+
     // the header size of the buffer used, e.g. for the SPI command header
     virtual int getBufferOffset(void) override { return 0; }
 
@@ -3,6 +3,7 @@
 
 #if defined(USE_EINK) && defined(USE_EINK_DYNAMICDISPLAY)
 #include "EInkDynamicDisplay.h"
+#include "EInkImage.h"
 
 // Constructor
 EInkDynamicDisplay::EInkDynamicDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY geometry, HW_I2C i2cBus)
@@ -12,6 +13,11 @@ EInkDynamicDisplay::EInkDynamicDisplay(uint8_t address, int sda, int scl, OLEDDI
 #ifdef EINK_LIMIT_GHOSTING_PX
     dirtyPixels = new uint8_t[EInkDisplay::displayBufferSize](); // Init with zeros
 #endif
+
+    // Keep a copy of the image on the display, to find what changed. Zeros: all white, as after clearScreen()
+#ifndef EINK_FAST_FULL_WINDOW
+    previousFrame = new uint8_t[EInkDisplay::displayBufferSize]();
+#endif
 }
 
 // Destructor
@@ -21,6 +27,9 @@ EInkDynamicDisplay::~EInkDynamicDisplay()
 #ifdef EINK_LIMIT_GHOSTING_PX
     delete[] dirtyPixels;
 #endif
+#ifndef EINK_FAST_FULL_WINDOW
+    delete[] previousFrame;
+#endif
 }
 
 // Screen requests a BACKGROUND frame
@@ -49,8 +58,41 @@ void EInkDynamicDisplay::configForFastRefresh()
 {
     // Variant-specific code can go here
 #if defined(PRIVATE_HW)
+#elif !defined(EINK_FAST_FULL_WINDOW)
+    // Otherwise: a window around whatever changed, so that less is sent over SPI, and less of the panel refreshed
+    EInkRegion region;
+    if (adafruitDisplay->epd2.hasPartialUpdate &&
+        einkChangedRegion(previousFrame, buffer, displayWidth, displayHeight, &region)) {
+        // Window is given to GxEPD2 in the same coordinates as EInkDisplay::forceDisplay() draws pixels
+        uint16_t x = region.x;
+        uint16_t y = region.y;
+#if defined(SEEED_WIO_TRACKER_L1_EINK)
+        const bool flipped = true;
 #else
-    // Otherwise:
+        const bool flipped = config.display.flip_screen;
+#endif
+        if (flipped) {
+            x = displayWidth - (region.x + region.width);
+            y = displayHeight - (region.y + region.height);
+        }
+        adafruitDisplay->setPartialWindow(x, y, region.width, region.height);
+        LOG_DEBUG("window=%ux%u at %u,%u (%u%% of panel), ", region.width, region.height, region.x, region.y,
+                  (uint32_t)region.width * region.height * 100 / ((uint32_t)displayWidth * displayHeight));
+
+        // GxEPD2 widens the window to whole bytes along the panel's own rows, which may be either of our axes
+        // Draw a margin of up to 7px all round, so that those extra pixels are drawn too
+        updateX = region.x > 7 ? region.x - 7 : 0;
+        updateY = region.y > 7 ? region.y - 7 : 0;
+        updateWidth = min((uint16_t)(region.x + region.width + 7), (uint16_t)displayWidth) - updateX;
+        updateHeight = min((uint16_t)(region.y + region.height + 7), (uint16_t)displayHeight) - updateY;
+    } else {
+        updateX = updateY = 0;
+        updateWidth = displayWidth;
+        updateHeight = displayHeight;
+        adafruitDisplay->setPartialWindow(0, 0, adafruitDisplay->width(), adafruitDisplay->height());
+    }
+#else
+    // Opted out: always the whole display
     adafruitDisplay->setPartialWindow(0, 0, adafruitDisplay->width(), adafruitDisplay->height());
 #endif
 }
@@ -58,6 +100,11 @@ void EInkDynamicDisplay::configForFastRefresh()
 // GxEPD2 code to set full refresh
 void EInkDynamicDisplay::configForFullRefresh()
 {
+    // Full refresh always sends the whole image
+    updateX = updateY = 0;
+    updateWidth = displayWidth;
+    updateHeight = displayHeight;
+
     // Variant-specific code can go here
 #if defined(PRIVATE_HW)
 #else
@@ -69,8 +116,8 @@ void EInkDynamicDisplay::configForFullRefresh()
 // Run any relevant GxEPD2 code, so next update will use correct refresh type
 void EInkDynamicDisplay::applyRefreshMode()
 {
-    // Change from FULL to FAST
-    if (currentConfig == FULL && refresh == FAST) {
+    // FAST, from FULL or FAST: the window is set again each time, to fit this frame's changes
+    if (refresh == FAST) {
         configForFastRefresh();
         currentConfig = FAST;
     }
@@ -99,6 +146,9 @@ bool EInkDynamicDisplay::update()
     bool refreshApproved = determineMode();
     if (refreshApproved) {
         EInkDisplay::forceDisplay(0); // Bypass base class' own rate-limiting system
+#ifndef EINK_FAST_FULL_WINDOW
+        memcpy(previousFrame, buffer, displayBufferSize); // What the panel now shows, to compare the next frame against
+#endif
         storeAndReset();              // Store the result of this loop for next time. Note: call *before* endOrDetach()
         endOrDetach();                // endUpdate() right now, or set the async refresh flag (if FULL and HAS_EINK_ASYNCFULL)
     } else
@@ -378,12 +428,7 @@ void EInkDynamicDisplay::resetRateLimiting()
 // Generate a hash of this frame, to compare against previous update
 void EInkDynamicDisplay::hashImage()
 {
-    imageHash = 0;
-
-    // Sum all bytes of the image buffer together
-    for (uint16_t b = 0; b < (displayWidth / 8) * displayHeight; b++) {
-        imageHash ^= buffer[b] << b;
-    }
+    imageHash = einkHashImage(buffer, displayBufferSize);
 }
 
 // Store the results of determineMode() for future use, and reset for next call
@@ -410,27 +455,11 @@ void EInkDynamicDisplay::countGhostPixels()
     if (refresh != UNSPECIFIED)
         return;
 
-    // Start a new count
-    ghostPixelCount = 0;
-
-    // Check new image, bit by bit, for any white pixels at locations marked "dirty"
-    for (uint16_t i = 0; i < displayBufferSize; i++) {
-        for (uint8_t bit = 0; bit < 7; bit++) {
-
-            const bool dirty = (dirtyPixels[i] >> bit) & 1;       // Has pixel location been drawn to since full-refresh?
-            const bool shouldBeBlank = !((buffer[i] >> bit) & 1); // Is pixel location white in the new image?
-
-            // If pixel is (or has been) black since last full-refresh, and now is white: ghosting
-            if (dirty && shouldBeBlank)
-                ghostPixelCount++;
-
-            // Update the dirty status for this pixel - will this location become a ghost if set white in future?
-            if (!dirty && !shouldBeBlank)
-                dirtyPixels[i] |= (1 << bit);
-        }
-    }
+    // Any white pixels in the new image, at locations which have been black since full-refresh: ghosting
+    // Also marks the new image's black pixels as dirty - these locations become ghosts if set white in future
+    ghostPixelCount = einkCountGhostPixels(dirtyPixels, buffer, displayBufferSize);
 
-    LOG_DEBUG("ghostPixels=%hu, ", ghostPixelCount);
+    LOG_DEBUG("ghostPixels=%u, ", ghostPixelCount);
 }
 
 // Check if ghost pixel count exceeds the defined limit
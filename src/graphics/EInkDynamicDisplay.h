@@ -113,6 +113,12 @@ class EInkDynamicDisplay : public EInkDisplay, protected concurrency::NotifiedWo
     uint32_t fastRefreshCount = 0;     // How many fast-refreshes consecutively since last full refresh?
     refreshTypes currentConfig = FULL; // Which refresh type is GxEPD2 currently configured for
 
+    // FAST refresh sends and refreshes only the region which changed since the last update, if the panel can
+    // Opt out with EINK_FAST_FULL_WINDOW
+#ifndef EINK_FAST_FULL_WINDOW
+    uint8_t *previousFrame; // Image as sent to the display by the last update (dynamically allocated mem)
+#endif
+
     // Optional - track ghosting, pixel by pixel
     // May 2024: no longer used by any display. Kept for possible future use.
 #ifdef EINK_LIMIT_GHOSTING_PX
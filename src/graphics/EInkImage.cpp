@@ -0,0 +1,143 @@
+#include "EInkImage.h"
+
+#include <string.h>
+
+// Native word of the machine, for the ghost count. unsigned long is 32 bits on the MCUs, 64 on a 64-bit Linux host
+typedef unsigned long EInkWord;
+
+static const uint32_t PRIME32_1 = 0x9E3779B1U;
+static const uint32_t PRIME32_2 = 0x85EBCA77U;
+static const uint32_t PRIME32_3 = 0xC2B2AE3DU;
+static const uint32_t PRIME32_4 = 0x27D4EB2FU;
+static const uint32_t PRIME32_5 = 0x165667B1U;
+
+static inline uint32_t rotl32(uint32_t x, uint8_t r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+// Little-endian, like all our targets. memcpy, as the image buffer isn't necessarily aligned
+static inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t round32(uint32_t acc, uint32_t input)
+{
+    acc += input * PRIME32_2;
+    acc = rotl32(acc, 13);
+    return acc * PRIME32_1;
+}
+
+uint32_t einkHashImage(const uint8_t *image, size_t size)
+{
+    const uint8_t *p = image;
+    const uint8_t *end = image + size;
+    uint32_t h;
+
+    // Four lanes, 16 bytes at a time
+    if (size >= 16) {
+        uint32_t v1 = PRIME32_1 + PRIME32_2;
+        uint32_t v2 = PRIME32_2;
+        uint32_t v3 = 0;
+        uint32_t v4 = 0 - PRIME32_1;
+        const uint8_t *limit = end - 16;
+        do {
+            v1 = round32(v1, read32(p));
+            v2 = round32(v2, read32(p + 4));
+            v3 = round32(v3, read32(p + 8));
+            v4 = round32(v4, read32(p + 12));
+            p += 16;
+        } while (p <= limit);
+        h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+    } else {
+        h = PRIME32_5;
+    }
+
+    h += (uint32_t)size;
+
+    // Remainder: words, then bytes
+    for (; p + 4 <= end; p += 4)
+        h = rotl32(h + read32(p) * PRIME32_3, 17) * PRIME32_4;
+    for (; p < end; p++)
+        h = rotl32(h + (*p) * PRIME32_5, 11) * PRIME32_1;
+
+    // Avalanche
+    h ^= h >> 15;
+    h *= PRIME32_2;
+    h ^= h >> 13;
+    h *= PRIME32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+bool einkChangedRegion(const uint8_t *previous, const uint8_t *image, uint16_t width, uint16_t height, EInkRegion *region)
+{
+    uint16_t left = width, right = 0, top = height, bottom = 0;
+    const uint16_t pages = (height + 7) / 8;
+
+    for (uint16_t page = 0; page < pages; page++) {
+        const uint8_t *p = previous + (page * width);
+        const uint8_t *n = image + (page * width);
+
+        // Most of the image is usually the same, skip it a row of bytes at a time
+        if (memcmp(p, n, width) == 0)
+            continue;
+
+        // Rows of padding, below the last row of pixels, don't count
+        const uint8_t rows = (page == pages - 1 && height % 8) ? (1 << (height % 8)) - 1 : 0xFF;
+
+        for (uint16_t x = 0; x < width; x++) {
+            uint8_t diff = (p[x] ^ n[x]) & rows;
+            if (!diff)
+                continue;
+
+            if (x < left)
+                left = x;
+            if (x > right)
+                right = x;
+
+            // Lowest and highest changed pixels of this column of 8
+            uint16_t first = (page * 8) + __builtin_ctz(diff);
+            uint16_t last = (page * 8) + 31 - __builtin_clz(diff);
+            if (first < top)
+                top = first;
+            if (last > bottom)
+                bottom = last;
+        }
+    }
+
+    if (left > right || top > bottom)
+        return false;
+
+    region->x = left;
+    region->y = top;
+    region->width = right - left + 1;
+    region->height = bottom - top + 1;
+    return true;
+}
+
+uint32_t einkCountGhostPixels(uint8_t *dirty, const uint8_t *image, size_t size)
+{
+    uint32_t count = 0;
+    size_t i = 0;
+
+    for (; i + sizeof(EInkWord) <= size; i += sizeof(EInkWord)) {
+        EInkWord d, img;
+        memcpy(&d, dirty + i, sizeof(d));
+        memcpy(&img, image + i, sizeof(img));
+
+        count += __builtin_popcountl(d & ~img); // Was black, now white
+        d |= img;                              // Black now, so a ghost if white later
+        memcpy(dirty + i, &d, sizeof(d));
+    }
+
+    for (; i < size; i++) {
+        count += __builtin_popcount(dirty[i] & (uint8_t)~image[i]);
+        dirty[i] |= image[i];
+    }
+
+    return count;
+}
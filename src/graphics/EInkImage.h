@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+    Whole-image operations for EInkDynamicDisplay, run on every frame it has to decide about.
+    Kept apart from the display class so they can be tested and benchmarked without a display.
+
+    Images are 1 bit per pixel, set for black. Work is done a machine word at a time.
+*/
+
+/**
+ * Hash an image, to tell whether it differs from the one on the display.
+ * This is xxHash32 (seed 0), so images which differ by a few pixels hash differently.
+ */
+uint32_t einkHashImage(const uint8_t *image, size_t size);
+
+/// A rectangle of the display, in pixels
+struct EInkRegion {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
+/**
+ * Find the smallest rectangle which holds every pixel that differs between two images.
+ * Images are in OLEDDisplay's layout: rows of width bytes, each byte a column of 8 pixels, lowest bit at the top.
+ * @return false if the images are the same
+ */
+bool einkChangedRegion(const uint8_t *previous, const uint8_t *image, uint16_t width, uint16_t height, EInkRegion *region);
+
+/**
+ * Count ghost pixels: black at some point since the last full refresh (set in dirty), but white in the new image.
+ * Marks the new image's black pixels in dirty, ready for the next count.
+ */
+uint32_t einkCountGhostPixels(uint8_t *dirty, const uint8_t *image, size_t size);
@@ -108,6 +108,7 @@ template <typename Driver0, typename Driver1> class GxEPD2_Multi
     {
       public:
         bool isBusy() { return m_epd2->isBusy(); }
+        bool hasPartialUpdate = false; // Copied from the selected driver
         GxEPD2_EPD *m_epd2;
     } epd2;
 
@@ -126,6 +127,7 @@ template <typename Driver0, typename Driver1> class GxEPD2_Multi
             driver1 = new GxEPD2_BW<Driver1, Driver1::HEIGHT>(Driver1(cs, dc, rst, busy, spi));
             epd2.m_epd2 = &(driver1->epd2);
         }
+        epd2.hasPartialUpdate = epd2.m_epd2->hasPartialUpdate;
     }
 
   private:
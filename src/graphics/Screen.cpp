@@ -98,6 +98,24 @@ namespace graphics
 // This means the *visible* area (sh1106 can address 132, but shows 128 for example)
 #define IDLE_FRAMERATE 1 // in fps
 
+// When set, frames whose content only changes with the NodeDB, the messages, the status observers and the minute are
+// drawn when one of those changes instead of at IDLE_FRAMERATE. Off unless asked for, until it has been tried on more boards
+#ifndef SCREEN_CHANGE_DRIVEN
+#define SCREEN_CHANGE_DRIVEN 0
+#endif
+
+// Such a frame is still redrawn this often, in case something changed that we don't watch
+#ifndef SCREEN_IDLE_REFRESH_MS
+#define SCREEN_IDLE_REFRESH_MS (30 * 1000)
+#endif
+
+// After input every frame is drawn at the framerate for a while, for scroll popups and the like
+#define SCREEN_INPUT_GRACE_MS 2000
+
+#ifndef SCREEN_STATS_INTERVAL_MS
+#define SCREEN_STATS_INTERVAL_MS (60 * 1000)
+#endif
+
 // DEBUG
 #define NUM_EXTRA_FRAMES 3 // text message and debug frame
 // if defined a pixel will blink to show redraws
@@ -306,31 +324,7 @@ SPIClass SPI1(HSPI);
 Screen::Screen(ScanI2C::DeviceAddress address, meshtastic_Config_DisplayConfig_OledType screenType, OLEDDISPLAY_GEOMETRY geometry)
     : concurrency::OSThread("Screen"), address_found(address), model(screenType), geometry(geometry), cmdQueue(32)
 {
-    graphics::normalFrames = new FrameCallback[MAX_NUM_NODES + NUM_EXTRA_FRAMES];
-
-    int32_t rawRGB = uiconfig.screen_rgb_color;
-
-    // Only validate the combined value once
-    if (rawRGB > 0 && rawRGB <= 255255255) {
-        LOG_INFO("Setting screen RGB color to user chosen: 0x%06X", rawRGB);
-        // Extract each component as a normal int first
-        int r = (rawRGB >> 16) & 0xFF;
-        int g = (rawRGB >> 8) & 0xFF;
-        int b = rawRGB & 0xFF;
-        if (r >= 0 && r <= 255 && g >= 0 && g <= 255 && b >= 0 && b <= 255) {
-            TFT_MESH = COLOR565(static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b));
-        }
-#ifdef TFT_MESH_OVERRIDE
-    } else if (rawRGB == 0) {
-        LOG_INFO("Setting screen RGB color to TFT_MESH_OVERRIDE: 0x%04X", TFT_MESH_OVERRIDE);
-        // Default to TFT_MESH_OVERRIDE if available
-        TFT_MESH = TFT_MESH_OVERRIDE;
-#endif
-    } else {
-        // Default best readable yellow color
-        LOG_INFO("Setting screen RGB color to default: (255,255,128)");
-        TFT_MESH = COLOR565(255, 255, 128);
-    }
+    initCommon();
 
 #if defined(USE_SH1106) || defined(USE_SH1107) || defined(USE_SH1107_128_64)
     dispdev = new SH1106Wire(address.address, -1, -1, geometry,
@@ -401,6 +395,47 @@ Screen::Screen(ScanI2C::DeviceAddress address, meshtastic_Config_DisplayConfig_O
     cmdQueue.setReader(this);
 }
 
+#ifdef ARCH_PORTDUINO
+Screen::Screen(OLEDDisplay *display)
+    : concurrency::OSThread("Screen"), model(meshtastic_Config_DisplayConfig_OledType_OLED_AUTO), geometry(GEOMETRY_RAWMODE),
+      cmdQueue(32)
+{
+    initCommon();
+    dispdev = display;
+    ui = new OLEDDisplayUi(dispdev);
+    cmdQueue.setReader(this);
+}
+#endif
+
+void Screen::initCommon()
+{
+    graphics::normalFrames = new FrameCallback[MAX_NUM_NODES + NUM_EXTRA_FRAMES];
+
+    int32_t rawRGB = uiconfig.screen_rgb_color;
+
+    // Only validate the combined value once
+    if (rawRGB > 0 && rawRGB <= 255255255) {
+        LOG_INFO("Setting screen RGB color to user chosen: 0x%06X", rawRGB);
+        // Extract each component as a normal int first
+        int r = (rawRGB >> 16) & 0xFF;
+        int g = (rawRGB >> 8) & 0xFF;
+        int b = rawRGB & 0xFF;
+        if (r >= 0 && r <= 255 && g >= 0 && g <= 255 && b >= 0 && b <= 255) {
+            TFT_MESH = COLOR565(static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b));
+        }
+#ifdef TFT_MESH_OVERRIDE
+    } else if (rawRGB == 0) {
+        LOG_INFO("Setting screen RGB color to TFT_MESH_OVERRIDE: 0x%04X", TFT_MESH_OVERRIDE);
+        // Default to TFT_MESH_OVERRIDE if available
+        TFT_MESH = TFT_MESH_OVERRIDE;
+#endif
+    } else {
+        // Default best readable yellow color
+        LOG_INFO("Setting screen RGB color to default: (255,255,128)");
+        TFT_MESH = COLOR565(255, 255, 128);
+    }
+}
+
 Screen::~Screen()
 {
     delete[] graphics::normalFrames;
@@ -897,7 +932,25 @@ int32_t Screen::runOnce()
 
     // this must be before the frameState == FIXED check, because we always
     // want to draw at least one FIXED frame before doing forceDisplay
-    ui->update();
+    if (frameNeedsRender()) {
+        uint32_t startUs = micros();
+        auto lastUpdate = ui->getUiState()->lastUpdate;
+        ui->update();
+        uint32_t busyUs = micros() - startUs;
+
+        renderStats.busyUs += busyUs;
+        if (busyUs > renderStats.maxUs)
+            renderStats.maxUs = busyUs;
+        // OLEDDisplayUi keeps to its own framerate, and returns without drawing when called early
+        if (ui->getUiState()->lastUpdate != lastUpdate) {
+            renderStats.drawn++;
+            frameDirty = false;
+            lastRenderMs = millis();
+        }
+    } else {
+        renderStats.skipped++;
+    }
+    logRenderStats();
 
     // Switch to a low framerate (to save CPU) when we are not in transition
     // but we should only call setTargetFPS when framestate changes, because
@@ -938,6 +991,58 @@ int32_t Screen::runOnce()
     return (1000 / targetFramerate);
 }
 
+bool Screen::frameNeedsRender()
+{
+#if !SCREEN_CHANGE_DRIVEN
+    return true;
+#else
+    // Anything we watch that changed since the last draw
+    if (nodeDB && nodeDB->getChangeCount() != seenNodeDBChanges) {
+        seenNodeDBChanges = nodeDB->getChangeCount();
+        frameDirty = true;
+    }
+    if (messageStore.getChangeCount() != seenMessageChanges) {
+        seenMessageChanges = messageStore.getChangeCount();
+        frameDirty = true;
+    }
+    uint32_t minute = getTime(true) / 60; // the clock in the header
+    if (minute != seenMinute) {
+        seenMinute = minute;
+        frameDirty = true;
+    }
+
+    // Transitions, banners, the boot and alert screens, and input need the framerate
+    if (targetFramerate != IDLE_FRAMERATE || ui->getUiState()->frameState != FIXED || !showingNormalScreen ||
+        NotificationRenderer::isOverlayBannerShowing() || Throttle::isWithinTimespanMs(lastInputMs, SCREEN_INPUT_GRACE_MS))
+        return true;
+
+    // Only the node lists show nothing but what we watch. The other frames have a clock, compass, uptime, auto-scrolling
+    // messages or module content, and are drawn at IDLE_FRAMERATE as before
+    uint8_t frame = ui->getUiState()->currentFrame;
+    const FramesetInfo::FramePositions &p = framesetInfo.positions;
+    uint32_t refreshMs = SCREEN_IDLE_REFRESH_MS;
+    if (frame == p.nodelist_nodes)
+        refreshMs = NodeListRenderer::getModeCycleIntervalMs(); // cycles between last heard and hops/signal
+    else if (frame != p.nodelist_lastheard && frame != p.nodelist_hopsignal && frame != p.nodelist_distance)
+        return true;
+
+    return frameDirty || !Throttle::isWithinTimespanMs(lastRenderMs, refreshMs);
+#endif
+}
+
+void Screen::logRenderStats()
+{
+    uint32_t now = millis();
+    if (now - renderStats.sinceMs < SCREEN_STATS_INTERVAL_MS)
+        return;
+
+    uint32_t elapsedMs = now - renderStats.sinceMs;
+    LOG_DEBUG("Screen: %u frames drawn, %u skipped, %u us/s in the UI (max %u us)", renderStats.drawn, renderStats.skipped,
+              (uint32_t)(renderStats.busyUs * 1000 / elapsedMs), renderStats.maxUs);
+    renderStats = RenderStats();
+    renderStats.sinceMs = now;
+}
+
 /* show a message that the SSL cert is being built
  * it is expected that this will be used during the boot phase */
 void Screen::setSSLFrames()
@@ -1012,6 +1117,7 @@ void Screen::setFrames(FrameFocus focus)
         return;
     }
 
+    frameDirty = true;
     uint8_t originalPosition = ui->getUiState()->currentFrame;
     uint8_t previousFrameCount = framesetInfo.frameCount;
     FramesetInfo fsi; // Location of specific frames, for applying focus parameter
@@ -1425,6 +1531,7 @@ void Screen::setFastFramerate()
 #endif
     // We are about to start a transition so speed up fps
     targetFramerate = SCREEN_TRANSITION_FRAMERATE;
+    frameDirty = true;
 
     ui->setTargetFPS(targetFramerate);
     setInterval(0); // redraw ASAP
@@ -1433,6 +1540,8 @@ void Screen::setFastFramerate()
 
 int Screen::handleStatusUpdate(const meshtastic::Status *arg)
 {
+    frameDirty = true; // battery, GPS and node counts are in the header
+
     switch (arg->getStatusType()) {
     case STATUS_TYPE_NODE:
         if (showingNormalScreen && nodeStatus->getLastNumTotal() != nodeStatus->getNumTotal()) {
@@ -1588,6 +1697,8 @@ int Screen::handleTextMessage(const meshtastic_MeshPacket *packet)
 // Triggered by MeshModules
 int Screen::handleUIFrameEvent(const UIFrameEvent *event)
 {
+    frameDirty = true;
+
     // Block UI frame events when virtual keyboard is active
     if (NotificationRenderer::current_notification_type == notificationTypeEnum::text_input) {
         return 0;
@@ -1625,6 +1736,8 @@ int Screen::handleInputEvent(const InputEvent *event)
     LOG_INPUT("Screen Input event %u! kb %u", event->inputEvent, event->kbchar);
     if (!screenOn)
         return 0;
+    lastInputMs = millis();
+    frameDirty = true;
 
     // Handle text input notifications specially - pass input to virtual keyboard
     if (NotificationRenderer::current_notification_type == notificationTypeEnum::text_input) {
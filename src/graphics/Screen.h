@@ -220,6 +220,10 @@ class Screen : public concurrency::OSThread
   public:
     OLEDDisplay *getDisplayDevice() { return dispdev; }
     explicit Screen(ScanI2C::DeviceAddress, meshtastic_Config_DisplayConfig_OledType, OLEDDISPLAY_GEOMETRY);
+#ifdef ARCH_PORTDUINO
+    /// Draw to a display of the caller's, instead of the one the board's defines pick (e.g. into memory, on the host)
+    explicit Screen(OLEDDisplay *display);
+#endif
 
     // Screen dimension accessors
     inline int getHeight() const { return displayHeight; }
@@ -646,7 +650,12 @@ class Screen : public concurrency::OSThread
     uint16_t displayWidth = 0;
     uint16_t displayHeight = 0;
 
+#ifndef PIO_UNIT_TESTING
   private:
+#endif
+    /// Setup shared by the constructors, before there is a display: the frame list, and the TFT_MESH color
+    void initCommon();
+
     FrameCallback alertFrames[1];
     struct ScreenCmd {
         Cmd cmd;
@@ -754,6 +763,27 @@ class Screen : public concurrency::OSThread
     /// Track USB power state to only wake screen on actual power state changes
     bool lastPowerUSBState = false;
 
+    /// Whether the frame shown may be out of date (see frameNeedsRender)
+    bool frameDirty = true;
+    uint32_t lastRenderMs = 0;
+    uint32_t lastInputMs = 0;
+    uint32_t seenNodeDBChanges = 0;
+    uint32_t seenMessageChanges = 0;
+    uint32_t seenMinute = 0;
+
+    /// Time spent in ui->update(), logged every SCREEN_STATS_INTERVAL_MS
+    struct RenderStats {
+        uint32_t drawn = 0;
+        uint32_t skipped = 0;
+        uint64_t busyUs = 0;
+        uint32_t maxUs = 0;
+        uint32_t sinceMs = 0;
+    } renderStats;
+
+    /// Whether the current frame has to be drawn on this tick, or can stay as it is
+    bool frameNeedsRender();
+    void logRenderStats();
+
     // Implementation to Adjust Brightness
     uint8_t brightness = BRIGHTNESS_DEFAULT; // H = 254, MH = 192, ML = 130 L = 103
 
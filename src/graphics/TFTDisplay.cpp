@@ -117,6 +117,7 @@ static LGFX *tft = nullptr;
 #include <TFT_eSPI.h>
 TFT_eSPI *tft = nullptr;
 FT6336U ft6336u;
+#define TFT_SYNC_FLUSH // No TFT_eSPI DMA on nRF52
 
 static uint8_t _rak14014_touch_int = false; // TP interrupt generation flag.
 static void rak14014_tpIntHandle(void)
@@ -808,6 +809,7 @@ static LGFX *tft = nullptr;
 #include <TFT_eSPI.h> // Graphics and font library for ILI9342 driver chip
 
 static TFT_eSPI *tft = nullptr; // Invoke library, pins defined in User_Setup.h
+#define TFT_SYNC_FLUSH
 #elif ARCH_PORTDUINO
 #include "Panel_sdl.hpp"
 #include <LovyanGFX.hpp> // Graphics and font library for ST7735 driver chip
@@ -1184,112 +1186,130 @@ TFTDisplay::TFTDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY g
 
 TFTDisplay::~TFTDisplay()
 {
-    // Clean up allocated line pixel buffer to prevent memory leak
-    if (linePixelBuffer != nullptr) {
-        free(linePixelBuffer);
-        linePixelBuffer = nullptr;
+    // Clean up allocated flush buffers to prevent memory leak
+    for (int i = 0; i < 2; i++) {
+        if (flushBuffer[i] != nullptr) {
+            free(flushBuffer[i]);
+            flushBuffer[i] = nullptr;
+        }
     }
 }
 
 // Write the buffer to the display memory
 void TFTDisplay::display(bool fromBlank)
 {
+    uint32_t startUs = micros();
+
     if (fromBlank)
         tft->fillScreen(TFT_BLACK);
 
     concurrency::LockGuard g(spiLock);
 
     uint32_t x, y;
-    uint32_t y_byteIndex;
-    uint8_t y_byteMask;
-    uint32_t x_FirstPixelUpdate;
-    uint32_t x_LastPixelUpdate;
-    bool isset, dblbuf_isset;
     uint16_t colorTftMesh, colorTftBlack;
     bool somethingChanged = false;
+    uint32_t pixelsSent = 0;
+    const uint32_t pages = (displayHeight + 7) / 8;
+    uint8_t next = 0; // Which flush buffer to fill
 
     // Store colors byte-reversed so that TFT_eSPI doesn't have to swap bytes in a separate step
     colorTftMesh = (TFT_MESH >> 8) | ((TFT_MESH & 0xFF) << 8);
     colorTftBlack = (TFT_BLACK >> 8) | ((TFT_BLACK & 0xFF) << 8);
 
-    y = 0;
-    while (y < displayHeight) {
-        y_byteIndex = (y / 8) * displayWidth;
-        y_byteMask = (1 << (y & 7));
-
-        // Step 1: Do a quick scan of 8 rows together. This allows fast-forwarding over unchanged screen areas.
-        if (y_byteMask == 1) {
-            if (!fromBlank) {
-                for (x = 0; x < displayWidth; x++) {
-                    if (buffer[x + y_byteIndex] != buffer_back[x + y_byteIndex])
-                        break;
-                }
-            } else {
-                for (x = 0; x < displayWidth; x++) {
-                    if (buffer[x + y_byteIndex] != 0)
-                        break;
-                }
-            }
-            if (x >= displayWidth) {
-                // No changed pixels found in these 8 rows, fast-forward to the next 8
-                y = y + 8;
-                continue;
-            }
-        }
+#if !defined(HACKADAY_COMMUNICATOR) && !defined(TFT_SYNC_FLUSH)
+    // One transaction for the whole frame, so each block can be sent by DMA while the next one is converted
+    tft->startWrite();
+#endif
 
-        // Step 2: Scan each of the 8 rows individually. Find the first pixel in each row that needs updating
-        for (x_FirstPixelUpdate = 0; x_FirstPixelUpdate < displayWidth; x_FirstPixelUpdate++) {
-            isset = buffer[x_FirstPixelUpdate + y_byteIndex] & y_byteMask;
+    for (uint32_t page = 0; page < pages; page += flushPages) {
+        uint32_t endPage = page + flushPages < pages ? page + flushPages : pages;
+
+        // Step 1: Find the rectangle of changed pixels in these pages (8 rows each, as the OLED lib orders its buffer).
+        // Unchanged pages are skipped with a single compare.
+        uint32_t xMin = displayWidth, xMax = 0, yMin = displayHeight, yMax = 0;
+        for (uint32_t p = page; p < endPage; p++) {
+            const uint8_t *row = buffer + p * displayWidth;
+            const uint8_t *rowBack = buffer_back + p * displayWidth;
+            if (!fromBlank && memcmp(row, rowBack, displayWidth) == 0)
+                continue;
 
-            if (!fromBlank) {
-                // get src pixel in the page based ordering the OLED lib uses
-                dblbuf_isset = buffer_back[x_FirstPixelUpdate + y_byteIndex] & y_byteMask;
-                if (isset != dblbuf_isset) {
-                    break;
+            uint8_t changedRows = 0; // One bit per row of the page
+            for (x = 0; x < displayWidth; x++) {
+                uint8_t changed = fromBlank ? row[x] : row[x] ^ rowBack[x];
+                if (changed) {
+                    if (x < xMin)
+                        xMin = x;
+                    if (x > xMax)
+                        xMax = x;
+                    changedRows |= changed;
                 }
-            } else if (isset) {
-                break;
             }
+            if (changedRows) {
+                if (yMin == displayHeight)
+                    yMin = p * 8 + __builtin_ctz(changedRows);
+                yMax = p * 8 + 31 - __builtin_clz(changedRows);
+            }
+        }
+        if (xMin > xMax || yMin >= displayHeight)
+            continue;
+        if (yMax >= displayHeight)
+            yMax = displayHeight - 1;
+
+        // Step 2: Convert the rectangle into the flush buffer, in the pixel format the display takes
+        uint32_t w = xMax - xMin + 1;
+        uint32_t h = yMax - yMin + 1;
+        uint16_t *pixels = flushBuffer[next];
+        for (y = yMin; y <= yMax; y++) {
+            const uint8_t *src = buffer + (y / 8) * displayWidth + xMin;
+            uint8_t y_byteMask = (1 << (y & 7));
+            for (x = 0; x < w; x++)
+                *pixels++ = (src[x] & y_byteMask) ? colorTftMesh : colorTftBlack;
         }
 
-        // Did we find a pixel that needs updating on this row?
-        if (x_FirstPixelUpdate < displayWidth) {
-
-            // Quickly write out the first changed pixel (saves another array lookup)
-            linePixelBuffer[x_FirstPixelUpdate] = isset ? colorTftMesh : colorTftBlack;
-            x_LastPixelUpdate = x_FirstPixelUpdate;
-
-            // Step 3: copy all remaining pixels in this row into the pixel line buffer,
-            // while also recording the last pixel in the row that needs updating
-            for (x = x_FirstPixelUpdate + 1; x < displayWidth; x++) {
-                isset = buffer[x + y_byteIndex] & y_byteMask;
-                linePixelBuffer[x] = isset ? colorTftMesh : colorTftBlack;
-
-                if (!fromBlank) {
-                    dblbuf_isset = buffer_back[x + y_byteIndex] & y_byteMask;
-                    if (isset != dblbuf_isset) {
-                        x_LastPixelUpdate = x;
-                    }
-                } else if (isset) {
-                    x_LastPixelUpdate = x;
-                }
-            }
+        // Step 3: Send the rectangle to the screen as a single block transfer.
+        // These functions accept pixel data MSB first so they can dump the memory straight out the SPI port.
 #if defined(HACKADAY_COMMUNICATOR)
-            tft->draw16bitBeRGBBitmap(x_FirstPixelUpdate, y, &linePixelBuffer[x_FirstPixelUpdate],
-                                      (x_LastPixelUpdate - x_FirstPixelUpdate + 1), 1);
+        tft->draw16bitBeRGBBitmap(xMin, yMin, flushBuffer[next], w, h);
+#elif defined(TFT_SYNC_FLUSH)
+        tft->pushRect(xMin, yMin, w, h, flushBuffer[next]);
 #else
-            // Step 4: Send the changed pixels on this line to the screen as a single block transfer.
-            // This function accepts pixel data MSB first so it can dump the memory straight out the SPI port.
-            tft->pushRect(x_FirstPixelUpdate, y, (x_LastPixelUpdate - x_FirstPixelUpdate + 1), 1,
-                          &linePixelBuffer[x_FirstPixelUpdate]);
+        // Returns once the previous block is out, while this one is still being sent: fill the other buffer meanwhile
+        tft->pushImageDMA(xMin, yMin, w, h, flushBuffer[next]);
+        if (flushBuffer[1])
+            next ^= 1;
+        else
+            tft->waitDMA();
 #endif
-            somethingChanged = true;
-        }
-        y++;
+        pixelsSent += w * h;
+        somethingChanged = true;
     }
+
+#if !defined(HACKADAY_COMMUNICATOR) && !defined(TFT_SYNC_FLUSH)
+    // The bus is shared: nothing may still be sending once spiLock is released
+    tft->waitDMA();
+    tft->endWrite();
+#endif
+
     // Copy the Buffer to the Back Buffer
     if (somethingChanged)
         memcpy(buffer_back, buffer, displayBufferSize);
+
+    // Frame time, logged now and then
+    uint32_t flushUs = micros() - startUs;
+    if (somethingChanged) {
+        flushStats.frames++;
+        flushStats.totalUs += flushUs;
+        flushStats.pixels += pixelsSent;
+        if (flushUs > flushStats.maxUs)
+            flushStats.maxUs = flushUs;
+    }
+    if (flushStats.frames && millis() - flushStats.sinceMs >= TFT_FLUSH_STATS_INTERVAL_MS) {
+        LOG_DEBUG("TFT flush: %u frames, avg %u us, max %u us, %u px per frame", flushStats.frames,
+                  (uint32_t)(flushStats.totalUs / flushStats.frames), flushStats.maxUs,
+                  (uint32_t)(flushStats.pixels / flushStats.frames));
+        flushStats = FlushStats();
+        flushStats.sinceMs = millis();
+    }
 }
 
 void TFTDisplay::sdlLoop()
@@ -1505,14 +1525,34 @@ bool TFTDisplay::connect()
 #endif
     tft->fillScreen(TFT_BLACK);
 
-    if (this->linePixelBuffer == NULL) {
-        this->linePixelBuffer = (uint16_t *)malloc(sizeof(uint16_t) * displayWidth);
-
-        if (!this->linePixelBuffer) {
-            LOG_ERROR("Not enough memory to create TFT line buffer\n");
-            return false;
+    // A page (8 rows) of the buffer per transfer.  On the SDL panel every write is a texture update, so the frame goes
+    // as one rectangle there instead.
+    flushPages = 1;
+#if ARCH_PORTDUINO
+    if (portduino_config.displayPanel == x11)
+        flushPages = (displayHeight + 7) / 8;
+#endif
+    size_t flushBufferSize = sizeof(uint16_t) * displayWidth * 8 * flushPages;
+#if !defined(HACKADAY_COMMUNICATOR) && !defined(TFT_SYNC_FLUSH)
+    const int buffers = 2; // Ping-pong: one is converted into while the other is sent
+#else
+    const int buffers = 1;
+#endif
+    for (int i = 0; i < buffers; i++) {
+        if (this->flushBuffer[i] == NULL) {
+#ifdef ARCH_ESP32
+            // Not in PSRAM, the SPI DMA can't read it
+            this->flushBuffer[i] = (uint16_t *)heap_caps_malloc(flushBufferSize, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+#else
+            this->flushBuffer[i] = (uint16_t *)malloc(flushBufferSize);
+#endif
+            if (!this->flushBuffer[i] && i == 0) {
+                LOG_ERROR("Not enough memory to create TFT flush buffer\n");
+                return false;
+            }
         }
     }
+    flushStats.sinceMs = millis();
     return true;
 }
 
@@ -3,11 +3,18 @@
 #include <GpioLogic.h>
 #include <OLEDDisplay.h>
 
+// How often TFTDisplay logs how long its flushes take
+#ifndef TFT_FLUSH_STATS_INTERVAL_MS
+#define TFT_FLUSH_STATS_INTERVAL_MS (60 * 1000)
+#endif
+
 /**
  * An adapter class that allows using the LovyanGFX library as if it was an OLEDDisplay implementation.
  *
+ * display() sends only the rectangles that changed, a page (8 rows) at a time, from a pair of buffers: with LovyanGFX
+ * one is sent by DMA while the next is filled.
+ *
  * Remaining TODO:
- * optimize display() to only draw changed pixels (see other OLED subclasses for examples)
  * Use the fast NRF52 SPI API rather than the slow standard arduino version
  *
  * turn radio back on - currently with both on spi bus is fucked? or are we leaving chip select asserted?
@@ -62,5 +69,17 @@ class TFTDisplay : public OLEDDisplay
     // Connect to the display
     virtual bool connect() override;
 
-    uint16_t *linePixelBuffer = nullptr;
+    // Rectangles converted to display pixels, ready to send. The second only where they can be sent by DMA.
+    uint16_t *flushBuffer[2] = {nullptr, nullptr};
+
+    // Pages of the buffer (8 rows each) sent as one rectangle
+    uint32_t flushPages = 1;
+
+    struct FlushStats {
+        uint32_t frames = 0;
+        uint64_t totalUs = 0;
+        uint32_t maxUs = 0;
+        uint64_t pixels = 0;
+        uint32_t sinceMs = 0;
+    } flushStats;
 };
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "main.h"
 #include "meshUtils.h"
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // External declarations
@@ -36,6 +37,29 @@ static std::vector<std::string> cachedLines;
 static std::vector<int> cachedHeights;
 static bool manualScrolling = false;
 
+// The rest of the layout, line by line alongside cachedLines
+static std::vector<bool> cachedIsMine;
+static std::vector<bool> cachedIsHeader;
+static std::vector<AckStatus> cachedAck;
+static std::vector<int> cachedWidths; // rendered width of the lines drawn right-aligned or underlined, else 0
+
+// What the layout was built from. The headers show how long ago each message was sent, so they are rebuilt at least
+// every MESSAGE_LAYOUT_MAX_AGE_MS, which only costs the headers: the wrapped text comes from wrapCache.
+#define MESSAGE_LAYOUT_MAX_AGE_MS 1000
+static bool layoutValid = false;
+static size_t layoutCount = 0;
+static uint32_t layoutFirstId = 0, layoutLastId = 0;
+static uint32_t layoutAtMs = 0;
+
+// Message text wrapped to a width, by message id.  Only the messages of the last layout are kept.
+struct WrappedMessage {
+    uint16_t textOffset;
+    uint16_t textLength;
+    int width;
+    std::vector<std::string> lines;
+};
+static std::unordered_map<uint32_t, WrappedMessage> wrapCache;
+
 // UTF-8 skip helper
 static inline size_t utf8CharLen(uint8_t c)
 {
@@ -285,6 +309,12 @@ void clearMessageCache()
 {
     std::vector<std::string>().swap(cachedLines);
     std::vector<int>().swap(cachedHeights);
+    std::vector<bool>().swap(cachedIsMine);
+    std::vector<bool>().swap(cachedIsHeader);
+    std::vector<AckStatus>().swap(cachedAck);
+    std::vector<int>().swap(cachedWidths);
+    std::unordered_map<uint32_t, WrappedMessage>().swap(wrapCache);
+    layoutValid = false;
 
     // Reset scroll so we rebuild cleanly next time we enter the screen
     resetScrollState();
@@ -312,7 +342,8 @@ void setThreadMode(ThreadMode mode, int channel /* = -1 */, uint32_t peer /* = 0
     currentMode = mode;
     currentChannel = channel;
     currentPeer = peer;
-    didReset = false; // force reset when mode changes
+    didReset = false;    // force reset when mode changes
+    layoutValid = false; // and lay out the new thread
 
     // Track channels we’ve seen
     if (mode == ThreadMode::CHANNEL && channel >= 0) {
@@ -439,21 +470,11 @@ static void drawMessageScrollbar(OLEDDisplay *display, int visibleHeight, int to
     }
 }
 
-void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
+/// Lay out the messages of the current thread into cachedLines and the vectors alongside
+static void buildLayout(OLEDDisplay *display, int leftTextWidth, int rightTextWidth)
 {
-    // Ensure any boot-relative timestamps are upgraded if RTC is valid
-    messageStore.upgradeBootRelativeTimestamps();
-
-    if (!didReset) {
-        resetScrollState();
-        didReset = true;
-    }
-
-    // Clear the unread message indicator when viewing the message
-    hasUnreadMessage = false;
-
     // Filter messages based on thread mode
-    std::deque<StoredMessage> filtered;
+    std::vector<const StoredMessage *> filtered;
     for (const auto &m : messageStore.getLiveMessages()) {
         bool include = false;
         switch (currentMode) {
@@ -470,68 +491,7 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
             break;
         }
         if (include)
-            filtered.push_back(m);
-    }
-
-    display->clear();
-    display->setTextAlignment(TEXT_ALIGN_LEFT);
-    display->setFont(FONT_SMALL);
-    const int navHeight = FONT_HEIGHT_SMALL;
-    const int scrollBottom = SCREEN_HEIGHT - navHeight;
-    const int usableHeight = scrollBottom;
-    constexpr int LEFT_MARGIN = 2;
-    constexpr int RIGHT_MARGIN = 2;
-    constexpr int SCROLLBAR_WIDTH = 3;
-
-    const int leftTextWidth = SCREEN_WIDTH - LEFT_MARGIN - RIGHT_MARGIN;
-
-    const int rightTextWidth = SCREEN_WIDTH - LEFT_MARGIN - RIGHT_MARGIN - SCROLLBAR_WIDTH;
-
-    // Title string depending on mode
-    static char titleBuf[32];
-    const char *titleStr = "Messages";
-    switch (currentMode) {
-    case ThreadMode::ALL:
-        titleStr = "Messages";
-        break;
-    case ThreadMode::CHANNEL: {
-        const char *cname = channels.getName(currentChannel);
-        if (cname && cname[0]) {
-            snprintf(titleBuf, sizeof(titleBuf), "#%s", cname);
-        } else {
-            snprintf(titleBuf, sizeof(titleBuf), "Ch%d", currentChannel);
-        }
-        titleStr = titleBuf;
-        break;
-    }
-    case ThreadMode::DIRECT: {
-        meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(currentPeer);
-        if (node && node->has_user) {
-            snprintf(titleBuf, sizeof(titleBuf), "@%s", node->user.short_name);
-        } else {
-            snprintf(titleBuf, sizeof(titleBuf), "@%08x", currentPeer);
-        }
-        titleStr = titleBuf;
-        break;
-    }
-    }
-
-    if (filtered.empty()) {
-        // If current conversation is empty go back to ALL view
-        if (currentMode != ThreadMode::ALL) {
-            setThreadMode(ThreadMode::ALL);
-            resetScrollState();
-            return; // Next draw will rerun in ALL mode
-        }
-
-        // Still in ALL mode and no messages at all → show placeholder
-        graphics::drawCommonHeader(display, x, y, titleStr);
-        didReset = false;
-        const char *messageString = "No messages";
-        int center_text = (SCREEN_WIDTH / 2) - (display->getStringWidth(messageString) / 2);
-        display->drawString(center_text, getTextPositions(display)[2], messageString);
-        graphics::drawCommonFooter(display, x, y);
-        return;
+            filtered.push_back(&m);
     }
 
     // Build lines for filtered messages (newest first)
@@ -539,9 +499,10 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
     std::vector<bool> isMine;   // track alignment
     std::vector<bool> isHeader; // track header lines
     std::vector<AckStatus> ackForLine;
+    std::unordered_map<uint32_t, WrappedMessage> wrapped;
 
     for (auto it = filtered.rbegin(); it != filtered.rend(); ++it) {
-        const auto &m = *it;
+        const auto &m = **it;
 
         // Channel / destination labeling
         char chanType[32] = "";
@@ -651,11 +612,17 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
         isHeader.push_back(true);
         ackForLine.push_back(m.ackStatus);
 
-        const char *msgText = MessageStore::getText(m);
-
+        // Wrap the text, unless it was already wrapped to this width
         int wrapWidth = mine ? rightTextWidth : leftTextWidth;
-        std::vector<std::string> wrapped = generateLines(display, "", msgText, wrapWidth);
-        for (auto &ln : wrapped) {
+        auto cached = wrapCache.find(m.id);
+        if (cached != wrapCache.end() && cached->second.textOffset == m.textOffset &&
+            cached->second.textLength == m.textLength && cached->second.width == wrapWidth) {
+            wrapped[m.id] = std::move(cached->second);
+        } else {
+            const char *msgText = MessageStore::getText(m);
+            wrapped[m.id] = {m.textOffset, m.textLength, wrapWidth, generateLines(display, "", msgText, wrapWidth)};
+        }
+        for (auto &ln : wrapped[m.id].lines) {
             allLines.push_back(ln);
             isMine.push_back(mine);
             isHeader.push_back(false);
@@ -664,8 +631,110 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
     }
 
     // Cache lines and heights
-    cachedLines = allLines;
+    cachedLines = std::move(allLines);
     cachedHeights = calculateLineHeights(cachedLines, emotes, isHeader);
+    cachedIsMine = std::move(isMine);
+    cachedIsHeader = std::move(isHeader);
+    cachedAck = std::move(ackForLine);
+    wrapCache = std::move(wrapped);
+
+    // Measure what is drawn right-aligned or underlined now, not on every frame
+    cachedWidths.assign(cachedLines.size(), 0);
+    for (size_t i = 0; i < cachedLines.size(); ++i) {
+        if (cachedIsHeader[i])
+            cachedWidths[i] = display->getStringWidth(cachedLines[i].c_str());
+        else if (cachedIsMine[i])
+            cachedWidths[i] = getRenderedLineWidth(display, cachedLines[i], emotes, numEmotes);
+    }
+
+    const auto &live = messageStore.getLiveMessages();
+    layoutCount = live.size();
+    layoutFirstId = live.empty() ? 0 : live.front().id;
+    layoutLastId = live.empty() ? 0 : live.back().id;
+    layoutAtMs = millis();
+    layoutValid = true;
+}
+
+void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
+{
+    // Ensure any boot-relative timestamps are upgraded if RTC is valid
+    messageStore.upgradeBootRelativeTimestamps();
+
+    if (!didReset) {
+        resetScrollState();
+        didReset = true;
+    }
+
+    // Clear the unread message indicator when viewing the message
+    hasUnreadMessage = false;
+
+    display->clear();
+    display->setTextAlignment(TEXT_ALIGN_LEFT);
+    display->setFont(FONT_SMALL);
+    const int navHeight = FONT_HEIGHT_SMALL;
+    const int scrollBottom = SCREEN_HEIGHT - navHeight;
+    const int usableHeight = scrollBottom;
+    constexpr int LEFT_MARGIN = 2;
+    constexpr int RIGHT_MARGIN = 2;
+    constexpr int SCROLLBAR_WIDTH = 3;
+
+    const int leftTextWidth = SCREEN_WIDTH - LEFT_MARGIN - RIGHT_MARGIN;
+
+    const int rightTextWidth = SCREEN_WIDTH - LEFT_MARGIN - RIGHT_MARGIN - SCROLLBAR_WIDTH;
+
+    // Title string depending on mode
+    static char titleBuf[32];
+    const char *titleStr = "Messages";
+    switch (currentMode) {
+    case ThreadMode::ALL:
+        titleStr = "Messages";
+        break;
+    case ThreadMode::CHANNEL: {
+        const char *cname = channels.getName(currentChannel);
+        if (cname && cname[0]) {
+            snprintf(titleBuf, sizeof(titleBuf), "#%s", cname);
+        } else {
+            snprintf(titleBuf, sizeof(titleBuf), "Ch%d", currentChannel);
+        }
+        titleStr = titleBuf;
+        break;
+    }
+    case ThreadMode::DIRECT: {
+        meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(currentPeer);
+        if (node && node->has_user) {
+            snprintf(titleBuf, sizeof(titleBuf), "@%s", node->user.short_name);
+        } else {
+            snprintf(titleBuf, sizeof(titleBuf), "@%08x", currentPeer);
+        }
+        titleStr = titleBuf;
+        break;
+    }
+    }
+
+    // Rebuild the layout only when the messages, the thread, or the times in the headers may have changed
+    const auto &live = messageStore.getLiveMessages();
+    bool sameMessages = live.size() == layoutCount &&
+                        (live.empty() || (live.front().id == layoutFirstId && live.back().id == layoutLastId));
+    if (!layoutValid || !sameMessages || millis() - layoutAtMs >= MESSAGE_LAYOUT_MAX_AGE_MS)
+        buildLayout(display, leftTextWidth, rightTextWidth);
+
+    if (cachedLines.empty()) {
+        // If current conversation is empty go back to ALL view
+        if (currentMode != ThreadMode::ALL) {
+            setThreadMode(ThreadMode::ALL);
+            resetScrollState();
+            return; // Next draw will rerun in ALL mode
+        }
+
+        // Still in ALL mode and no messages at all → show placeholder
+        graphics::drawCommonHeader(display, x, y, titleStr);
+        didReset = false;
+        const char *messageString = "No messages";
+        int center_text = (SCREEN_WIDTH / 2) - (display->getStringWidth(messageString) / 2);
+        display->drawString(center_text, getTextPositions(display)[2], messageString);
+        graphics::drawCommonFooter(display, x, y);
+        return;
+    }
 
     // Scrolling logic (unchanged)
     int totalHeight = 0;
@@ -716,17 +785,14 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
     int yOffset = -finalScroll + getTextPositions(display)[1];
 
     // Render visible lines
-    for (size_t i = 0; i < cachedLines.size(); ++i) {
-        int lineY = yOffset;
-        for (size_t j = 0; j < i; ++j)
-            lineY += cachedHeights[j];
-
-        if (lineY > -cachedHeights[i] && lineY < scrollBottom) {
-            if (isHeader[i]) {
+    int lineY = yOffset;
+    for (size_t i = 0; i < cachedLines.size() && lineY < scrollBottom; lineY += cachedHeights[i], ++i) {
+        if (lineY > -cachedHeights[i]) {
+            if (cachedIsHeader[i]) {
 
-                int w = display->getStringWidth(cachedLines[i].c_str());
+                int w = cachedWidths[i];
                 int headerX;
-                if (isMine[i]) {
+                if (cachedIsMine[i]) {
                     // push header left to avoid overlap with scrollbar
                     headerX = SCREEN_WIDTH - w - SCROLLBAR_WIDTH - RIGHT_MARGIN;
                     if (headerX < LEFT_MARGIN)
@@ -737,16 +803,16 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
                 display->drawString(headerX, lineY, cachedLines[i].c_str());
 
                 // Draw ACK/NACK mark for our own messages
-                if (isMine[i]) {
+                if (cachedIsMine[i]) {
                     int markX = headerX - 10;
                     int markY = lineY;
-                    if (ackForLine[i] == AckStatus::ACKED) {
+                    if (cachedAck[i] == AckStatus::ACKED) {
                         // Destination ACK
                         drawCheckMark(display, markX, markY, 8);
-                    } else if (ackForLine[i] == AckStatus::NACKED || ackForLine[i] == AckStatus::TIMEOUT) {
+                    } else if (cachedAck[i] == AckStatus::NACKED || cachedAck[i] == AckStatus::TIMEOUT) {
                         // Failure or timeout
                         drawXMark(display, markX, markY, 8);
-                    } else if (ackForLine[i] == AckStatus::RELAYED) {
+                    } else if (cachedAck[i] == AckStatus::RELAYED) {
                         // Relay ACK
                         drawRelayMark(display, markX, markY, 8);
                     }
@@ -760,9 +826,9 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
                 }
             } else {
                 // Render message line
-                if (isMine[i]) {
+                if (cachedIsMine[i]) {
                     // Calculate actual rendered width including emotes
-                    int renderedWidth = getRenderedLineWidth(display, cachedLines[i], emotes, numEmotes);
+                    int renderedWidth = cachedWidths[i];
                     int rightX = SCREEN_WIDTH - renderedWidth - SCROLLBAR_WIDTH - RIGHT_MARGIN;
                     if (rightX < LEFT_MARGIN)
                         rightX = LEFT_MARGIN;
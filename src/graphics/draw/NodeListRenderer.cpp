@@ -200,25 +200,17 @@ void drawScrollbar(OLEDDisplay *display, int visibleNodeRows, int totalEntries,
 }
 
 // =============================
-// Entry Renderers
+// Row Cache
 // =============================
 
-void drawEntryLastHeard(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth)
+static void formatLastHeard(const meshtastic_NodeInfoLite *node, char *timeStr, size_t len)
 {
-    bool isLeftCol = (x < SCREEN_WIDTH / 2);
-    int nameMaxWidth = columnWidth - 25;
-    int timeOffset = (currentResolution == ScreenResolution::High) ? (isLeftCol ? 7 : 10) : (isLeftCol ? 3 : 7);
-
-    const char *nodeName = getSafeNodeName(display, node, columnWidth);
-    bool isMuted = (node->bitfield & NODEINFO_BITFIELD_IS_MUTED_MASK) != 0;
-
-    char timeStr[10];
     uint32_t seconds = sinceLastSeen(node);
     if (seconds == 0 || seconds == UINT32_MAX) {
-        snprintf(timeStr, sizeof(timeStr), "?");
+        snprintf(timeStr, len, "?");
     } else {
         uint32_t minutes = seconds / 60, hours = minutes / 60, days = hours / 24;
-        snprintf(timeStr, sizeof(timeStr), (days > 365 ? "?" : "%d%c"),
+        snprintf(timeStr, len, (days > 365 ? "?" : "%d%c"),
                  (days    ? days
                   : hours ? hours
                           : minutes),
@@ -226,6 +218,172 @@ void drawEntryLastHeard(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int
                   : hours ? 'h'
                           : 'm'));
     }
+}
+
+static void formatDistance(const meshtastic_NodeInfoLite *ourNode, const meshtastic_NodeInfoLite *node, char *distStr, size_t len)
+{
+    distStr[0] = '\0';
+    if (nodeDB->hasValidPosition(ourNode) && nodeDB->hasValidPosition(node)) {
+        double lat1 = ourNode->position.latitude_i * 1e-7;
+        double lon1 = ourNode->position.longitude_i * 1e-7;
+        double lat2 = node->position.latitude_i * 1e-7;
+        double lon2 = node->position.longitude_i * 1e-7;
+
+        double earthRadiusKm = 6371.0;
+        double dLat = (lat2 - lat1) * DEG_TO_RAD;
+        double dLon = (lon2 - lon1) * DEG_TO_RAD;
+
+        double a =
+            sin(dLat / 2) * sin(dLat / 2) + cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) * sin(dLon / 2) * sin(dLon / 2);
+        double c = 2 * atan2(sqrt(a), sqrt(1 - a));
+        double distanceKm = earthRadiusKm * c;
+
+        if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
+            double miles = distanceKm * 0.621371;
+            if (miles < 0.1) {
+                int feet = (int)(miles * 5280);
+                if (feet < 1000)
+                    snprintf(distStr, len, "%dft", feet);
+                else
+                    snprintf(distStr, len, "¼mi"); // 4-char max
+            } else {
+                int roundedMiles = (int)(miles + 0.5);
+                if (roundedMiles < 1000)
+                    snprintf(distStr, len, "%dmi", roundedMiles);
+                else
+                    snprintf(distStr, len, "999"); // Max display cap
+            }
+        } else {
+            if (distanceKm < 1.0) {
+                int meters = (int)(distanceKm * 1000);
+                if (meters < 1000)
+                    snprintf(distStr, len, "%dm", meters);
+                else
+                    snprintf(distStr, len, "1k");
+            } else {
+                int km = (int)(distanceKm + 0.5);
+                if (km < 1000)
+                    snprintf(distStr, len, "%dk", km);
+                else
+                    snprintf(distStr, len, "999");
+            }
+        }
+    }
+}
+
+/**
+ * What drawNodeListScreen() shows, kept between frames: which nodes are listed, and the formatted rows of the page on
+ * screen.  The list is rebuilt when the NodeDB changes, the rows also when the page, layout or our position changes,
+ * and at least every NODELIST_ROW_MAX_AGE_MS so "last heard" keeps counting.  A frame then only draws.
+ */
+#define NODELIST_ROW_MAX_AGE_MS 1000
+
+static struct {
+    // The filtered, ordered list
+    std::vector<uint32_t> drawList;
+    bool listValid = false;
+    bool locationScreen = false;
+    uint32_t listChangeCount = 0;
+
+    // Rows of the page on screen
+    std::vector<NodeRow> rows;
+    bool rowsValid = false;
+    int rowsStart = 0;
+    int rowsColumnWidth = 0;
+    bool rowsLongNames = false;
+    double rowsLat = 0, rowsLon = 0;
+    uint32_t rowsChangeCount = 0;
+    uint32_t rowsAtMs = 0;
+} view;
+
+static const std::vector<uint32_t> &getDrawList(bool locationScreen)
+{
+    if (view.listValid && view.locationScreen == locationScreen && view.listChangeCount == nodeDB->getChangeCount())
+        return view.drawList;
+
+    view.drawList.clear();
+    int totalEntries = nodeDB->getNumMeshNodes();
+    view.drawList.reserve(totalEntries);
+    for (int i = 0; i < totalEntries; i++) {
+        auto *n = nodeDB->getMeshNodeByIndex(i);
+
+        if (!n)
+            continue;
+        if (n->num == nodeDB->getNodeNum())
+            continue;
+        if (locationScreen && !n->has_position)
+            continue;
+
+        view.drawList.push_back(n->num);
+    }
+    view.locationScreen = locationScreen;
+    view.listChangeCount = nodeDB->getChangeCount();
+    view.listValid = true;
+    view.rowsValid = false;
+    return view.drawList;
+}
+
+/// Format the rows from startIndex to endIndex of the list, unless they still are
+static void updateRows(OLEDDisplay *display, const std::vector<uint32_t> &drawList, int startIndex, int endIndex,
+                       int columnWidth, double lat, double lon)
+{
+    uint32_t now = millis();
+    if (view.rowsValid && view.rowsStart == startIndex && (int)view.rows.size() == endIndex - startIndex &&
+        view.rowsColumnWidth == columnWidth && view.rowsLongNames == config.display.use_long_node_name && view.rowsLat == lat &&
+        view.rowsLon == lon && view.rowsChangeCount == nodeDB->getChangeCount() && now - view.rowsAtMs < NODELIST_ROW_MAX_AGE_MS)
+        return;
+
+    meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
+    bool haveOurPosition = ourNode && nodeDB->hasValidPosition(ourNode);
+
+    // getSafeNodeName() measures with the current font
+    display->setFont(FONT_SMALL);
+
+    view.rows.resize(endIndex - startIndex);
+    for (int idx = startIndex; idx < endIndex; idx++) {
+        NodeRow &row = view.rows[idx - startIndex];
+        auto *node = nodeDB->getMeshNode(drawList[idx]);
+        row.num = drawList[idx];
+        row.bearing = NAN;
+        row.distStr[0] = '\0';
+        if (!node) {
+            row.name[0] = row.timeStr[0] = '\0';
+            continue;
+        }
+
+        snprintf(row.name, sizeof(row.name), "%s", getSafeNodeName(display, node, columnWidth));
+        formatLastHeard(node, row.timeStr, sizeof(row.timeStr));
+        if (view.locationScreen && haveOurPosition && nodeDB->hasValidPosition(node)) {
+            formatDistance(ourNode, node, row.distStr, sizeof(row.distStr));
+            row.bearing = RAD_TO_DEG * GeoCoord::bearing(lat, lon, node->position.latitude_i * 1e-7,
+                                                         node->position.longitude_i * 1e-7);
+        }
+    }
+
+    view.rowsStart = startIndex;
+    view.rowsColumnWidth = columnWidth;
+    view.rowsLongNames = config.display.use_long_node_name;
+    view.rowsLat = lat;
+    view.rowsLon = lon;
+    view.rowsChangeCount = nodeDB->getChangeCount();
+    view.rowsAtMs = now;
+    view.rowsValid = true;
+}
+
+// =============================
+// Entry Renderers
+// =============================
+
+void drawEntryLastHeard(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                        int columnWidth)
+{
+    bool isLeftCol = (x < SCREEN_WIDTH / 2);
+    int nameMaxWidth = columnWidth - 25;
+    int timeOffset = (currentResolution == ScreenResolution::High) ? (isLeftCol ? 7 : 10) : (isLeftCol ? 3 : 7);
+
+    const char *nodeName = row.name;
+    const char *timeStr = row.timeStr;
+    bool isMuted = (node->bitfield & NODEINFO_BITFIELD_IS_MUTED_MASK) != 0;
 
     display->setTextAlignment(TEXT_ALIGN_LEFT);
     display->setFont(FONT_SMALL);
@@ -252,7 +410,8 @@ void drawEntryLastHeard(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int
     display->drawString(rightEdge - textWidth, y, timeStr);
 }
 
-void drawEntryHopSignal(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth)
+void drawEntryHopSignal(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                        int columnWidth)
 {
     bool isLeftCol = (x < SCREEN_WIDTH / 2);
 
@@ -262,7 +421,7 @@ void drawEntryHopSignal(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int
 
     int barsXOffset = columnWidth - barsOffset;
 
-    const char *nodeName = getSafeNodeName(display, node, columnWidth);
+    const char *nodeName = row.name;
     bool isMuted = (node->bitfield & NODEINFO_BITFIELD_IS_MUTED_MASK) != 0;
 
     display->setTextAlignment(TEXT_ALIGN_LEFT);
@@ -309,63 +468,16 @@ void drawEntryHopSignal(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int
     }
 }
 
-void drawNodeDistance(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth)
+void drawNodeDistance(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                      int columnWidth)
 {
     bool isLeftCol = (x < SCREEN_WIDTH / 2);
     int nameMaxWidth =
         columnWidth - ((currentResolution == ScreenResolution::High) ? (isLeftCol ? 25 : 28) : (isLeftCol ? 20 : 22));
 
-    const char *nodeName = getSafeNodeName(display, node, columnWidth);
+    const char *nodeName = row.name;
+    const char *distStr = row.distStr;
     bool isMuted = (node->bitfield & NODEINFO_BITFIELD_IS_MUTED_MASK) != 0;
-    char distStr[10] = "";
-
-    meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
-    if (nodeDB->hasValidPosition(ourNode) && nodeDB->hasValidPosition(node)) {
-        double lat1 = ourNode->position.latitude_i * 1e-7;
-        double lon1 = ourNode->position.longitude_i * 1e-7;
-        double lat2 = node->position.latitude_i * 1e-7;
-        double lon2 = node->position.longitude_i * 1e-7;
-
-        double earthRadiusKm = 6371.0;
-        double dLat = (lat2 - lat1) * DEG_TO_RAD;
-        double dLon = (lon2 - lon1) * DEG_TO_RAD;
-
-        double a =
-            sin(dLat / 2) * sin(dLat / 2) + cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) * sin(dLon / 2) * sin(dLon / 2);
-        double c = 2 * atan2(sqrt(a), sqrt(1 - a));
-        double distanceKm = earthRadiusKm * c;
-
-        if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
-            double miles = distanceKm * 0.621371;
-            if (miles < 0.1) {
-                int feet = (int)(miles * 5280);
-                if (feet < 1000)
-                    snprintf(distStr, sizeof(distStr), "%dft", feet);
-                else
-                    snprintf(distStr, sizeof(distStr), "¼mi"); // 4-char max
-            } else {
-                int roundedMiles = (int)(miles + 0.5);
-                if (roundedMiles < 1000)
-                    snprintf(distStr, sizeof(distStr), "%dmi", roundedMiles);
-                else
-                    snprintf(distStr, sizeof(distStr), "999"); // Max display cap
-            }
-        } else {
-            if (distanceKm < 1.0) {
-                int meters = (int)(distanceKm * 1000);
-                if (meters < 1000)
-                    snprintf(distStr, sizeof(distStr), "%dm", meters);
-                else
-                    snprintf(distStr, sizeof(distStr), "1k");
-            } else {
-                int km = (int)(distanceKm + 0.5);
-                if (km < 1000)
-                    snprintf(distStr, sizeof(distStr), "%dk", km);
-                else
-                    snprintf(distStr, sizeof(distStr), "999");
-            }
-        }
-    }
 
     display->setTextAlignment(TEXT_ALIGN_LEFT);
     display->setFont(FONT_SMALL);
@@ -395,21 +507,23 @@ void drawNodeDistance(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16
     }
 }
 
-void drawEntryDynamic_Nodes(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth)
+void drawEntryDynamic_Nodes(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                            int columnWidth)
 {
     switch (currentMode_Nodes) {
     case MODE_LAST_HEARD:
-        drawEntryLastHeard(display, node, x, y, columnWidth);
+        drawEntryLastHeard(display, node, row, x, y, columnWidth);
         break;
     case MODE_HOP_SIGNAL:
-        drawEntryHopSignal(display, node, x, y, columnWidth);
+        drawEntryHopSignal(display, node, row, x, y, columnWidth);
         break;
     default:
         break;
     }
 }
 
-void drawEntryCompass(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth)
+void drawEntryCompass(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                      int columnWidth)
 {
     bool isLeftCol = (x < SCREEN_WIDTH / 2);
 
@@ -417,7 +531,7 @@ void drawEntryCompass(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16
     int nameMaxWidth =
         columnWidth - ((currentResolution == ScreenResolution::High) ? (isLeftCol ? 25 : 28) : (isLeftCol ? 20 : 22));
 
-    const char *nodeName = getSafeNodeName(display, node, columnWidth);
+    const char *nodeName = row.name;
     bool isMuted = (node->bitfield & NODEINFO_BITFIELD_IS_MUTED_MASK) != 0;
 
     display->setTextAlignment(TEXT_ALIGN_LEFT);
@@ -439,10 +553,10 @@ void drawEntryCompass(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16
     }
 }
 
-void drawCompassArrow(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth, float myHeading,
-                      double userLat, double userLon)
+void drawCompassArrow(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                      int columnWidth, float myHeading)
 {
-    if (!nodeDB->hasValidPosition(node))
+    if (!nodeDB->hasValidPosition(node) || isnan(row.bearing))
         return;
 
     bool isLeftCol = (x < SCREEN_WIDTH / 2);
@@ -451,11 +565,7 @@ void drawCompassArrow(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16
     int centerX = x + columnWidth - arrowXOffset;
     int centerY = y + FONT_HEIGHT_SMALL / 2;
 
-    double nodeLat = node->position.latitude_i * 1e-7;
-    double nodeLon = node->position.longitude_i * 1e-7;
-    float bearing = GeoCoord::bearing(userLat, userLon, nodeLat, nodeLon);
-    float bearingToNode = RAD_TO_DEG * bearing;
-    float relativeBearing = fmod((bearingToNode - myHeading + 360), 360);
+    float relativeBearing = fmod((row.bearing - myHeading + 360), 360);
     // Shrink size by 2px
     int size = FONT_HEIGHT_SMALL - 5;
     CompassRenderer::drawArrowToNode(display, centerX, centerY, size, relativeBearing);
@@ -531,27 +641,13 @@ void drawNodeListScreen(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t
 
     int columnWidth = display->getWidth() / totalColumns;
 
-    int totalEntries = nodeDB->getNumMeshNodes();
     int totalRowsAvailable = (display->getHeight() - y) / rowYOffset;
     int numskipped = 0;
     int visibleNodeRows = totalRowsAvailable;
 
-    // Build filtered + ordered list
-    std::vector<int> drawList;
-    drawList.reserve(totalEntries);
-    for (int i = 0; i < totalEntries; i++) {
-        auto *n = nodeDB->getMeshNodeByIndex(i);
-
-        if (!n)
-            continue;
-        if (n->num == nodeDB->getNodeNum())
-            continue;
-        if (locationScreen && !n->has_position)
-            continue;
-
-        drawList.push_back(n->num);
-    }
-    totalEntries = drawList.size();
+    // Filtered + ordered list, rebuilt only when the NodeDB changed
+    const std::vector<uint32_t> &drawList = getDrawList(locationScreen);
+    int totalEntries = drawList.size();
     int perPage = visibleNodeRows * totalColumns;
 
     int maxScroll = 0;
@@ -569,16 +665,21 @@ void drawNodeListScreen(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t
     int shownCount = 0;
     int rowCount = 0;
 
+    // Only the rows of this page are formatted, and only when something changed
+    updateRows(display, drawList, startIndex, endIndex, columnWidth, lat, lon);
+
     for (int idx = startIndex; idx < endIndex; idx++) {
-        uint32_t nodeNum = drawList[idx];
-        auto *node = nodeDB->getMeshNode(nodeNum);
+        const NodeRow &row = view.rows[idx - startIndex];
+        auto *node = nodeDB->getMeshNode(row.num);
         int xPos = x + (col * columnWidth);
         int yPos = y + yOffset;
 
-        renderer(display, node, xPos, yPos, columnWidth);
+        if (node) {
+            renderer(display, node, row, xPos, yPos, columnWidth);
 
-        if (extras)
-            extras(display, node, xPos, yPos, columnWidth, heading, lat, lon);
+            if (extras)
+                extras(display, node, row, xPos, yPos, columnWidth, heading);
+        }
 
         lastNodeY = std::max(lastNodeY, yPos + FONT_HEIGHT_SMALL);
         yOffset += rowYOffset;
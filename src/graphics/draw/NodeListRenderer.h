@@ -19,9 +19,18 @@ class Screen;
  */
 namespace NodeListRenderer
 {
+// A row of the list, formatted when the node or the page changes rather than on every frame
+struct NodeRow {
+    uint32_t num;
+    char name[25];    // getSafeNodeName() for the column width
+    char timeStr[10]; // time since last heard
+    char distStr[10]; // distance from our node, empty if either position is unknown
+    float bearing;    // degrees from the list's position to the node, NAN if unknown
+};
+
 // Entry renderer function types
-typedef void (*EntryRenderer)(OLEDDisplay *, meshtastic_NodeInfoLite *, int16_t, int16_t, int);
-typedef void (*NodeExtrasRenderer)(OLEDDisplay *, meshtastic_NodeInfoLite *, int16_t, int16_t, int, float, double, double);
+typedef void (*EntryRenderer)(OLEDDisplay *, meshtastic_NodeInfoLite *, const NodeRow &, int16_t, int16_t, int);
+typedef void (*NodeExtrasRenderer)(OLEDDisplay *, meshtastic_NodeInfoLite *, const NodeRow &, int16_t, int16_t, int, float);
 
 // Node list mode enumeration for Last Heard and Hop Signal views
 enum ListMode_Node { MODE_LAST_HEARD = 0, MODE_HOP_SIGNAL = 1, MODE_COUNT_NODE = 2 };
@@ -35,15 +44,20 @@ void drawNodeListScreen(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t
                         double lon = 0);
 
 // Entry renderers
-void drawEntryLastHeard(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth);
-void drawEntryHopSignal(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth);
-void drawNodeDistance(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth);
-void drawEntryDynamic_Nodes(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth);
-void drawEntryCompass(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth);
+void drawEntryLastHeard(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                        int columnWidth);
+void drawEntryHopSignal(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                        int columnWidth);
+void drawNodeDistance(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                      int columnWidth);
+void drawEntryDynamic_Nodes(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                            int columnWidth);
+void drawEntryCompass(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                      int columnWidth);
 
 // Extras renderers
-void drawCompassArrow(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16_t x, int16_t y, int columnWidth, float myHeading,
-                      double userLat, double userLon);
+void drawCompassArrow(OLEDDisplay *display, meshtastic_NodeInfoLite *node, const NodeRow &row, int16_t x, int16_t y,
+                      int columnWidth, float myHeading);
 
 // Screen frame functions
 void drawLastHeardScreen(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
@@ -57,6 +71,7 @@ void drawNodeListWithCompasses(OLEDDisplay *display, OLEDDisplayUiState *state,
 const char *getCurrentModeTitle_Nodes(int screenWidth);
 const char *getCurrentModeTitle_Location(int screenWidth);
 const char *getSafeNodeName(meshtastic_NodeInfoLite *node, int columnWidth);
+unsigned long getModeCycleIntervalMs();
 void drawColumns(OLEDDisplay *display, int16_t x, int16_t y, const char **fields);
 
 // Scrolling controls
@@ -0,0 +1,22 @@
+#include "./MemoryEInk.h"
+
+#ifdef MESHTASTIC_INCLUDE_NICHE_GRAPHICS
+
+using namespace NicheGraphics::Drivers;
+
+MemoryEInk::MemoryEInk(uint16_t width, uint16_t height) : EInk(width, height, (UpdateTypes)(FULL | FAST))
+{
+    // Same layout as the image buffer InkHUD allocates: rows padded to whole bytes
+    imageSize = (((width - 1) / 8) + 1) * height;
+    image = new uint8_t[imageSize]();
+}
+
+// Keep a copy of the new image. Nothing to wait for, so no polling either: busy() stays false
+void MemoryEInk::update(uint8_t *imageData, UpdateTypes type)
+{
+    memcpy(image, imageData, imageSize);
+    lastType = type;
+    updateCount++;
+}
+
+#endif // MESHTASTIC_INCLUDE_NICHE_GRAPHICS
@@ -0,0 +1,44 @@
+/*
+
+E-Ink display "driver" with no hardware behind it
+    - Keeps the latest image in RAM
+    - Updates complete immediately
+    - For running a NicheGraphics UI on a host: benchmarks, tests, headless native builds
+
+*/
+
+#pragma once
+
+#ifdef MESHTASTIC_INCLUDE_NICHE_GRAPHICS
+
+#include "configuration.h"
+
+#include "./EInk.h"
+
+namespace NicheGraphics::Drivers
+{
+class MemoryEInk : public EInk
+{
+  public:
+    MemoryEInk(uint16_t width, uint16_t height);
+    void begin(SPIClass *spi, uint8_t pin_dc, uint8_t pin_cs, uint8_t pin_busy, uint8_t pin_rst = -1) override {}
+    void update(uint8_t *imageData, UpdateTypes type) override;
+
+    const uint8_t *getImage() { return image; }          // Same layout as the image InkHUD passed in
+    uint32_t getImageSize() { return imageSize; }        // Bytes
+    uint32_t getUpdateCount() { return updateCount; }    // Updates since start
+    UpdateTypes getLastUpdateType() { return lastType; } // As passed to update()
+
+  protected:
+    bool isUpdateDone() override { return true; }
+
+  private:
+    uint8_t *image = nullptr;
+    uint32_t imageSize = 0;
+    uint32_t updateCount = 0;
+    UpdateTypes lastType = UNSPECIFIED;
+};
+
+} // namespace NicheGraphics::Drivers
+
+#endif // MESHTASTIC_INCLUDE_NICHE_GRAPHICS
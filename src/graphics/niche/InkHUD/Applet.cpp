@@ -12,6 +12,7 @@ InkHUD::AppletFont InkHUD::Applet::fontLarge; // General purpose fonts. Set in n
 InkHUD::AppletFont InkHUD::Applet::fontMedium;
 InkHUD::AppletFont InkHUD::Applet::fontSmall;
 constexpr float InkHUD::Applet::LOGO_ASPECT_RATIO; // Ratio of the Meshtastic logo
+bool InkHUD::Applet::bulkDrawing = true;
 
 InkHUD::Applet::Applet() : GFX(0, 0)
 {
@@ -35,6 +36,86 @@ void InkHUD::Applet::drawPixel(int16_t x, int16_t y, uint16_t color)
         assignedTile->handleAppletPixel(x, y, (Color)color);
 }
 
+// Draw a filled rectangle
+// AdafruitGFX would break this into lines, and the lines into pixels, each cropped on its own
+// Instead, crop once, and let the renderer fill the rect a byte at a time
+void InkHUD::Applet::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    // AdafruitGFX has its own ideas about negative sizes (nothing for w, an odd line for h): leave those to it
+    if (!bulkDrawing || w <= 0 || h <= 0) {
+        GFX::fillRect(x, y, w, h, color);
+        return;
+    }
+
+    // Only render the part which falls within user's cropped region
+    int16_t x2 = min((int16_t)(x + w), (int16_t)(cropLeft + cropWidth));
+    int16_t y2 = min((int16_t)(y + h), (int16_t)(cropTop + cropHeight));
+    x = max(x, cropLeft);
+    y = max(y, cropTop);
+
+    if (x < x2 && y < y2)
+        assignedTile->handleAppletRect(x, y, x2 - x, y2 - y, (Color)color);
+}
+
+void InkHUD::Applet::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    if (bulkDrawing && w > 0)
+        fillRect(x, y, w, 1, color);
+    else
+        GFX::drawFastHLine(x, y, w, color);
+}
+
+void InkHUD::Applet::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    if (bulkDrawing && h > 0)
+        fillRect(x, y, 1, h, color);
+    else
+        GFX::drawFastVLine(x, y, h, color);
+}
+
+// Print a single character
+// For GFX fonts, each row of the glyph is drawn as runs of set pixels, rather than passing every pixel through drawPixel
+// Anything else (newlines, built-in font, wrapping, missing glyphs) is left to AdafruitGFX
+size_t InkHUD::Applet::write(uint8_t c)
+{
+    const GFXfont *font = currentFont.gfxFont;
+    if (!bulkDrawing || !font || wrap || c == '\n' || c == '\r' || c < pgm_read_word(&font->first) ||
+        c > pgm_read_word(&font->last))
+        return GFX::write(c);
+
+    const GFXglyph *glyph = &font->glyph[c - pgm_read_word(&font->first)];
+    const uint8_t *bitmap = font->bitmap + pgm_read_word(&glyph->bitmapOffset);
+    uint8_t glyphW = pgm_read_byte(&glyph->width);
+    uint8_t glyphH = pgm_read_byte(&glyph->height);
+    int16_t left = getCursorX() + (int8_t)pgm_read_byte(&glyph->xOffset);
+    int16_t top = getCursorY() + (int8_t)pgm_read_byte(&glyph->yOffset);
+
+    // Glyph bitmaps are packed: rows are not byte aligned
+    uint8_t bits = 0;
+    uint16_t bitNum = 0;
+    for (uint8_t row = 0; row < glyphH; row++) {
+        int16_t runStart = -1;
+        for (uint8_t col = 0; col < glyphW; col++, bitNum++) {
+            if (!(bitNum & 7))
+                bits = pgm_read_byte(bitmap + (bitNum / 8));
+            bool set = bits & 0x80;
+            bits <<= 1;
+
+            if (set && runStart < 0)
+                runStart = col;
+            else if (!set && runStart >= 0) {
+                fillRect(left + runStart, top + row, col - runStart, 1, textcolor);
+                runStart = -1;
+            }
+        }
+        if (runStart >= 0)
+            fillRect(left + runStart, top + row, glyphW - runStart, 1, textcolor);
+    }
+
+    setCursor(getCursorX() + pgm_read_byte(&glyph->xAdvance), getCursorY());
+    return 1;
+}
+
 // Link our applet to a tile
 // This can only be called by Tile::assignApplet
 // The tile determines the applets dimensions
@@ -60,16 +141,30 @@ void InkHUD::Applet::render()
     assert(assignedTile);                              // Ensure that we have a tile
     assert(assignedTile->getAssignedApplet() == this); // Ensure that we have a reciprocal link with the tile
 
+    // If we have nothing new to show, our tile may still have a copy of what we drew last time
+    // The highlight is drawn over the top of an applet (or cleared), so that always renders from scratch
+    bool highlighting = (Tile::highlightTarget == assignedTile);
+    bool reused = cacheRender && !wantRender && !highlighting && assignedTile->restoreRender();
+
     // WindowManager::update has now consumed the info about our update request
     // Clear everything for future requests
     wantRender = false;                                       // Flag set by requestUpdate
     wantAutoshow = false;                                     // Flag set by requestAutoShow. May or may not have been honored.
     wantUpdateType = Drivers::EInk::UpdateTypes::UNSPECIFIED; // Update type we wanted. May on may not have been granted.
 
+    if (reused)
+        return;
+
     updateDimensions();
     resetDrawingSpace();
     onRender(); // Derived applet's drawing takes place here
 
+    // Keep a copy for the tile to reuse, while we have nothing new to show
+    if (cacheRender && !highlighting)
+        assignedTile->saveRender();
+    else
+        assignedTile->discardRender();
+
     // Handle "Tile Highlighting"
     // Some devices may use an auxiliary button to switch between tiles
     // When this happens, we temporarily highlight the newly focused tile with a border
@@ -103,10 +103,18 @@ class Applet : public GFX
 
     static AppletFont fontSmall, fontMedium, fontLarge; // The general purpose fonts, used by all applets
 
+    static bool bulkDrawing; // Lines, rects and text as whole rects, not pixel by pixel. Off only to check it against the slow way
+
+    bool cacheRender = false; // Reuse our last render until we requestUpdate. Only if nothing but our own data changes what we draw
+
     const char *name = nullptr; // Shown in applet selection menu. Also used as an identifier by InkHUD::getSystemApplet
 
   protected:
     void drawPixel(int16_t x, int16_t y, uint16_t color) override; // Place a single pixel. All drawing output passes through here
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override; // Cropped once, not per pixel
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;       // As a 1px tall rect
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;       // As a 1px wide rect
+    size_t write(uint8_t c) override; // Blit GFX font glyphs as runs of pixels, not pixel by pixel
 
     void requestUpdate(EInk::UpdateTypes type = EInk::UpdateTypes::UNSPECIFIED); // Ask WindowManager to schedule a display update
     void requestAutoshow();                                                      // Ask for applet to be moved to foreground
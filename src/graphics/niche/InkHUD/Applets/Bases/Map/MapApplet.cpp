@@ -4,6 +4,9 @@
 
 using namespace NicheGraphics;
 
+// Length of a degree of latitude, on the sphere GeoCoord::latLongToMeter uses
+static constexpr float metersPerDegree = 6366000 * PI / 180;
+
 void InkHUD::MapApplet::onRender()
 {
     // Abort if no markers to render
@@ -32,20 +35,37 @@ void InkHUD::MapApplet::onRender()
 
     // Find center of map
     getMapCenter(&latCenter, &lngCenter);
-    calculateAllMarkers();
+    lngScale = cos(latCenter * DEG_TO_RAD);
     getMapSize(&widthMeters, &heightMeters);
     calculateMapScale();
+    clusterMarkers();
 
     // Draw all markers first
-    for (Marker m : markers) {
-        int16_t x = X(0.5) + (m.eastMeters * metersToPx);
-        int16_t y = Y(0.5) - (m.northMeters * metersToPx);
+    setFont(fontSmall);
+    for (const Cluster &c : clusters) {
+        int16_t x = c.x;
+        int16_t y = c.y;
 
-        // Add white halo outline first
+        // Marker box, with a halo outline
         constexpr int outlinePad = 1;
         int boxSize = 11;
         int radius = 2; // rounded corner radius
 
+        // Several nodes too close to tell apart: an outlined box, with how many
+        if (c.count > 1) {
+            char countStr[6];
+            if (c.count > 99)
+                strcpy(countStr, "99+");
+            else
+                snprintf(countStr, sizeof(countStr), "%u", (unsigned)c.count);
+            int boxWidth = max(boxSize, getTextWidth(countStr) + 4);
+
+            fillRoundedRect(x, y, boxWidth + (outlinePad * 2), boxSize + (outlinePad * 2), radius + 1, BLACK);
+            fillRoundedRect(x, y, boxWidth, boxSize, radius, WHITE);
+            printAt(x, y + 1, countStr, CENTER, MIDDLE);
+            continue;
+        }
+
         // White halo background
         fillRoundedRect(x, y, boxSize + (outlinePad * 2), boxSize + (outlinePad * 2), radius + 1, WHITE);
 
@@ -53,22 +73,20 @@ void InkHUD::MapApplet::onRender()
         fillRoundedRect(x, y, boxSize, boxSize, radius, BLACK);
 
         // Text inside
-        setFont(fontSmall);
         setTextColor(WHITE);
 
         // Draw actual marker on top
-        if (m.hasHopsAway && m.hopsAway > config.lora.hop_limit) {
+        if (c.hasHopsAway && c.hopsAway > config.lora.hop_limit) {
             printAt(x + 1, y + 1, "X", CENTER, MIDDLE);
-        } else if (!m.hasHopsAway) {
+        } else if (!c.hasHopsAway) {
             printAt(x + 1, y + 1, "?", CENTER, MIDDLE);
         } else {
             char hopStr[4];
-            snprintf(hopStr, sizeof(hopStr), "%d", m.hopsAway);
+            snprintf(hopStr, sizeof(hopStr), "%d", c.hopsAway);
             printAt(x, y + 1, hopStr, CENTER, MIDDLE);
         }
 
-        // Restore default font and color
-        setFont(fontSmall);
+        // Restore default color
         setTextColor(BLACK);
     }
 
@@ -165,6 +183,13 @@ void InkHUD::MapApplet::onRender()
 
 void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
 {
+    // Nothing has moved since we last looked
+    if (centerValid) {
+        *lat = cachedLatCenter;
+        *lng = cachedLngCenter;
+        return;
+    }
+
     // If we have a valid position for our own node, use that as the anchor
     meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
     if (ourNode && nodeDB->hasValidPosition(ourNode)) {
@@ -187,21 +212,11 @@ void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
         float yAvg = 0;
         float zAvg = 0;
 
-        // For each node in db
-        for (uint32_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
-            meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
-
-            // Skip if no position
-            if (!nodeDB->hasValidPosition(node))
-                continue;
-
-            // Skip if derived applet doesn't want to show this node on the map
-            if (!shouldDrawNode(node))
-                continue;
-
+        // For each node in the index (our own has no valid position, if we're here)
+        for (const IndexedNode &node : nodes) {
             // Latitude and Longitude of node, in radians
-            float latRad = node->position.latitude_i * (1e-7) * DEG_TO_RAD;
-            float lngRad = node->position.longitude_i * (1e-7) * DEG_TO_RAD;
+            float latRad = node.latitudeI * (1e-7) * DEG_TO_RAD;
+            float lngRad = node.longitudeI * (1e-7) * DEG_TO_RAD;
 
             // Convert to cartesian points, with center of earth at 0, 0, 0
             // Exact distance from center is irrelevant, as we're only interested in the vector
@@ -216,7 +231,7 @@ void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
             positionCount++;
         }
 
-        // All NodeDB processed, find mean values
+        // All nodes processed, find mean values
         xAvg /= positionCount;
         yAvg /= positionCount;
         zAvg /= positionCount;
@@ -287,24 +302,14 @@ void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
     float easternmost = lngCenter;
     float westernmost = lngCenter;
 
-    for (size_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
-        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
-
-        // Skip if no position
-        if (!nodeDB->hasValidPosition(node))
-            continue;
-
-        // Skip if derived applet doesn't want to show this node on the map
-        if (!shouldDrawNode(node))
-            continue;
-
+    for (const IndexedNode &node : nodes) {
         // Check for a new top or bottom latitude
-        float latNode = node->position.latitude_i * 1e-7;
+        float latNode = node.latitudeI * 1e-7;
         northernmost = max(northernmost, latNode);
         southernmost = min(southernmost, latNode);
 
         // Longitude is trickier
-        float lngNode = node->position.longitude_i * 1e-7;
+        float lngNode = node.longitudeI * 1e-7;
         float degEastward = fmod(((lngNode - lngCenter) + 360), 360);      // Degrees traveled east from lngCenter to reach node
         float degWestward = abs(fmod(((lngNode - lngCenter) - 360), 360)); // Degrees traveled west from lngCenter to reach node
         if (degEastward < degWestward)
@@ -319,6 +324,10 @@ void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
 
     // In case our new center is west of -180, or east of +180, for some reason
     lngCenter = fmod(lngCenter, 180);
+
+    *lat = cachedLatCenter = latCenter;
+    *lng = cachedLngCenter = lngCenter;
+    centerValid = true;
 }
 
 // Size of map in meters
@@ -326,12 +335,20 @@ void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
 // Overridable if derived applet wants a custom map size (fixed size?)
 void InkHUD::MapApplet::getMapSize(uint32_t *widthMeters, uint32_t *heightMeters)
 {
+    // Same nodes, same center: same size
+    if (sizeValid && sizeLatCenter == latCenter && sizeLngCenter == lngCenter) {
+        *widthMeters = cachedWidthMeters;
+        *heightMeters = cachedHeightMeters;
+        return;
+    }
+
     // Reset the value
     *widthMeters = 0;
     *heightMeters = 0;
 
     // Find the greatest distance horizontally and vertically from map center
-    for (Marker m : markers) {
+    for (const IndexedNode &node : nodes) {
+        Marker m = calculateMarker(node.latitudeI * 1e-7, node.longitudeI * 1e-7, false, 0);
         *widthMeters = max(*widthMeters, (uint32_t)abs(m.eastMeters) * 2);
         *heightMeters = max(*heightMeters, (uint32_t)abs(m.northMeters) * 2);
     }
@@ -339,6 +356,12 @@ void InkHUD::MapApplet::getMapSize(uint32_t *widthMeters, uint32_t *heightMeters
     // Add padding
     *widthMeters *= 1.1;
     *heightMeters *= 1.1;
+
+    cachedWidthMeters = *widthMeters;
+    cachedHeightMeters = *heightMeters;
+    sizeLatCenter = latCenter;
+    sizeLngCenter = lngCenter;
+    sizeValid = true;
 }
 
 // Convert and store info we need for drawing a marker
@@ -348,14 +371,18 @@ InkHUD::MapApplet::Marker InkHUD::MapApplet::calculateMarker(float lat, float ln
 {
     assert(lat != 0 || lng != 0); // Not null island. Applets should check this before calling.
 
-    // Bearing and distance from map center to node
-    float distanceFromCenter = GeoCoord::latLongToMeter(latCenter, lngCenter, lat, lng);
-    float bearingFromCenter = GeoCoord::bearing(latCenter, lngCenter, lat, lng); // in radians
+    // Degrees north and east of map center, the short way round
+    float lngDelta = lng - lngCenter;
+    if (lngDelta > 180)
+        lngDelta -= 360;
+    else if (lngDelta < -180)
+        lngDelta += 360;
 
-    // Split into meters north and meters east components (signed)
-    // - signedness of cos / sin automatically sets negative if south or west
-    float northMeters = cos(bearingFromCenter) * distanceFromCenter;
-    float eastMeters = sin(bearingFromCenter) * distanceFromCenter;
+    // Equirectangular projection around the map center
+    // - as good as the distance and bearing at the size of a mesh, and no trig per node
+    // - a degree of longitude shrinks with the cosine of the latitude
+    float northMeters = (lat - latCenter) * metersPerDegree;
+    float eastMeters = lngDelta * metersPerDegree * lngScale;
 
     // Store this as a new marker
     Marker m;
@@ -422,34 +449,74 @@ void InkHUD::MapApplet::drawLabeledMarker(meshtastic_NodeInfoLite *node)
         paddingInnerW = 0; // If no text, no padding for text
     textH = fontSmall.lineHeight();
     labelH = paddingH + max((int16_t)(textH), (int16_t)markerSize) + paddingH;
-    labelY = markerY - (labelH / 2);
-    textY = markerY;
     labelW = paddingW + markerSize + paddingInnerW + textW + paddingW; // Width is same whether right or left hand variant
 
-    // Left-side variant
-    if (markerX < width() / 2) {
-        labelX = markerX - (markerSize / 2) - paddingW;
-        textX = labelX + paddingW + markerSize + paddingInnerW;
-    }
-
-    // Right-side variant
-    else {
-        labelX = markerX - (markerSize / 2) - paddingInnerW - textW - paddingW;
-        textX = labelX + paddingW;
-    }
+    // Left-side variant: text right of the marker
+    int16_t leftLabelX = markerX - (markerSize / 2) - paddingW;
+    // Right-side variant: text left of the marker
+    int16_t rightLabelX = markerX - (markerSize / 2) - paddingInnerW - textW - paddingW;
 
     // Prevent overlap with scale bars and their labels
     // Define a "safe zone" in the bottom-left where the scale bars and text are drawn
     constexpr int16_t safeZoneHeight = 28; // adjust based on your label font height
     constexpr int16_t safeZoneWidth = 60;  // adjust based on horizontal label width zone
-    bool overlapsScale = (labelY + labelH > height() - safeZoneHeight) && (labelX < safeZoneWidth);
 
-    // If it overlaps, shift label upward slightly above the safe zone
-    if (overlapsScale) {
-        labelY = height() - safeZoneHeight - labelH - 2;
-        textY = labelY + (labelH / 2);
+    // Our own node's marker, drawn as a bullseye
+    int16_t ourX = INT16_MIN;
+    int16_t ourY = INT16_MIN;
+    meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
+    if (ourNode && ourNode != node && nodeDB->hasValidPosition(ourNode)) {
+        Marker self = calculateMarker(ourNode->position.latitude_i * 1e-7, ourNode->position.longitude_i * 1e-7, false, 0);
+        ourX = X(0.5) + (self.eastMeters * metersToPx);
+        ourY = Y(0.5) - (self.northMeters * metersToPx);
+    }
+
+    // Whether a label would be fully on screen, and clear of the scale bars and our own marker
+    auto labelFits = [&](int16_t x, int16_t y) {
+        if (x < 0 || y < 0 || x + labelW > width() || y + labelH > height())
+            return false;
+        if (y + labelH > height() - safeZoneHeight && x < safeZoneWidth)
+            return false;
+        constexpr int16_t ourRadius = 9;
+        return !(x < ourX + ourRadius && x + labelW > ourX - ourRadius && y < ourY + ourRadius && y + labelH > ourY - ourRadius);
+    };
+
+    // Places to try, best first: beside the marker towards screen center, beside it on the other side, then above or below
+    bool leftFirst = markerX < width() / 2;
+    int16_t nearX = leftFirst ? leftLabelX : rightLabelX;
+    int16_t farX = leftFirst ? rightLabelX : leftLabelX;
+    int16_t besideY = markerY - (labelH / 2);
+    int16_t aboveY = markerY - (markerSize / 2) - 1 - labelH;
+    int16_t belowY = markerY + (markerSize / 2) + 2;
+    struct Placement {
+        int16_t x;
+        int16_t y;
+        bool left; // Left-side variant
+    };
+    const Placement placements[] = {{nearX, besideY, leftFirst}, {farX, besideY, !leftFirst}, {nearX, aboveY, leftFirst},
+                                    {nearX, belowY, leftFirst},  {farX, aboveY, !leftFirst},  {farX, belowY, !leftFirst}};
+
+    // Nowhere fits: beside the marker, but shifted upward, slightly above the safe zone
+    Placement chosen = placements[0];
+    bool overlapsScale = (chosen.y + labelH > height() - safeZoneHeight) && (chosen.x < safeZoneWidth);
+    if (overlapsScale)
+        chosen.y = height() - safeZoneHeight - labelH - 2;
+
+    for (const Placement &p : placements) {
+        if (labelFits(p.x, p.y)) {
+            chosen = p;
+            break;
+        }
     }
 
+    labelX = chosen.x;
+    labelY = chosen.y;
+    textY = labelY + (labelH / 2);
+    if (chosen.left)
+        textX = labelX + paddingW + markerSize + paddingInnerW;
+    else
+        textX = labelX + paddingW;
+
     // Backing box
     fillRect(labelX, labelY, labelW, labelH, WHITE);
     drawRect(labelX, labelY, labelW, labelH, BLACK);
@@ -474,28 +541,29 @@ void InkHUD::MapApplet::drawLabeledMarker(meshtastic_NodeInfoLite *node)
 // Need at least two, to draw a sensible map
 bool InkHUD::MapApplet::enoughMarkers()
 {
-    size_t count = 0;
-    for (size_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
-        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
-
-        // Count nodes
-        if (nodeDB->hasValidPosition(node) && shouldDrawNode(node))
-            count++;
-
-        // We need to find two
-        if (count == 2)
-            return true; // Two nodes is enough for a sensible map
-    }
-
-    return false; // No nodes would be drawn (or just the one, uselessly at 0,0)
+    updateIndex();
+    return drawableCount >= 2; // With no nodes, or just the one, nothing would be drawn (or uselessly at 0,0)
 }
 
-// Calculate how far north and east of map center each node is
-// Derived applets can control which nodes to calculate (and later, draw) by overriding MapApplet::shouldDrawNode
-void InkHUD::MapApplet::calculateAllMarkers()
+// Sort the nodes with a position into a grid of gridSize x gridSize cells, which spans all of them
+// Derived applets can control which nodes to index (and later, draw) by overriding MapApplet::shouldDrawNode
+// Only redone when NodeDB has changed, and then without any float math
+void InkHUD::MapApplet::updateIndex()
 {
-    // Clear old markers
-    markers.clear();
+    if (indexValid && nodeDB->getChangeCount() == indexedChanges)
+        return;
+    indexValid = true;
+    indexedChanges = nodeDB->getChangeCount();
+    centerValid = false;
+    sizeValid = false;
+
+    std::vector<IndexedNode> unsorted;
+    unsorted.reserve(nodes.size());
+    drawableCount = 0;
+    int32_t latMin = INT32_MAX;
+    int32_t latMax = INT32_MIN;
+    int32_t lngMin = INT32_MAX;
+    int32_t lngMax = INT32_MIN;
 
     // For each node in db
     for (uint32_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
@@ -509,18 +577,124 @@ void InkHUD::MapApplet::calculateAllMarkers()
         if (!shouldDrawNode(node))
             continue;
 
+        drawableCount++;
+
         // Skip if our own node
         // - special handling in render()
         if (node->num == nodeDB->getNodeNum())
             continue;
 
-        // Calculate marker and store it
-        markers.push_back(
-            calculateMarker(node->position.latitude_i * 1e-7,  // Lat, converted from Meshtastic's internal int32 style
-                            node->position.longitude_i * 1e-7, // Long, converted from Meshtastic's internal int32 style
-                            node->has_hops_away,               // Is the hopsAway number valid
-                            node->hops_away                    // Hops away
-                            ));
+        IndexedNode n = {node->position.latitude_i, node->position.longitude_i, node->has_hops_away, (uint8_t)node->hops_away};
+        unsorted.push_back(n);
+        latMin = min(latMin, n.latitudeI);
+        latMax = max(latMax, n.latitudeI);
+        lngMin = min(lngMin, n.longitudeI);
+        lngMax = max(lngMax, n.longitudeI);
+    }
+
+    memset(cellStart, 0, sizeof(cellStart));
+    nodes.clear();
+    if (unsorted.empty())
+        return;
+
+    // Cells just big enough for gridSize of them to cover every position
+    gridLatMin = latMin;
+    gridLngMin = lngMin;
+    gridLatStep = ((int64_t)latMax - latMin) / gridSize + 1;
+    gridLngStep = ((int64_t)lngMax - lngMin) / gridSize + 1;
+    auto cellOf = [&](const IndexedNode &n) {
+        uint32_t row = ((int64_t)n.latitudeI - gridLatMin) / gridLatStep;
+        uint32_t col = ((int64_t)n.longitudeI - gridLngMin) / gridLngStep;
+        return row * gridSize + col;
+    };
+
+    // Counting sort: count the nodes of each cell, then place each cell's nodes after those of the cells before it
+    for (const IndexedNode &n : unsorted)
+        cellStart[cellOf(n) + 1]++;
+    for (uint16_t c = 0; c < gridSize * gridSize; c++)
+        cellStart[c + 1] += cellStart[c];
+
+    uint32_t next[gridSize * gridSize];
+    memcpy(next, cellStart, sizeof(next));
+    nodes.resize(unsorted.size());
+    for (const IndexedNode &n : unsorted)
+        nodes[next[cellOf(n)]++] = n;
+}
+
+// Find the markers in view, and where they land on screen
+// Only the grid cells which overlap the view are visited, so the work follows the nodes on screen, not the size of NodeDB
+// Markers which land in the same cell of the screen would overlap: they are gathered into one cluster
+void InkHUD::MapApplet::clusterMarkers()
+{
+    clusters.clear();
+
+    // Cells of the screen
+    uint16_t cols = (width() + clusterPx - 1) / clusterPx;
+    uint16_t rows = (height() + clusterPx - 1) / clusterPx;
+    cellClusters.assign((size_t)cols * rows, 0);
+
+    if (nodes.empty() || !(metersToPx > 0))
+        return;
+
+    // Part of the map in view, with room for a marker which is only partly on screen
+    const float marginPx = clusterPx / 2;
+    float halfHeightDeg = ((height() / 2) + marginPx) / metersToPx / metersPerDegree;
+    float halfWidthDeg = ((width() / 2) + marginPx) / metersToPx / (metersPerDegree * max(lngScale, 0.01f));
+
+    // Rows and columns of the grid which overlap it
+    // Returns false if none do
+    auto gridRange = [](float from, float to, int32_t gridMin, uint32_t step, uint8_t *first, uint8_t *last) {
+        int64_t lo = (int64_t)floor(from * 1e7) - gridMin;
+        int64_t hi = (int64_t)ceil(to * 1e7) - gridMin;
+        if (hi < 0 || lo >= (int64_t)step * gridSize)
+            return false;
+        *first = lo < 0 ? 0 : lo / step;
+        *last = hi / step < gridSize ? hi / step : gridSize - 1;
+        return true;
+    };
+
+    uint8_t rowFirst, rowLast, colFirst, colLast;
+    if (!gridRange(latCenter - halfHeightDeg, latCenter + halfHeightDeg, gridLatMin, gridLatStep, &rowFirst, &rowLast))
+        return;
+    if (lngCenter - halfWidthDeg < -180 || lngCenter + halfWidthDeg > 180) {
+        // View crosses the antimeridian: don't bother, check every column
+        colFirst = 0;
+        colLast = gridSize - 1;
+    } else if (!gridRange(lngCenter - halfWidthDeg, lngCenter + halfWidthDeg, gridLngMin, gridLngStep, &colFirst, &colLast))
+        return;
+
+    for (uint8_t row = rowFirst; row <= rowLast; row++) {
+        for (uint32_t i = cellStart[row * gridSize + colFirst]; i < cellStart[row * gridSize + colLast + 1]; i++) {
+            const IndexedNode &n = nodes[i];
+            Marker m = calculateMarker(n.latitudeI * 1e-7, n.longitudeI * 1e-7, n.hasHopsAway, n.hopsAway);
+
+            // Convert to pixel coords, skip if off screen
+            float xPx = X(0.5) + (m.eastMeters * metersToPx);
+            float yPx = Y(0.5) - (m.northMeters * metersToPx);
+            if (xPx < -marginPx || xPx >= width() + marginPx || yPx < -marginPx || yPx >= height() + marginPx)
+                continue;
+            int16_t x = xPx;
+            int16_t y = yPx;
+
+            // Cell of the screen
+            uint16_t cellX = (x < 0 ? 0 : x >= width() ? width() - 1 : x) / clusterPx;
+            uint16_t cellY = (y < 0 ? 0 : y >= height() ? height() - 1 : y) / clusterPx;
+            uint16_t &slot = cellClusters[cellY * cols + cellX];
+
+            // First marker in this cell: drawn where it is
+            if (!slot) {
+                clusters.push_back({x, y, 1, m.hasHopsAway, m.hopsAway});
+                slot = clusters.size();
+            }
+
+            // More than one: drawn as a single marker in the middle of the cell
+            else {
+                Cluster &c = clusters[slot - 1];
+                c.x = (cellX * clusterPx) + (clusterPx / 2);
+                c.y = (cellY * clusterPx) + (clusterPx / 2);
+                c.count++;
+            }
+        }
     }
 }
 
@@ -8,6 +8,10 @@ Plots position of for a selection of nodes, with north facing up.
 Size of cross represents hops away.
 Our own node is identified with a faded label.
 
+Node positions are kept in a coarse grid, rebuilt only when NodeDB changes,
+so that a render only visits the nodes in view.
+Markers which would overlap are drawn as a single marker, showing how many nodes it stands for.
+
 The base applet doesn't handle any events; this is left to the derived applets.
 
 */
@@ -21,6 +25,8 @@ The base applet doesn't handle any events; this is left to the derived applets.
 #include "MeshModule.h"
 #include "gps/GeoCoord.h"
 
+#include <vector>
+
 namespace NicheGraphics::InkHUD
 {
 
@@ -30,14 +36,19 @@ class MapApplet : public Applet
     void onRender() override;
 
   protected:
-    virtual bool shouldDrawNode(meshtastic_NodeInfoLite *node) { return true; } // Allow derived applets to filter the nodes
+    // Allow derived applets to filter the nodes. Asked when the index is rebuilt, after any change to NodeDB
+    virtual bool shouldDrawNode(meshtastic_NodeInfoLite *node) { return true; }
     virtual void getMapCenter(float *lat, float *lng);
     virtual void getMapSize(uint32_t *widthMeters, uint32_t *heightMeters);
 
     bool enoughMarkers();                                  // Anything to draw?
     void drawLabeledMarker(meshtastic_NodeInfoLite *node); // Highlight a specific marker
 
+#ifdef PIO_UNIT_TESTING
+  public: // The index is checked against NodeDB by test_inkhud_render
+#else
   private:
+#endif
     // Position and size of a marker to be drawn
     struct Marker {
         float eastMeters = 0;  // Meters east of map center. Negative if west.
@@ -46,18 +57,63 @@ class MapApplet : public Applet
         uint8_t hopsAway = 0; // Determines marker size
     };
 
+    // A node which can be drawn on the map (not our own), as held in the index
+    struct IndexedNode {
+        int32_t latitudeI; // Meshtastic's internal int32 style
+        int32_t longitudeI;
+        bool hasHopsAway;
+        uint8_t hopsAway;
+    };
+
+    // The markers which landed in one cell of the screen
+    struct Cluster {
+        int16_t x; // Pixel position of the first marker, or of the cell if more than one
+        int16_t y;
+        uint32_t count;
+        bool hasHopsAway;
+        uint8_t hopsAway;
+    };
+
+    static constexpr uint8_t gridSize = 16;  // Index is gridSize x gridSize cells, spanning all positions
+    static constexpr uint8_t clusterPx = 14; // Markers in the same square of this size would overlap: draw one
+
     Marker calculateMarker(float lat, float lng, bool hasHopsAway, uint8_t hopsAway);
-    void calculateAllMarkers();
+    void updateIndex();                                 // Rebuild the grid, if NodeDB changed since
+    void clusterMarkers();                              // Gather the markers in view, one cluster per cell of the screen
     void calculateMapScale();                           // Conversion factor for meters to pixels
     void drawCross(int16_t x, int16_t y, uint8_t size); // Draw the X used for most markers
 
     float metersToPx = 0; // Conversion factor for meters to pixels
     float latCenter = 0;  // Map center: latitude
     float lngCenter = 0;  // Map center: longitude
+    float lngScale = 1;   // Length of a degree of longitude at latCenter, relative to a degree of latitude
 
-    std::list<Marker> markers;
     uint32_t widthMeters = 0;  // Map width: meters
     uint32_t heightMeters = 0; // Map height: meters
+
+    // The index: nodes sorted by grid cell, nodes of cell i are from cellStart[i] up to cellStart[i + 1]
+    std::vector<IndexedNode> nodes;
+    uint32_t cellStart[gridSize * gridSize + 1] = {}; // NodeDB can hold more than 65535 nodes on portduino
+    int32_t gridLatMin = 0; // South-west corner of the grid
+    int32_t gridLngMin = 0;
+    uint32_t gridLatStep = 1; // Size of a cell
+    uint32_t gridLngStep = 1;
+    size_t drawableCount = 0; // Nodes shouldDrawNode accepted, including our own
+    uint32_t indexedChanges = 0;
+    bool indexValid = false;
+
+    // Worked out from the index, until it is rebuilt
+    bool centerValid = false;
+    float cachedLatCenter = 0;
+    float cachedLngCenter = 0;
+    bool sizeValid = false;
+    float sizeLatCenter = 0; // Center the size was found for
+    float sizeLngCenter = 0;
+    uint32_t cachedWidthMeters = 0;
+    uint32_t cachedHeightMeters = 0;
+
+    std::vector<Cluster> clusters;
+    std::vector<uint16_t> cellClusters; // For each cell of the screen: 1 + index in clusters, or 0 if empty
 };
 
 } // namespace NicheGraphics::InkHUD
@@ -14,6 +14,9 @@ InkHUD::NodeListApplet::NodeListApplet(const char *name) : MeshModule(name)
     // We only need to be promiscuous in order to hear NodeInfo, apparently. See NodeInfoModule
     // For all other packets, we manually act as if isPromiscuous=false, in wantPacket
     MeshModule::isPromiscuous = true;
+
+    // Derived applets requestUpdate whenever the list visibly changes (including RecentsList pruning old nodes)
+    cacheRender = true;
 }
 
 // Do we want to process this packet with handleReceived()?
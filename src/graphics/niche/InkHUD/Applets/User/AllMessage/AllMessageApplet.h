@@ -30,6 +30,8 @@ class Applet;
 class AllMessageApplet : public Applet
 {
   public:
+    AllMessageApplet() { cacheRender = true; } // Only a new message changes what we draw
+
     void onRender() override;
 
     void onActivate() override;
@@ -30,6 +30,8 @@ class Applet;
 class DMApplet : public Applet
 {
   public:
+    DMApplet() { cacheRender = true; } // Only a new message changes what we draw
+
     void onRender() override;
 
     void onActivate() override;
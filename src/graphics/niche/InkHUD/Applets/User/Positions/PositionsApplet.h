@@ -23,7 +23,10 @@ namespace NicheGraphics::InkHUD
 class PositionsApplet : public MapApplet, public SinglePortModule
 {
   public:
-    PositionsApplet() : SinglePortModule("PositionsApplet", meshtastic_PortNum_POSITION_APP) {}
+    PositionsApplet() : SinglePortModule("PositionsApplet", meshtastic_PortNum_POSITION_APP)
+    {
+        cacheRender = true; // Map only changes when handleReceived says so
+    }
     void onRender() override;
 
   protected:
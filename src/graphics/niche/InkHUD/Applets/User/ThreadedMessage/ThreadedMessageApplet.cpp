@@ -20,6 +20,9 @@ InkHUD::ThreadedMessageApplet::ThreadedMessageApplet(uint8_t channelIndex)
     // Will shortly attempt to load messages from RAM, if applet is active
     // Label (filename in flash) is set from channel index
     store = new MessageStore("ch" + to_string(channelIndex));
+
+    // Only a new message changes what we draw
+    cacheRender = true;
 }
 
 void InkHUD::ThreadedMessageApplet::onRender()
@@ -331,4 +331,29 @@ void InkHUD::InkHUD::drawPixel(int16_t x, int16_t y, Color c)
     renderer->handlePixel(x, y, c);
 }
 
+// Place a filled rectangle into the image buffer
+// Same coordinates as drawPixel. The rect must already be cropped to the display
+void InkHUD::InkHUD::fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c)
+{
+    renderer->handleRect(x, y, w, h, c);
+}
+
+uint8_t *InkHUD::InkHUD::getImageBuffer()
+{
+    return renderer->getImageBuffer();
+}
+
+// Copy a region of the image buffer, for a tile to reuse its applet's last render
+// Same coordinates as drawPixel. The region must already be cropped to the display
+void InkHUD::InkHUD::saveRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, std::vector<uint8_t> &saved)
+{
+    renderer->saveRegion(x, y, w, h, saved);
+}
+
+// Put back a region copied with saveRegion
+void InkHUD::InkHUD::restoreRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, const std::vector<uint8_t> &saved)
+{
+    renderer->restoreRegion(x, y, w, h, saved);
+}
+
 #endif
\ No newline at end of file
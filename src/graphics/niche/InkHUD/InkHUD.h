@@ -103,6 +103,10 @@ class InkHUD
 
     // Pass drawing output to Renderer
     void drawPixel(int16_t x, int16_t y, Color c);
+    void fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c);
+    uint8_t *getImageBuffer(); // The image being drawn. For tests and benchmarks which render applets by hand
+    void saveRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, std::vector<uint8_t> &saved);
+    void restoreRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, const std::vector<uint8_t> &saved);
 
     // Shared data which persists between boots
     Persistence *persistence = nullptr;
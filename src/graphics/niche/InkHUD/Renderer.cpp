@@ -121,6 +121,84 @@ void InkHUD::Renderer::handlePixel(int16_t x, int16_t y, Color c)
     bitWrite(imageBuffer[byteNum], bitNum, c);
 }
 
+// Fill a rectangle of the image buffer
+// The fast path for lines, filled shapes and runs of text pixels: rotated once, then written a byte at a time
+void InkHUD::Renderer::handleRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c)
+{
+    rotateRect(&x, &y, &w, &h);
+
+    // In buffer terms, each row of the rect is now a run of bits
+    uint16_t firstByte = x / 8;
+    uint16_t lastByte = (x + w - 1) / 8;
+    uint8_t firstMask = 0xFF >> (x % 8);               // Leftmost pixel is the most significant bit
+    uint8_t lastMask = 0xFF << (7 - ((x + w - 1) % 8)); // Bits up to and including the last pixel
+    if (firstByte == lastByte)
+        firstMask &= lastMask;
+
+    // Color is the bit value, as for handlePixel: BLACK clears bits, WHITE sets them
+    uint8_t *row = imageBuffer + (y * imageBufferWidth);
+    for (uint16_t i = 0; i < h; i++, row += imageBufferWidth) {
+        if (c == WHITE)
+            row[firstByte] |= firstMask;
+        else
+            row[firstByte] &= ~firstMask;
+
+        if (firstByte == lastByte)
+            continue;
+
+        memset(row + firstByte + 1, c == WHITE ? 0xFF : 0x00, lastByte - firstByte - 1);
+
+        if (c == WHITE)
+            row[lastByte] |= lastMask;
+        else
+            row[lastByte] &= ~lastMask;
+    }
+}
+
+// Copy a region of the image buffer, so it can be put back next render without drawing it again
+// Whole bytes are kept, in the rotated layout: the bits either side of the region are masked off by restoreRegion
+void InkHUD::Renderer::saveRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, std::vector<uint8_t> &saved)
+{
+    rotateRect(&x, &y, &w, &h);
+
+    uint16_t firstByte = x / 8;
+    uint16_t rowBytes = ((x + w - 1) / 8) - firstByte + 1;
+    saved.resize(rowBytes * h);
+
+    const uint8_t *row = imageBuffer + (y * imageBufferWidth) + firstByte;
+    for (uint16_t i = 0; i < h; i++, row += imageBufferWidth)
+        memcpy(saved.data() + (i * rowBytes), row, rowBytes);
+}
+
+// Put back a region copied by saveRegion
+// Region and rotation must be the same as when it was saved
+void InkHUD::Renderer::restoreRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, const std::vector<uint8_t> &saved)
+{
+    rotateRect(&x, &y, &w, &h);
+
+    uint16_t firstByte = x / 8;
+    uint16_t lastByte = (x + w - 1) / 8;
+    uint16_t rowBytes = lastByte - firstByte + 1;
+    uint8_t firstMask = 0xFF >> (x % 8);
+    uint8_t lastMask = 0xFF << (7 - ((x + w - 1) % 8));
+    if (firstByte == lastByte)
+        firstMask &= lastMask;
+
+    assert(saved.size() == (size_t)rowBytes * h);
+
+    uint8_t *row = imageBuffer + (y * imageBufferWidth) + firstByte;
+    const uint8_t *src = saved.data();
+    for (uint16_t i = 0; i < h; i++, row += imageBufferWidth, src += rowBytes) {
+        row[0] = (row[0] & ~firstMask) | (src[0] & firstMask);
+
+        if (rowBytes == 1)
+            continue;
+
+        memcpy(row + 1, src + 1, rowBytes - 2);
+        row[rowBytes - 1] = (row[rowBytes - 1] & ~lastMask) | (src[rowBytes - 1] & lastMask);
+    }
+}
+
 // Width of the display, relative to rotation
 uint16_t InkHUD::Renderer::width()
 {
@@ -188,6 +266,38 @@ void InkHUD::Renderer::rotatePixelCoords(int16_t *x, int16_t *y)
     *y = y1;
 }
 
+// Applies the system-wide rotation to a rectangle, in the same way as rotatePixelCoords
+// Position becomes the top-left corner of the rect in the image buffer
+void InkHUD::Renderer::rotateRect(int16_t *x, int16_t *y, uint16_t *w, uint16_t *h)
+{
+    int16_t x1 = *x;
+    int16_t y1 = *y;
+    uint16_t w1 = *w;
+    uint16_t h1 = *h;
+    switch (settings->rotation) {
+    case 1:
+        x1 = driver->width - (*y + *h);
+        y1 = *x;
+        w1 = *h;
+        h1 = *w;
+        break;
+    case 2:
+        x1 = driver->width - (*x + *w);
+        y1 = driver->height - (*y + *h);
+        break;
+    case 3:
+        x1 = *y;
+        y1 = driver->height - (*x + *w);
+        w1 = *h;
+        h1 = *w;
+        break;
+    }
+    *x = x1;
+    *y = y1;
+    *w = w1;
+    *h = h1;
+}
+
 // Make an attempt to gather image data from some / all applets, and update the display
 // Might not be possible right now, if update already is progress.
 void InkHUD::Renderer::render(bool async)
@@ -252,8 +362,9 @@ void InkHUD::Renderer::render(bool async)
 // Manually fill the image buffer with WHITE
 // Clears any old drawing
 // Note: benchmarking revealed that this is *much* faster than setting pixels individually
-// So much so that it's more efficient to re-render all applets,
-// rather than rendering selectively, and manually blanking a portion of the display
+// So much so that it's more efficient to redraw all applets,
+// rather than rendering selectively, and manually blanking a portion of the display.
+// Applets with nothing new to show are redrawn from their tile's copy of their last render (see Applet::cacheRender)
 void InkHUD::Renderer::clearBuffer()
 {
     memset(imageBuffer, 0xFF, imageBufferHeight * imageBufferWidth);
@@ -341,8 +452,11 @@ Drivers::EInk::UpdateTypes InkHUD::Renderer::decideUpdateType()
 void InkHUD::Renderer::renderUserApplets()
 {
     // Don't render user applets if a system applet has demanded the whole display to itself
-    if (lockRendering)
+    // The menu may change settings which the applets draw, so they will all draw from scratch once it has closed
+    if (lockRendering) {
+        Tile::discardAllRenders();
         return;
+    }
 
     // Render any user applets which are currently visible
     for (Applet *ua : inkhud->userApplets) {
@@ -46,6 +46,13 @@ class Renderer : protected concurrency::OSThread
 
     // Receives pixel output from an applet (via a tile, which translates the coordinates)
     void handlePixel(int16_t x, int16_t y, Color c);
+    void handleRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c); // Already cropped to the display
+
+    uint8_t *getImageBuffer() { return imageBuffer; } // Image as drawn so far, ready for the driver
+
+    // Copy a region of the image out, and back in again. For tiles which keep their applet's last render
+    void saveRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, std::vector<uint8_t> &saved); // Already cropped to the display
+    void restoreRegion(int16_t x, int16_t y, uint16_t w, uint16_t h, const std::vector<uint8_t> &saved);
 
     // Size of display, in context of current rotation
 
@@ -58,6 +65,7 @@ class Renderer : protected concurrency::OSThread
 
     // Apply the display rotation to handled pixels
     void rotatePixelCoords(int16_t *x, int16_t *y);
+    void rotateRect(int16_t *x, int16_t *y, uint16_t *w, uint16_t *h);
 
     // Execute the render process now, then hand off to driver for display update
     void render(bool async = true);
@@ -9,6 +9,7 @@ using namespace NicheGraphics;
 // Static members of Tile class (for linking)
 InkHUD::Tile *InkHUD::Tile::highlightTarget;
 bool InkHUD::Tile::highlightShown;
+uint32_t InkHUD::Tile::cacheGeneration = 0;
 
 // For dismissing the highlight indicator, after a few seconds
 // Highlighting is used to inform user of which tile is now focused
@@ -44,6 +45,8 @@ InkHUD::Tile::Tile(int16_t left, int16_t top, uint16_t width, uint16_t height)
 {
     assert(width > 0 && height > 0);
 
+    inkhud = InkHUD::getInstance();
+
     this->left = left;
     this->top = top;
     this->width = width;
@@ -55,6 +58,9 @@ InkHUD::Tile::Tile(int16_t left, int16_t top, uint16_t width, uint16_t height)
 // The WindowManager multiplexes the applets to these tiles automatically
 void InkHUD::Tile::setRegion(uint8_t userTileCount, uint8_t tileIndex)
 {
+    // A copy of the last render won't fit the new region
+    discardRender();
+
     uint16_t displayWidth = inkhud->width();
     uint16_t displayHeight = inkhud->height();
 
@@ -141,6 +147,8 @@ void InkHUD::Tile::setRegion(int16_t left, int16_t top, uint16_t width, uint16_t
 {
     assert(width > 0 && height > 0);
 
+    discardRender();
+
     this->left = left;
     this->top = top;
     this->width = width;
@@ -161,7 +169,9 @@ void InkHUD::Tile::assignApplet(Applet *a)
         assignedApplet->setTile(nullptr);
 
     // Store the new applet
+    // Whatever the old one drew is no use to it
     assignedApplet = a;
+    discardRender();
 
     // Create the reciprocal link between the new applet and this tile
     if (a)
@@ -190,6 +200,95 @@ void InkHUD::Tile::handleAppletPixel(int16_t x, int16_t y, Color c)
     }
 }
 
+// Receive a filled rectangle from the assigned applet
+// Same as handleAppletPixel, but the cropping is done once for the whole rect
+void InkHUD::Tile::handleAppletRect(int16_t x, int16_t y, int16_t w, int16_t h, Color c)
+{
+    // Move from applet-space to tile-space
+    x += left;
+    y += top;
+
+    // Crop to tile borders
+    int16_t x2 = min((int16_t)(x + w), (int16_t)(left + width));
+    int16_t y2 = min((int16_t)(y + h), (int16_t)(top + height));
+    x = max(x, left);
+    y = max(y, top);
+
+    // Pass to the renderer, if anything is left
+    if (x < x2 && y < y2)
+        inkhud->fillRect(x, y, x2 - x, y2 - y, c);
+}
+
+// Keep a copy of what the assigned applet has just drawn
+// Next render, if the applet has nothing new to show, the copy is put back instead of rendering the applet again
+void InkHUD::Tile::saveRender()
+{
+    int16_t x, y;
+    uint16_t w, h;
+    if (!getDisplayRegion(&x, &y, &w, &h)) {
+        discardRender();
+        return;
+    }
+
+    inkhud->saveRegion(x, y, w, h, cache);
+    cacheValid = true;
+    cachedGeneration = cacheGeneration;
+    cachedRotation = inkhud->persistence->settings.rotation;
+    cachedAtMs = millis();
+}
+
+// Put back the copy made by saveRender, if it still shows what the applet would draw
+// Returns false if the applet needs to render
+bool InkHUD::Tile::restoreRender()
+{
+    if (!cacheValid)
+        return false;
+
+    // Invalidated since, or the display has turned, or the copy is just old
+    if (cachedGeneration != cacheGeneration || cachedRotation != inkhud->persistence->settings.rotation ||
+        millis() - cachedAtMs > cacheMaxAgeMs) {
+        discardRender();
+        return false;
+    }
+
+    int16_t x, y;
+    uint16_t w, h;
+    if (!getDisplayRegion(&x, &y, &w, &h))
+        return false;
+
+    inkhud->restoreRegion(x, y, w, h, cache);
+    return true;
+}
+
+// Make sure the assigned applet renders from scratch next time
+// The buffer is kept for the next saveRender: freeing and reallocating it would only fragment the heap
+void InkHUD::Tile::discardRender()
+{
+    cacheValid = false;
+}
+
+// Make sure every applet renders from scratch next time
+// For changes which affect what all applets draw, like settings
+void InkHUD::Tile::discardAllRenders()
+{
+    cacheGeneration++;
+}
+
+// Our region, cropped to the display. False if nothing of it is on the display
+bool InkHUD::Tile::getDisplayRegion(int16_t *x, int16_t *y, uint16_t *w, uint16_t *h)
+{
+    int16_t x2 = min((int16_t)(left + width), (int16_t)inkhud->width());
+    int16_t y2 = min((int16_t)(top + height), (int16_t)inkhud->height());
+    *x = max(left, (int16_t)0);
+    *y = max(top, (int16_t)0);
+    if (*x >= x2 || *y >= y2)
+        return false;
+
+    *w = x2 - *x;
+    *h = y2 - *y;
+    return true;
+}
+
 // Called by Applet base class, when setting applet dimensions, immediately before render
 uint16_t InkHUD::Tile::getWidth()
 {
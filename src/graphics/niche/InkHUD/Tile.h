@@ -29,6 +29,7 @@ class Tile
     void setRegion(uint8_t layoutSize, uint8_t tileIndex);                      // Assign region automatically, based on layout
     void setRegion(int16_t left, int16_t top, uint16_t width, uint16_t height); // Assign region manually
     void handleAppletPixel(int16_t x, int16_t y, Color c);                      // Receive px output from assigned applet
+    void handleAppletRect(int16_t x, int16_t y, int16_t w, int16_t h, Color c); // Receive filled rect from assigned applet
     uint16_t getWidth();
     uint16_t getHeight();
     static uint16_t maxDisplayDimension(); // Largest possible width / height any tile may ever encounter
@@ -36,6 +37,11 @@ class Tile
     void assignApplet(Applet *a); // Link an applet with this tile
     Applet *getAssignedApplet();  // Applet which is currently linked with this tile
 
+    void saveRender();               // Keep a copy of what the assigned applet just drew
+    bool restoreRender();            // Redraw the copy, if still valid. Instead of rendering the applet again
+    void discardRender();            // Assigned applet must render from scratch next time
+    static void discardAllRenders(); // All applets must render from scratch next time
+
     void requestHighlight();              // Ask for this tile to be highlighted
     static void startHighlightTimeout();  // Start the auto-dismissal timer
     static void cancelHighlightTimeout(); // Cancel the auto-dismissal timer early; already dismissed
@@ -44,6 +50,8 @@ class Tile
     static bool highlightShown;   // Is the tile highlighted yet? Controls highlight vs dismiss
 
   private:
+    bool getDisplayRegion(int16_t *x, int16_t *y, uint16_t *w, uint16_t *h); // Our region, cropped to the display
+
     InkHUD *inkhud = nullptr;
 
     int16_t left = 0;
@@ -52,6 +60,15 @@ class Tile
     uint16_t height = 0;
 
     Applet *assignedApplet = nullptr; // Pointer to the applet which is currently linked with the tile
+
+    // Backing bitmap: our region of the image, as the assigned applet last drew it. See Applet::cacheRender
+    static constexpr uint32_t cacheMaxAgeMs = 15 * 60 * 1000UL; // Redraw now and then anyway, for times like "Yesterday"
+    static uint32_t cacheGeneration;                            // Incremented by discardAllRenders
+    std::vector<uint8_t> cache;
+    bool cacheValid = false;
+    uint32_t cachedGeneration = 0;
+    uint8_t cachedRotation = 0;
+    uint32_t cachedAtMs = 0;
 };
 
 } // namespace NicheGraphics::InkHUD
@@ -1,4 +1,5 @@
 #include "configuration.h"
+#include "AsyncLogWriter.h"
 #if !MESHTASTIC_EXCLUDE_GPS
 #include "GPS.h"
 #endif
@@ -8,6 +9,7 @@
 #include "PowerFSM.h"
 #include "PowerMon.h"
 #include "ReliableRouter.h"
+#include "SaveScheduler.h"
 #include "airtime.h"
 #include "buzz.h"
 
@@ -18,6 +20,7 @@
 #include "Throttle.h"
 #include "concurrency/OSThread.h"
 #include "concurrency/Periodic.h"
+#include "concurrency/ThreadProfiler.h"
 #include "detect/ScanI2C.h"
 #include "error.h"
 #include "power.h"
@@ -465,6 +468,9 @@ void setup()
 
 #ifdef DEBUG_PORT
     consoleInit(); // Set serial baud rate and init our mesh console
+#if ENABLE_ASYNC_LOGGING
+    asyncLogWriter = new AsyncLogWriter();
+#endif
 #endif
 
 #ifdef UNPHONE
@@ -845,6 +851,10 @@ void setup()
     // We do this as early as possible because this loads preferences from flash
     // but we need to do this after main cpu init (esp32setup), because we need the random seed set
     nodeDB = new NodeDB;
+    saveScheduler = new SaveScheduler();
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+    threadProfiler = new ThreadProfiler();
+#endif
 #if HAS_TFT
     if (config.display.displaymode == meshtastic_Config_DisplayConfig_DisplayMode_COLOR) {
         tftSetup();
@@ -1703,7 +1713,7 @@ void loop()
 #if HAS_SCREEN && ENABLE_MESSAGE_PERSISTENCE
     messageStoreAutosaveTick();
 #endif
-    long delayMsec = mainController.runOrDelay();
+    long delayMsec = mainScheduler.runOrDelay();
 
     // We want to sleep as long as possible here - because it saves power
     if (!runASAP && loopCanSleep()) {
@@ -0,0 +1,68 @@
+#include "CongestionControl.h"
+#include "Router.h"
+#include "airtime.h"
+#include "configuration.h"
+
+CongestionControl congestionControl;
+
+void CongestionControl::setEnabled(bool on)
+{
+    enabled = on;
+    offset = 0;
+    quietIntervals = 0;
+    haveSample = false;
+}
+
+void CongestionControl::maybeUpdate(uint32_t nowMsec)
+{
+    if (!enabled || !airTime || !router)
+        return;
+    if (haveSample && nowMsec - lastUpdateMsec < CONGESTION_CONTROL_INTERVAL_MS)
+        return;
+    lastUpdateMsec = nowMsec;
+
+    Sample sample = {airTime->channelUtilizationPercent(), router->getStats().lookups, router->rxDupe,
+                     router->txRelayCanceled};
+    update(sample);
+}
+
+void CongestionControl::update(const Sample &sample)
+{
+    if (!haveSample) {
+        // Nothing to compare the counters with yet
+        last = sample;
+        haveSample = true;
+        return;
+    }
+
+    uint32_t received = sample.received - last.received;
+    uint32_t duplicates = sample.duplicates - last.duplicates;
+    uint32_t canceled = sample.relayCanceled - last.relayCanceled;
+    last = sample;
+
+    uint32_t dupePercent = received >= CONGESTION_MIN_PACKETS ? duplicates * 100 / received : 0;
+    uint32_t canceledPercent = duplicates ? canceled * 100 / duplicates : 100;
+
+    bool busy = sample.utilPercent >= CONGESTION_BUSY_UTIL_PERCENT ||
+                (dupePercent >= CONGESTION_BUSY_DUPE_PERCENT && canceledPercent < 50);
+    bool quiet = sample.utilPercent < CONGESTION_QUIET_UTIL_PERCENT && dupePercent < CONGESTION_QUIET_DUPE_PERCENT;
+
+    int8_t was = offset;
+    if (busy) {
+        quietIntervals = 0;
+        if (offset < CONGESTION_MAX_WIDEN)
+            offset++;
+    } else if (quiet) {
+        // Be slower to narrow than to widen, a single quiet interval may just be a lull
+        if (++quietIntervals >= 2 && offset > 0) {
+            offset--;
+            quietIntervals = 0;
+        }
+    } else {
+        quietIntervals = 0;
+    }
+
+    if (offset != was)
+        LOG_INFO("Congestion control: util=%.1f%% dupes=%u%% canceled=%u%%, CW offset %d -> %d", sample.utilPercent, dupePercent,
+                 canceledPercent, was, offset);
+}
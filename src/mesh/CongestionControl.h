@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+// Off unless asked for: nodes drawing their rebroadcast delays from the same windows is what keeps contention fair,
+// so this is for meshes where every node runs it (and for trying it out in the simulator)
+#ifndef MESHTASTIC_CONGESTION_CONTROL
+#define MESHTASTIC_CONGESTION_CONTROL 0
+#endif
+
+// How often the contention window bounds are reconsidered
+#define CONGESTION_CONTROL_INTERVAL_MS (30 * 1000)
+
+// Channel utilization above which the channel counts as busy (the polite limit of AirTime), and below which as quiet
+#define CONGESTION_BUSY_UTIL_PERCENT 25
+#define CONGESTION_QUIET_UTIL_PERCENT 10
+
+// Share of received packets that were duplicates, above which the neighbourhood counts as dense, and below which as sparse
+#define CONGESTION_BUSY_DUPE_PERCENT 50
+#define CONGESTION_QUIET_DUPE_PERCENT 25
+
+// Fewer packets than this in an interval say nothing about duplicates
+#define CONGESTION_MIN_PACKETS 4
+
+// How far the CW sizes may be widened beyond the defaults, in powers of two
+#define CONGESTION_MAX_WIDEN 2
+
+/**
+ * Moves the bounds of the contention window (CW) that rebroadcast delays are drawn from, according to the load we
+ * measure, instead of always using the fixed CWmin/CWmax of RadioInterface.
+ *
+ * Busy: a high channel utilization, or many duplicates of which few cancelled our own relay (so neighbours rebroadcast
+ * at nearly the same time as us).  Both bounds are doubled straight away, so relays spread over more slots and
+ * collide less.  Quiet: low utilization and few duplicates for two intervals in a row.  The bounds are halved again,
+ * down to the defaults: narrower than those, two neighbours picking the same slot loses more packets than the
+ * shorter delay gains (see test_congestion).
+ *
+ * The offset that lets routers go first is 2 * CWmax slots of the widened CWmax, so it grows with the routers' own
+ * window and they still always go first.
+ */
+class CongestionControl
+{
+  public:
+    /// Cumulative counters, as they are when the sample is taken
+    struct Sample {
+        float utilPercent;
+        uint32_t received;      // packets looked up in the packet history
+        uint32_t duplicates;    // of which were already seen (Router::rxDupe)
+        uint32_t relayCanceled; // relays of ours cancelled because someone else was first (Router::txRelayCanceled)
+    };
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+
+    /// Take a new sample from airTime and router if an interval has passed, called by AirTime every second
+    void maybeUpdate(uint32_t nowMsec);
+
+    /// Adapt the bounds to what happened since the previous sample
+    void update(const Sample &sample);
+
+    /// The CW size to use instead of the given default, both bounds move together
+    uint8_t widen(uint8_t base) const { return enabled ? base + offset : base; }
+
+    /// Powers of two the CW sizes are currently widened by
+    int8_t getOffset() const { return offset; }
+
+  private:
+    bool enabled = MESHTASTIC_CONGESTION_CONTROL;
+    int8_t offset = 0;
+    uint8_t quietIntervals = 0;
+    bool haveSample = false;
+    Sample last = {};
+    uint32_t lastUpdateMsec = 0;
+};
+
+extern CongestionControl congestionControl;
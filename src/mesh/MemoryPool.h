@@ -32,8 +32,10 @@ template <class T> class Allocator
     {
         T *p = alloc(maxWait);
 
-        if (p)
+        if (p) {
             memset(p, 0, sizeof(T));
+            noteAlloc();
+        }
         return p;
     }
 
@@ -47,6 +49,7 @@ template <class T> class Allocator
         }
 
         *p = src;
+        noteAlloc();
         return p;
     }
 
@@ -69,13 +72,35 @@ template <class T> class Allocator
     /// Return a buffer for use by others
     virtual void release(T *p) = 0;
 
+    /// Number of objects currently handed out
+    uint32_t getInUse() const { return inUse; }
+
+    /// The most objects that were ever handed out at once
+    uint32_t getHighWater() const { return highWater; }
+
   protected:
     // Alloc some storage
     virtual T *alloc(TickType_t maxWait) = 0;
 
+    /// Bookkeeping for getInUse()/getHighWater(), release() implementations must call noteRelease()
+    void noteAlloc()
+    {
+        if (++inUse > highWater)
+            highWater = inUse;
+    }
+    void noteRelease()
+    {
+        if (inUse)
+            inUse--;
+    }
+
   private:
     // std::unique_ptr Deleter function; calls release().
     const std::function<void(T *)> deleter;
+
+    // Statistics only, a lost update from an ISR race doesn't matter
+    uint32_t inUse = 0;
+    uint32_t highWater = 0;
 };
 
 /**
@@ -93,6 +118,7 @@ template <class T> class MemoryDynamic : public Allocator<T>
         LOG_HEAP("Freeing 0x%x", p);
 
         free(p);
+        this->noteRelease();
     }
 
   protected:
@@ -135,6 +161,7 @@ template <class T, int MaxSize> class MemoryPool : public Allocator<T>
         if (index >= 0 && index < MaxSize) {
             assert(used[index]); // Should be marked as used
             used[index] = false;
+            this->noteRelease();
             LOG_HEAP("Released static pool item %d at 0x%x", index, p);
         } else {
             LOG_WARN("Pointer 0x%x not from our pool!", p);
@@ -9,6 +9,7 @@
 #include "MeshService.h"
 #include "MessageStore.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "TypeConversions.h"
@@ -137,7 +138,7 @@ void MeshService::reloadConfig(int saveWhat)
     nodeDB->resetRadioConfig(); // Don't let the phone send us fatally bad settings
 
     configChanged.notifyObservers(NULL); // This will cause radio hardware to change freqs etc
-    nodeDB->saveToDisk(saveWhat);
+    nodeDB->scheduleSave(saveWhat);     // Coalesced with any other changes arriving in the next few seconds
 }
 
 /// The owner User record just got updated, update our node DB and broadcast the info into the mesh
@@ -333,6 +334,7 @@ void MeshService::sendToPhone(meshtastic_MeshPacket *p)
         LOG_CRIT("Failed to queue a packet into toPhoneQueue!");
         abort();
     }
+    packetLatency.mark(p, PacketLatency::TO_PHONE);
     fromNum++;
 }
 
@@ -401,6 +403,7 @@ meshtastic_NodeInfoLite *MeshService::refreshLocalMeshNode()
     // Update our local node info with our time (even if we don't decide to update anyone else)
     node->last_heard =
         getValidTime(RTCQualityFromNet); // This nodedb timestamp might be stale, so update it if our clock is kinda valid
+    nodeDB->touchMeshNode(node);
 
     position.time = getValidTime(RTCQualityFromNet);
 
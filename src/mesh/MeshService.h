@@ -117,6 +117,9 @@ class MeshService
     /// last few packets if needs to.
     meshtastic_MeshPacket *getForPhone() { return toPhoneQueue.dequeuePtr(0); }
 
+    /// Number of packets waiting for the phone to fetch them
+    int getToPhoneQueueDepth() { return toPhoneQueue.numUsed(); }
+
     /// Allows the bluetooth handler to free packets after they have been sent
     void releaseToPool(meshtastic_MeshPacket *p) { packetPool.release(p); }
 
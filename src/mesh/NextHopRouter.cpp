@@ -106,6 +106,7 @@ void NextHopRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtast
                         LOG_INFO("Update next hop of 0x%x to 0x%x based on ACK/reply (was relayer %d we were sole %d)", p->from,
                                  p->relay_node, wasAlreadyRelayer, weWereSoleRelayer);
                         origTx->next_hop = p->relay_node;
+                        nodeDB->touchMeshNode(origTx);
                     }
                 }
             }
@@ -299,6 +300,7 @@ int32_t NextHopRouter::doRetransmissions()
                         if (sentTo) {
                             LOG_INFO("Resetting next hop for packet with dest 0x%x\n", p.packet->to);
                             sentTo->next_hop = NO_NEXT_HOP_PREFERENCE;
+                            nodeDB->touchMeshNode(sentTo);
                         }
                         FloodingRouter::send(packetPool.allocCopy(*p.packet));
                     } else {
@@ -16,6 +16,7 @@
 #include "Router.h"
 #include "SPILock.h"
 #include "SafeFile.h"
+#include "SaveScheduler.h"
 #include "TypeConversions.h"
 #include "error.h"
 #include "main.h"
@@ -537,9 +538,18 @@ void NodeDB::installDefaultNodeDatabase()
 {
     LOG_DEBUG("Install default NodeDatabase");
     nodeDatabase.version = DEVICESTATE_CUR_VER;
-    nodeDatabase.nodes = std::vector<meshtastic_NodeInfoLite>(MAX_NUM_NODES);
     numMeshNodes = 0;
-    meshNodes = &nodeDatabase.nodes;
+#ifdef ARCH_PORTDUINO
+    if (mappedNodes.isOpen()) {
+        std::fill(meshNodes->begin(), meshNodes->end(), meshtastic_NodeInfoLite());
+        mappedNodes.setCount(0);
+    } else
+#endif
+    {
+        nodeDatabase.nodes = std::vector<meshtastic_NodeInfoLite>(MAX_NUM_NODES);
+        nodeTable.bind(nodeDatabase.nodes.data(), nodeDatabase.nodes.size());
+    }
+    rebuildHotTable();
 }
 
 void NodeDB::installDefaultConfig(bool preserveKey = false)
@@ -1037,8 +1047,9 @@ void NodeDB::resetNodes(bool keepFavorites)
         };
     } else {
         LOG_INFO("Clearing node database - removing favorites");
-        std::fill(nodeDatabase.nodes.begin() + 1, nodeDatabase.nodes.end(), meshtastic_NodeInfoLite());
+        std::fill(meshNodes->begin() + 1, meshNodes->end(), meshtastic_NodeInfoLite());
     }
+    rebuildHotTable();
     devicestate.has_rx_text_message = false;
     devicestate.has_rx_waypoint = false;
     saveNodeDatabaseToDisk();
@@ -1057,8 +1068,8 @@ void NodeDB::removeNodeByNum(NodeNum nodeNum)
             removed++;
     }
     numMeshNodes -= removed;
-    std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + 1,
-              meshtastic_NodeInfoLite());
+    std::fill(meshNodes->begin() + numMeshNodes, meshNodes->begin() + numMeshNodes + 1, meshtastic_NodeInfoLite());
+    rebuildHotTable();
     LOG_DEBUG("NodeDB::removeNodeByNum purged %d entries. Save changes", removed);
     saveNodeDatabaseToDisk();
 }
@@ -1093,8 +1104,8 @@ void NodeDB::cleanupMeshDB()
         }
     }
     numMeshNodes -= removed;
-    std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + removed,
-              meshtastic_NodeInfoLite());
+    std::fill(meshNodes->begin() + numMeshNodes, meshNodes->begin() + numMeshNodes + removed, meshtastic_NodeInfoLite());
+    rebuildHotTable();
     LOG_DEBUG("cleanupMeshDB purged %d entries", removed);
 }
 
@@ -1161,6 +1172,38 @@ void NodeDB::pickNewNodeNum()
     myNodeInfo.my_node_num = nodeNum;
 }
 
+#ifdef FSCom
+/// State for checkedReadcb, so we can checksum a file while nanopb decodes it
+struct CheckedFileReader {
+    File *file;
+    uint32_t crc;
+};
+
+/// Like readcb, but also feeds every byte consumed into a CRC32 (our stream length already stops at the SafeFile footer)
+static bool checkedReadcb(pb_istream_t *stream, uint8_t *buf, size_t count)
+{
+    auto reader = (CheckedFileReader *)stream->state;
+
+    if (buf == NULL) {
+        // nanopb is skipping an unknown field, but those bytes still count towards the CRC
+        uint8_t skip[16];
+        while (count > 0) {
+            size_t n = count < sizeof(skip) ? count : sizeof(skip);
+            if (reader->file->read(skip, n) != (int)n)
+                return false;
+            reader->crc = SafeFile::updateCRC(reader->crc, skip, n);
+            count -= n;
+        }
+        return true;
+    }
+
+    if (reader->file->read(buf, count) != (int)count)
+        return false;
+    reader->crc = SafeFile::updateCRC(reader->crc, buf, count);
+    return true;
+}
+#endif
+
 /** Load a protobuf from a file, return LoadFileResult */
 LoadFileResult NodeDB::loadProto(const char *filename, size_t protoSize, size_t objSize, const pb_msgdesc_t *fields,
                                  void *dest_struct)
@@ -1173,12 +1216,25 @@ LoadFileResult NodeDB::loadProto(const char *filename, size_t protoSize, size_t
 
     if (f) {
         LOG_INFO("Load %s", filename);
-        pb_istream_t stream = {&readcb, &f, protoSize};
+
+        // Files written by SafeFile carry a CRC footer, which we validate here instead of rereading at every save.
+        // Older files have no footer, those are decoded as before.
+        size_t payloadLength;
+        uint32_t expectedCrc = 0;
+        bool hasFooter = SafeFile::readFooter(f, payloadLength, expectedCrc);
+        if (payloadLength > protoSize)
+            payloadLength = protoSize;
+
+        CheckedFileReader reader = {&f, 0};
+        pb_istream_t stream = {&checkedReadcb, &reader, payloadLength};
         if (fields != &meshtastic_NodeDatabase_msg) // contains a vector object
             memset(dest_struct, 0, objSize);
         if (!pb_decode(&stream, fields, dest_struct)) {
             LOG_ERROR("Error: can't decode protobuf %s", PB_GET_ERROR(&stream));
             state = LoadFileResult::DECODE_FAILED;
+        } else if (hasFooter && reader.crc != expectedCrc) {
+            LOG_ERROR("Error: %s is corrupt (CRC 0x%08x, expected 0x%08x)", filename, reader.crc, expectedCrc);
+            state = LoadFileResult::DECODE_FAILED;
         } else {
             LOG_INFO("Loaded %s successfully", filename);
             state = LoadFileResult::LOAD_SUCCESS;
@@ -1194,6 +1250,39 @@ LoadFileResult NodeDB::loadProto(const char *filename, size_t protoSize, size_t
     return state;
 }
 
+#ifdef ARCH_PORTDUINO
+bool NodeDB::loadMappedNodeDatabase()
+{
+    if (portduino_config.node_database_map == "")
+        return false;
+
+    if (!mappedNodes.open(portduino_config.node_database_map.c_str(), MAX_NUM_NODES, DEVICESTATE_CUR_VER)) {
+        LOG_WARN("Fall back to %s", nodeDatabaseFileName);
+        return false;
+    }
+
+    if (mappedNodes.isFresh()) {
+        // First boot with a map (or the record layout changed), seed it from the last protobuf save
+        auto state = loadProto(nodeDatabaseFileName, getMaxNodesAllocatedSize(), sizeof(meshtastic_NodeDatabase),
+                               &meshtastic_NodeDatabase_msg, &nodeDatabase);
+        if (state == LoadFileResult::LOAD_SUCCESS && nodeDatabase.version >= DEVICESTATE_MIN_VER) {
+            uint32_t count = std::min(nodeDatabase.nodes.size(), mappedNodes.getCapacity());
+            std::copy_n(nodeDatabase.nodes.begin(), count, mappedNodes.getNodes());
+            mappedNodes.setCount(count);
+            LOG_INFO("Copied %u nodes from %s into the node table", count, nodeDatabaseFileName);
+        }
+        // The vector is not used while mapped, don't keep a second copy of the DB around
+        std::vector<meshtastic_NodeInfoLite>().swap(nodeDatabase.nodes);
+    }
+
+    nodeDatabase.version = DEVICESTATE_CUR_VER;
+    nodeTable.bind(mappedNodes.getNodes(), mappedNodes.getCapacity());
+    numMeshNodes = mappedNodes.getCount();
+    rebuildHotTable();
+    return true;
+}
+#endif
+
 void NodeDB::loadFromDisk()
 {
     // Mark the current device state as completely unusable, so that if we fail reading the entire file from
@@ -1242,22 +1331,30 @@ void NodeDB::loadFromDisk()
     }
 
 #endif
-    auto state = loadProto(nodeDatabaseFileName, getMaxNodesAllocatedSize(), sizeof(meshtastic_NodeDatabase),
-                           &meshtastic_NodeDatabase_msg, &nodeDatabase);
-    if (nodeDatabase.version < DEVICESTATE_MIN_VER) {
-        LOG_WARN("NodeDatabase %d is old, discard", nodeDatabase.version);
-        installDefaultNodeDatabase();
-    } else {
-        meshNodes = &nodeDatabase.nodes;
-        numMeshNodes = nodeDatabase.nodes.size();
-        LOG_INFO("Loaded saved nodedatabase version %d, with nodes count: %d", nodeDatabase.version, nodeDatabase.nodes.size());
-    }
+    LoadFileResult state;
+#ifdef ARCH_PORTDUINO
+    if (!loadMappedNodeDatabase())
+#endif
+    {
+        state = loadProto(nodeDatabaseFileName, getMaxNodesAllocatedSize(), sizeof(meshtastic_NodeDatabase),
+                          &meshtastic_NodeDatabase_msg, &nodeDatabase);
+        if (nodeDatabase.version < DEVICESTATE_MIN_VER) {
+            LOG_WARN("NodeDatabase %d is old, discard", nodeDatabase.version);
+            installDefaultNodeDatabase();
+        } else {
+            numMeshNodes = nodeDatabase.nodes.size();
+            LOG_INFO("Loaded saved nodedatabase version %d, with nodes count: %d", nodeDatabase.version,
+                     nodeDatabase.nodes.size());
+        }
 
-    if (numMeshNodes > MAX_NUM_NODES) {
-        LOG_WARN("Node count %d exceeds MAX_NUM_NODES %d, truncating", numMeshNodes, MAX_NUM_NODES);
-        numMeshNodes = MAX_NUM_NODES;
+        if (numMeshNodes > MAX_NUM_NODES) {
+            LOG_WARN("Node count %d exceeds MAX_NUM_NODES %d, truncating", numMeshNodes, MAX_NUM_NODES);
+            numMeshNodes = MAX_NUM_NODES;
+        }
+        nodeDatabase.nodes.resize(MAX_NUM_NODES);
+        nodeTable.bind(nodeDatabase.nodes.data(), nodeDatabase.nodes.size());
+        rebuildHotTable();
     }
-    meshNodes->resize(MAX_NUM_NODES);
 
     // static DeviceState scratch; We no longer read into a tempbuf because this structure is 15KB of valuable RAM
     state = loadProto(deviceStateFileName, meshtastic_DeviceState_size, sizeof(meshtastic_DeviceState),
@@ -1426,11 +1523,12 @@ void NodeDB::loadFromDisk()
 
 /** Save a protobuf from a file, return true for success */
 bool NodeDB::saveProto(const char *filename, size_t protoSize, const pb_msgdesc_t *fields, const void *dest_struct,
-                       bool fullAtomic)
+                       bool fullAtomic, size_t maxSize)
 {
     bool okay = false;
 #ifdef FSCom
     auto f = SafeFile(filename, fullAtomic);
+    f.setMaxSize(maxSize ? maxSize : protoSize);
 
     LOG_INFO("Save %s", filename);
     pb_ostream_t stream = {&writecb, static_cast<Print *>(&f), protoSize};
@@ -1476,6 +1574,13 @@ bool NodeDB::saveDeviceStateToDisk()
 
 bool NodeDB::saveNodeDatabaseToDisk()
 {
+#ifdef ARCH_PORTDUINO
+    if (mappedNodes.isOpen()) {
+        // The records are already in the file, just make sure the kernel has written them out
+        mappedNodes.setCount(numMeshNodes);
+        return mappedNodes.sync();
+    }
+#endif
 #ifdef FSCom
     spiLock->lock();
     FSCom.mkdir("/prefs");
@@ -1483,7 +1588,9 @@ bool NodeDB::saveNodeDatabaseToDisk()
 #endif
     size_t nodeDatabaseSize;
     pb_get_encoded_size(&nodeDatabaseSize, meshtastic_NodeDatabase_fields, &nodeDatabase);
-    return saveProto(nodeDatabaseFileName, nodeDatabaseSize, &meshtastic_NodeDatabase_msg, &nodeDatabase, false);
+    // Encoded to its exact size, but loaded with room for a full DB: the footer fits whenever an older loader reads it all
+    return saveProto(nodeDatabaseFileName, nodeDatabaseSize, &meshtastic_NodeDatabase_msg, &nodeDatabase, false,
+                     getMaxNodesAllocatedSize());
 }
 
 bool NodeDB::saveToDiskNoRetry(int saveWhat)
@@ -1543,6 +1650,8 @@ bool NodeDB::saveToDiskNoRetry(int saveWhat)
 bool NodeDB::saveToDisk(int saveWhat)
 {
     LOG_DEBUG("Save to disk %d", saveWhat);
+    if (saveScheduler)
+        saveScheduler->markClean(saveWhat); // Anything deferred for these segments is covered by this write
     bool success = saveToDiskNoRetry(saveWhat);
 
     if (!success) {
@@ -1562,6 +1671,14 @@ bool NodeDB::saveToDisk(int saveWhat)
     return success;
 }
 
+void NodeDB::scheduleSave(int saveWhat)
+{
+    if (saveScheduler)
+        saveScheduler->markDirty(saveWhat);
+    else
+        saveToDisk(saveWhat);
+}
+
 const meshtastic_NodeInfoLite *NodeDB::readNextMeshNode(uint32_t &readIndex)
 {
     if (readIndex < numMeshNodes)
@@ -1616,11 +1733,13 @@ size_t NodeDB::getNumOnlineMeshNodes(bool localOnly)
 {
     size_t numseen = 0;
 
-    // FIXME this implementation is kinda expensive
+    uint32_t now = getTime();
     for (int i = 0; i < numMeshNodes; i++) {
-        if (localOnly && meshNodes->at(i).via_mqtt)
+        if (localOnly && hot.isViaMqtt(i))
             continue;
-        if (sinceLastSeen(&meshNodes->at(i)) < NUM_ONLINE_SECS)
+        // Same as sinceLastSeen(), but only touching the hot table
+        int delta = (int)(now - hot.getLastHeard(i));
+        if (delta < NUM_ONLINE_SECS)
             numseen++;
     }
 
@@ -1727,6 +1846,7 @@ void NodeDB::addFromContact(meshtastic_SharedContact contact)
         info->has_position = false;
         info->user.public_key.size = 0;
         info->user.public_key.bytes[0] = 0;
+        touchMeshNode(info);
     } else {
         /* Clients are sending add_contact before every text message DM (because clients may hold a larger node database with
          * public keys than the radio holds). However, we don't want to update last_heard just because we sent someone a DM!
@@ -1747,6 +1867,7 @@ void NodeDB::addFromContact(meshtastic_SharedContact contact)
             // last_heard will remain as-is (or remain 0 if this entry wasn't in the nodeDB).
             info->is_favorite = true;
         }
+        touchMeshNode(info);
 
         // As the clients will begin sending the contact with DMs, we want to strictly check if the node is manually verified
         if (contact.manually_verified) {
@@ -1818,6 +1939,7 @@ bool NodeDB::updateUser(uint32_t nodeId, meshtastic_User &p, uint8_t channelInde
     LOG_DEBUG("Update changed=%d user %s/%s, id=0x%08x, channel=%d", changed, info->user.long_name, info->user.short_name, nodeId,
               info->channel);
     info->has_user = true;
+    touchMeshNode(info);
 
     if (changed) {
         updateGUIforNode = info;
@@ -1867,6 +1989,7 @@ void NodeDB::updateFrom(const meshtastic_MeshPacket &mp)
             info->has_hops_away = true;
             info->hops_away = hopsAway;
         }
+        touchMeshNode(info);
         sortMeshDB();
     }
 }
@@ -1876,6 +1999,7 @@ void NodeDB::set_favorite(bool is_favorite, uint32_t nodeId)
     meshtastic_NodeInfoLite *lite = getMeshNode(nodeId);
     if (lite && lite->is_favorite != is_favorite) {
         lite->is_favorite = is_favorite;
+        touchMeshNode(lite);
         sortMeshDB();
         saveNodeDatabaseToDisk();
     }
@@ -1908,23 +2032,21 @@ bool NodeDB::isFromOrToFavoritedNode(const meshtastic_MeshPacket &p)
     if (p.to == NODENUM_BROADCAST)
         return isFavorite(p.from); // we never store NODENUM_BROADCAST in the DB, so we only need to check p.from
 
-    meshtastic_NodeInfoLite *lite = NULL;
-
     bool seenFrom = false;
     bool seenTo = false;
 
     for (int i = 0; i < numMeshNodes; i++) {
-        lite = &meshNodes->at(i);
+        NodeNum num = hot.getNum(i);
 
-        if (lite->num == p.from) {
-            if (lite->is_favorite)
+        if (num == p.from) {
+            if (hot.isFavorite(i))
                 return true;
 
             seenFrom = true;
         }
 
-        if (lite->num == p.to) {
-            if (lite->is_favorite)
+        if (num == p.to) {
+            if (hot.isFavorite(i))
                 return true;
 
             seenTo = true;
@@ -1949,28 +2071,44 @@ void NodeDB::sortMeshDB()
 {
     if (!sortingIsPaused && (lastSort == 0 || !Throttle::isWithinTimespanMs(lastSort, 1000 * 5))) {
         lastSort = millis();
-        bool changed = true;
-        while (changed) { // dumb reverse bubble sort, but probably not bad for what we're doing
-            changed = false;
-            for (int i = numMeshNodes - 1; i > 0; i--) { // lowest case this should examine is i == 1
-                if (meshNodes->at(i - 1).num == getNodeNum()) {
-                    // noop
-                } else if (meshNodes->at(i).num ==
-                           getNodeNum()) { // in the oddball case our own node num is not at location 0, put it there
-                    // TODO: Look for at(i-1) also matching own node num, and throw the DB in the trash
-                    std::swap(meshNodes->at(i), meshNodes->at(i - 1));
-                    changed = true;
-                } else if (meshNodes->at(i).is_favorite && !meshNodes->at(i - 1).is_favorite) {
-                    std::swap(meshNodes->at(i), meshNodes->at(i - 1));
-                    changed = true;
-                } else if (!meshNodes->at(i).is_favorite && meshNodes->at(i - 1).is_favorite) {
-                    // noop
-                } else if (meshNodes->at(i).last_heard > meshNodes->at(i - 1).last_heard) {
-                    std::swap(meshNodes->at(i), meshNodes->at(i - 1));
-                    changed = true;
-                }
+        // Also picks up any hot field someone changed without calling touchMeshNode()
+        rebuildHotTable();
+
+        // Our own node first, then favorites, then most recently heard.  Only the hot table is compared, and each record is
+        // moved at most once afterwards.
+        const NodeNum ourNum = getNodeNum();
+        std::vector<pb_size_t> order(numMeshNodes);
+        for (pb_size_t i = 0; i < numMeshNodes; i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](pb_size_t a, pb_size_t b) {
+            bool aIsUs = hot.getNum(a) == ourNum, bIsUs = hot.getNum(b) == ourNum;
+            if (aIsUs != bIsUs)
+                return aIsUs;
+            if (hot.isFavorite(a) != hot.isFavorite(b))
+                return hot.isFavorite(a);
+            return hot.getLastHeard(a) > hot.getLastHeard(b);
+        });
+
+        // Apply the permutation in place, one cycle at a time, so we never need a second copy of the records
+        bool changed = false;
+        for (pb_size_t start = 0; start < numMeshNodes; start++) {
+            if (order[start] == start)
+                continue;
+            changed = true;
+            meshtastic_NodeInfoLite displaced = meshNodes->at(start);
+            pb_size_t i = start;
+            while (order[i] != start) {
+                pb_size_t from = order[i];
+                meshNodes->at(i) = meshNodes->at(from);
+                order[i] = i;
+                i = from;
             }
+            meshNodes->at(i) = displaced;
+            order[i] = i;
         }
+        if (changed)
+            rebuildHotTable();
+
         LOG_INFO("Sort took %u milliseconds", millis() - lastSort);
     }
 }
@@ -1995,13 +2133,28 @@ std::string NodeDB::getNodeId() const
 /// NOTE: This function might be called from an ISR
 meshtastic_NodeInfoLite *NodeDB::getMeshNode(NodeNum n)
 {
-    for (int i = 0; i < numMeshNodes; i++)
-        if (meshNodes->at(i).num == n)
-            return &meshNodes->at(i);
+    int i = hot.find(n, numMeshNodes);
+    if (i >= 0)
+        return &meshNodes->at(i);
 
     return NULL;
 }
 
+void NodeDB::touchMeshNode(const meshtastic_NodeInfoLite *node)
+{
+    if (node >= meshNodes->begin() && node < meshNodes->begin() + numMeshNodes)
+        hot.set(node - meshNodes->begin(), *node);
+    changeCount++;
+}
+
+void NodeDB::rebuildHotTable()
+{
+    hot.reset(meshNodes->size());
+    for (size_t i = 0; i < numMeshNodes; i++)
+        hot.set(i, meshNodes->at(i));
+    changeCount++;
+}
+
 // returns true if the maximum number of nodes is reached or we are running low on memory
 bool NodeDB::isFull()
 {
@@ -2023,17 +2176,21 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
             int oldestIndex = -1;
             int oldestBoringIndex = -1;
             for (int i = 1; i < numMeshNodes; i++) {
+                uint32_t lastHeard = hot.getLastHeard(i);
+                // Only look at the full record if this node could beat one of the candidates
+                if (hot.isFavorite(i) || (lastHeard >= oldest && lastHeard >= oldestBoring))
+                    continue;
+                const meshtastic_NodeInfoLite &node = meshNodes->at(i);
+                if (node.is_ignored)
+                    continue;
                 // Simply the oldest non-favorite, non-ignored, non-verified node
-                if (!meshNodes->at(i).is_favorite && !meshNodes->at(i).is_ignored &&
-                    !(meshNodes->at(i).bitfield & NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_MASK) &&
-                    meshNodes->at(i).last_heard < oldest) {
-                    oldest = meshNodes->at(i).last_heard;
+                if (!(node.bitfield & NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_MASK) && lastHeard < oldest) {
+                    oldest = lastHeard;
                     oldestIndex = i;
                 }
                 // The oldest "boring" node
-                if (!meshNodes->at(i).is_favorite && !meshNodes->at(i).is_ignored && meshNodes->at(i).user.public_key.size == 0 &&
-                    meshNodes->at(i).last_heard < oldestBoring) {
-                    oldestBoring = meshNodes->at(i).last_heard;
+                if (node.user.public_key.size == 0 && lastHeard < oldestBoring) {
+                    oldestBoring = lastHeard;
                     oldestBoringIndex = i;
                 }
             }
@@ -2046,6 +2203,7 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
                 // Shove the remaining nodes down the chain
                 for (int i = oldestIndex; i < numMeshNodes - 1; i++) {
                     meshNodes->at(i) = meshNodes->at(i + 1);
+                    hot.move(i, i + 1);
                 }
                 (numMeshNodes)--;
             }
@@ -2056,6 +2214,8 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
         // everything is missing except the nodenum
         memset(lite, 0, sizeof(*lite));
         lite->num = n;
+        hot.set(numMeshNodes - 1, *lite);
+        changeCount++;
         LOG_INFO("Adding node to database with %i nodes and %u bytes free!", numMeshNodes, memGet.getFreeHeap());
     }
 
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "MeshTypes.h"
+#include "NodeHotTable.h"
 #include "NodeStatus.h"
 #include "configuration.h"
 #include "mesh-pb-constants.h"
@@ -16,6 +17,7 @@
 
 #if ARCH_PORTDUINO
 #include "PortduinoGlue.h"
+#include "MappedNodeTable.h"
 #endif
 
 #if !defined(MESHTASTIC_EXCLUDE_PKI)
@@ -129,6 +131,37 @@ enum LoadFileResult {
 
 enum UserLicenseStatus { NotKnown, NotLicensed, Licensed };
 
+/**
+ * The node records NodeDB works on, with the subset of the std::vector API callers use.
+ *
+ * Normally this views nodeDatabase.nodes, but on meshtasticd the records may instead live in a memory mapped file
+ * (see MappedNodeTable), so the storage is not always a vector.
+ */
+class NodeInfoLiteTable
+{
+  public:
+    void bind(meshtastic_NodeInfoLite *nodes, size_t count)
+    {
+        data = nodes;
+        length = count;
+    }
+
+    meshtastic_NodeInfoLite &at(size_t i)
+    {
+        assert(i < length);
+        return data[i];
+    }
+    meshtastic_NodeInfoLite &operator[](size_t i) { return data[i]; }
+
+    size_t size() const { return length; }
+    meshtastic_NodeInfoLite *begin() { return data; }
+    meshtastic_NodeInfoLite *end() { return data + length; }
+
+  private:
+    meshtastic_NodeInfoLite *data = nullptr;
+    size_t length = 0;
+};
+
 class NodeDB
 {
     // NodeNum provisionalNodeNum; // if we are trying to find a node num this is our current attempt
@@ -139,7 +172,7 @@ class NodeDB
     // Note: these two references just point into our static array we serialize to/from disk
 
   public:
-    std::vector<meshtastic_NodeInfoLite> *meshNodes;
+    NodeInfoLiteTable *meshNodes = &nodeTable;
     bool updateGUI = false; // we think the gui should definitely be redrawn, screen will clear this once handled
     meshtastic_NodeInfoLite *updateGUIforNode = NULL; // if currently showing this node, we think you should update the GUI
     Observable<const meshtastic::NodeStatus *> newStatus;
@@ -157,6 +190,11 @@ class NodeDB
     bool saveToDisk(int saveWhat = SEGMENT_CONFIG | SEGMENT_MODULECONFIG | SEGMENT_DEVICESTATE | SEGMENT_CHANNELS |
                                    SEGMENT_NODEDATABASE);
 
+    /// Ask for segments to be written to flash soon.  Back-to-back requests are coalesced by the SaveScheduler into a
+    /// single write once things go quiet (or before reboot/sleep).  Falls back to saveToDisk() if there is no scheduler.
+    void scheduleSave(int saveWhat = SEGMENT_CONFIG | SEGMENT_MODULECONFIG | SEGMENT_DEVICESTATE | SEGMENT_CHANNELS |
+                                     SEGMENT_NODEDATABASE);
+
     /** Reinit radio config if needed, because either:
      * a) sometimes a buggy android app might send us bogus settings or
      * b) the client set factory_reset
@@ -240,8 +278,9 @@ class NodeDB
 
     LoadFileResult loadProto(const char *filename, size_t protoSize, size_t objSize, const pb_msgdesc_t *fields,
                              void *dest_struct);
+    /// @param maxSize largest file loadProto is given for it, if not protoSize (the footer is left off past that)
     bool saveProto(const char *filename, size_t protoSize, const pb_msgdesc_t *fields, const void *dest_struct,
-                   bool fullAtomic = true);
+                   bool fullAtomic = true, size_t maxSize = 0);
 
     void installRoleDefaults(meshtastic_Config_DeviceConfig_Role role);
 
@@ -256,6 +295,13 @@ class NodeDB
     virtual meshtastic_NodeInfoLite *getMeshNode(NodeNum n);
     size_t getNumMeshNodes() { return numMeshNodes; }
 
+    /// Call after changing num, last_heard, snr, next_hop, hops_away, channel, via_mqtt or is_favorite of a node
+    /// returned by getMeshNode(), so the scans over the hot table see the new value
+    void touchMeshNode(const meshtastic_NodeInfoLite *node);
+
+    /// Changes whenever nodes may have been added, removed, reordered or updated, so views of the DB know to refresh
+    uint32_t getChangeCount() const { return changeCount; }
+
     UserLicenseStatus getLicenseStatus(uint32_t nodeNum);
 
     size_t getMaxNodesAllocatedSize()
@@ -304,10 +350,24 @@ class NodeDB
     {
         // Notify observers of the current node state
         const meshtastic::NodeStatus status = meshtastic::NodeStatus(getNumOnlineMeshNodes(), getNumMeshNodes(), forceUpdate);
+        changeCount++;
         newStatus.notifyObservers(&status);
     }
 
+#ifndef PIO_UNIT_TESTING
   private:
+#endif
+    NodeInfoLiteTable nodeTable;
+    NodeHotTable hot; // slot i mirrors the hot fields of meshNodes->at(i)
+    uint32_t changeCount = 0;
+#if ARCH_PORTDUINO
+    MappedNodeTable mappedNodes;
+
+    /// Use the memory mapped node table if one is configured
+    /// @return false if we should use the protobuf node database instead
+    bool loadMappedNodeDatabase();
+#endif
+
     bool duplicateWarned = false;
     bool localPositionUpdatedSinceBoot = false;
     uint32_t lastNodeDbSave = 0;    // when we last saved our db to flash
@@ -342,6 +402,9 @@ class NodeDB
     bool saveDeviceStateToDisk();
     bool saveNodeDatabaseToDisk();
     void sortMeshDB();
+
+    /// Refill the hot table from the node records, after they were moved around or replaced wholesale
+    void rebuildHotTable();
 };
 
 extern NodeDB *nodeDB;
@@ -0,0 +1,45 @@
+#include "NodeHotTable.h"
+
+void NodeHotTable::reset(size_t capacity)
+{
+    nums.assign(capacity, 0);
+    lastHeard.assign(capacity, 0);
+    snr.assign(capacity, 0);
+    nextHop.assign(capacity, 0);
+    hopsAway.assign(capacity, 0);
+    channel.assign(capacity, 0);
+    flags.assign(capacity, 0);
+}
+
+void NodeHotTable::set(size_t i, const meshtastic_NodeInfoLite &node)
+{
+    nums[i] = node.num;
+    lastHeard[i] = node.last_heard;
+    snr[i] = node.snr;
+    nextHop[i] = node.next_hop;
+    hopsAway[i] = node.hops_away;
+    channel[i] = node.channel;
+    flags[i] = (node.is_favorite ? HOT_FAVORITE : 0) | (node.has_hops_away ? HOT_HAS_HOPS_AWAY : 0) |
+               (node.via_mqtt ? HOT_VIA_MQTT : 0);
+}
+
+void NodeHotTable::move(size_t dst, size_t src)
+{
+    nums[dst] = nums[src];
+    lastHeard[dst] = lastHeard[src];
+    snr[dst] = snr[src];
+    nextHop[dst] = nextHop[src];
+    hopsAway[dst] = hopsAway[src];
+    channel[dst] = channel[src];
+    flags[dst] = flags[src];
+}
+
+int NodeHotTable::find(NodeNum n, size_t count) const
+{
+    const NodeNum *p = nums.data();
+    for (size_t i = 0; i < count; i++)
+        if (p[i] == n)
+            return i;
+
+    return -1;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "mesh/generated/meshtastic/deviceonly.pb.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * Structure-of-arrays copy of the NodeInfoLite fields the routing hot paths look at.
+ *
+ * A NodeInfoLite is ~200 bytes, mostly user info, position and metrics that lookups, sorting and eviction never read.
+ * Scanning these compact columns instead (4 bytes per node to find a NodeNum) keeps full-DB scans in cache.
+ *
+ * The NodeInfoLite records remain the authoritative copy.  Slot i here always mirrors meshNodes[i]: NodeDB updates the
+ * table whenever it moves records around, and set() must be called after a hot field of a record changes.
+ */
+class NodeHotTable
+{
+  public:
+    /// Make room for capacity slots, all cleared
+    void reset(size_t capacity);
+
+    /// Copy the hot fields of a record into slot i
+    void set(size_t i, const meshtastic_NodeInfoLite &node);
+
+    /// Copy slot src into slot dst
+    void move(size_t dst, size_t src);
+
+    /// @return the slot holding node n among the first count slots, or -1 if none does
+    int find(NodeNum n, size_t count) const;
+
+    NodeNum getNum(size_t i) const { return nums[i]; }
+    uint32_t getLastHeard(size_t i) const { return lastHeard[i]; }
+    float getSnr(size_t i) const { return snr[i]; }
+    uint8_t getNextHop(size_t i) const { return nextHop[i]; }
+    uint8_t getHopsAway(size_t i) const { return hopsAway[i]; }
+    uint8_t getChannel(size_t i) const { return channel[i]; }
+    bool hasHopsAway(size_t i) const { return flags[i] & HOT_HAS_HOPS_AWAY; }
+    bool isFavorite(size_t i) const { return flags[i] & HOT_FAVORITE; }
+    bool isViaMqtt(size_t i) const { return flags[i] & HOT_VIA_MQTT; }
+
+  private:
+    enum : uint8_t { HOT_FAVORITE = 1, HOT_HAS_HOPS_AWAY = 2, HOT_VIA_MQTT = 4 };
+
+    std::vector<NodeNum> nums;
+    std::vector<uint32_t> lastHeard;
+    std::vector<float> snr;
+    std::vector<uint8_t> nextHop;
+    std::vector<uint8_t> hopsAway;
+    std::vector<uint8_t> channel;
+    std::vector<uint8_t> flags;
+};
@@ -89,6 +89,10 @@ bool PacketHistory::wasSeenRecently(const meshtastic_MeshPacket *p, bool withUpd
     PacketRecord *found = find(r.sender, r.id); // Find the packet record in the recentPackets array
     bool seenRecently = (found != NULL);        // If found -> the packet was seen recently
 
+    stats.lookups++;
+    if (seenRecently)
+        stats.duplicates++;
+
     // Check for hop_limit upgrade scenario
     if (seenRecently && wasUpgraded && found->hop_limit < p->hop_limit) {
         LOG_DEBUG("Packet History - Hop limit upgrade: packet 0x%08x from hop_limit=%d to hop_limit=%d", p->id, found->hop_limit,
@@ -28,6 +28,16 @@ class PacketHistory
         0; // Can be set in constructor, no need to recompile. Used to allocate memory for mx_recentPackets.
     PacketRecord *recentPackets = NULL; // Simple and fixed in size. Debloat.
 
+  public:
+    /// How often wasSeenRecently() found the packet already in the history
+    struct Stats {
+        uint32_t lookups;
+        uint32_t duplicates;
+    };
+
+  private:
+    Stats stats = {0, 0};
+
     /** Find a packet record in history.
      * @param sender NodeNum
      * @param id PacketId
@@ -75,4 +85,6 @@ class PacketHistory
 
     // To check if the PacketHistory was initialized correctly by constructor
     bool initOk(void) { return recentPackets != NULL && recentPacketsCapacity != 0; }
+
+    const Stats &getStats() const { return stats; }
 };
@@ -0,0 +1,133 @@
+#include "PacketLatency.h"
+#include "configuration.h"
+
+PacketLatency packetLatency;
+
+volatile uint32_t PacketLatency::rxInterruptUs;
+
+// The stage each hop is measured from
+static const PacketLatency::Stage previousStage[PacketLatency::NUM_STAGES] = {
+    PacketLatency::RX_ISR,    // RX_ISR (no hop)
+    PacketLatency::RX_ISR,    // DELIVERED: reading the radio
+    PacketLatency::DELIVERED, // DEQUEUED: waiting in fromRadioQueue
+    PacketLatency::DEQUEUED,  // DECODED: decryption and protobuf decoding
+    PacketLatency::DECODED,   // HANDLED: the module chain
+    PacketLatency::DECODED,   // TO_PHONE: modules up to the to-phone queue
+    PacketLatency::DECODED,   // TX_QUEUED: deciding to relay or reply
+    PacketLatency::TX_QUEUED, // TX_STARTED: contention backoff and the TX queue
+};
+
+const char *PacketLatency::stageName(Stage stage)
+{
+    switch (stage) {
+    case RX_ISR:
+        return "isr";
+    case DELIVERED:
+        return "radio_read";
+    case DEQUEUED:
+        return "rx_queue";
+    case DECODED:
+        return "decode";
+    case HANDLED:
+        return "modules";
+    case TO_PHONE:
+        return "to_phone";
+    case TX_QUEUED:
+        return "tx_decision";
+    case TX_STARTED:
+        return "tx_queue";
+    default:
+        return "?";
+    }
+}
+
+PacketLatency::Entry *PacketLatency::find(NodeNum from, PacketId id)
+{
+    for (auto &e : entries)
+        if (e.id == id && e.from == from)
+            return &e;
+    return nullptr;
+}
+
+void PacketLatency::mark(const meshtastic_MeshPacket *p, Stage stage)
+{
+    // 0 means 'not reached', losing a usec to make sure a real stamp never is 0 doesn't matter
+    uint32_t now = micros();
+    if (stage == RX_ISR && rxInterruptUs)
+        now = rxInterruptUs;
+    now |= 1;
+
+    Entry *e = find(p->from, p->id);
+    if (!e) {
+        // Only a reception or a send starts following a packet
+        if (stage != RX_ISR && stage != TX_QUEUED)
+            return;
+        e = &entries[nextEntry];
+        nextEntry = (nextEntry + 1) % PACKET_LATENCY_TRACKED;
+        *e = {};
+        e->from = p->from;
+        e->id = p->id;
+    } else if (stage == RX_ISR) {
+        // Heard again, follow this copy through the receive stages
+        for (int s = RX_ISR; s <= TO_PHONE; s++)
+            e->stampUs[s] = 0;
+    }
+
+    if (e->stampUs[stage])
+        return;
+    e->stampUs[stage] = now;
+
+    uint32_t since = e->stampUs[previousStage[stage]];
+    if (stage != RX_ISR && since)
+        histograms[stage].record(now - since);
+}
+
+void PacketLatency::logHistograms() const
+{
+    for (int s = DELIVERED; s < NUM_STAGES; s++) {
+        const Histogram &h = histograms[s];
+        if (!h.count)
+            continue;
+        LOG_INFO("Latency %s: n=%u avg=%uus p50<%uus p99<%uus max=%uus", stageName((Stage)s), h.count,
+                 (uint32_t)(h.totalUs / h.count), h.percentileUs(50), h.percentileUs(99), h.maxUs);
+    }
+}
+
+#ifdef ARCH_PORTDUINO
+void PacketLatency::takeSnapshot()
+{
+    std::string json = buildJson();
+    std::lock_guard<std::mutex> guard(snapshotLock);
+    snapshot.swap(json);
+}
+
+std::string PacketLatency::toJson()
+{
+    std::lock_guard<std::mutex> guard(snapshotLock);
+    return snapshot.empty() ? "[]" : snapshot;
+}
+#endif
+
+std::string PacketLatency::buildJson() const
+{
+    std::string json = "[";
+    char entry[200];
+
+    for (int s = DELIVERED; s < NUM_STAGES; s++) {
+        const Histogram &h = histograms[s];
+        snprintf(entry, sizeof(entry),
+                 "%s{\"hop\":\"%s\",\"count\":%u,\"total_us\":%llu,\"max_us\":%u,\"p50_us\":%u,\"p90_us\":%u,\"p99_us\":%u,"
+                 "\"buckets\":[",
+                 json.size() > 1 ? "," : "", stageName((Stage)s), h.count, (unsigned long long)h.totalUs, h.maxUs,
+                 h.percentileUs(50), h.percentileUs(90), h.percentileUs(99));
+        json += entry;
+        for (int b = 0; b < Histogram::NUM_BUCKETS; b++) {
+            snprintf(entry, sizeof(entry), "%s%u", b ? "," : "", h.buckets[b]);
+            json += entry;
+        }
+        json += "]}";
+    }
+
+    json += "]";
+    return json;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Log2Histogram.h"
+#include "MeshTypes.h"
+#include <string>
+#ifdef ARCH_PORTDUINO
+#include <mutex>
+#endif
+
+// Packets followed through the pipeline at once, older ones are forgotten
+#ifndef PACKET_LATENCY_TRACKED
+#define PACKET_LATENCY_TRACKED 16
+#endif
+
+/**
+ * Timestamps packets as they move through the pipeline and keeps a latency histogram for each hop:
+ *
+ *   radio ISR -> deliverToReceiver -> Router dequeue -> perhapsDecode -> callModules
+ *                                                                    \-> to-phone queue
+ *                                                                    \-> TX queue -> startSend
+ *
+ * MeshPacket is a protobuf struct we can't add fields to, and it gets copied along the way (decoded copies, relays), so
+ * the timestamps live in a small table keyed by from/id instead.  A reception (or a send of our own) claims an entry,
+ * every later stage just records into it, and stages of packets no longer in the table are ignored.
+ *
+ * Only the first time a packet reaches a stage counts, so retransmissions don't show up as huge queueing delays.  A
+ * packet heard again (relayed by someone else) goes through the receive stages again though.
+ */
+class PacketLatency
+{
+  public:
+    enum Stage : uint8_t {
+        RX_ISR,     // radio raised its RX done interrupt
+        DELIVERED,  // packet handed to the router's fromRadioQueue
+        DEQUEUED,   // Router thread picked it up
+        DECODED,    // perhapsDecode done
+        HANDLED,    // all modules have seen it
+        TO_PHONE,   // queued for the phone
+        TX_QUEUED,  // queued for transmission (relay, reply or our own)
+        TX_STARTED, // on air
+        NUM_STAGES
+    };
+
+    /// One hop's latency, the last bucket holds everything from ~8 sec up
+    using Histogram = Log2Histogram<24>;
+
+    /// micros() when the radio last raised its RX interrupt, written by the ISR
+    static volatile uint32_t rxInterruptUs;
+
+    /// Record that a packet reached stage
+    void mark(const meshtastic_MeshPacket *p, Stage stage);
+
+    /// @return the histogram of the hop ending at stage (RX_ISR has none)
+    const Histogram &getHistogram(Stage stage) const { return histograms[stage]; }
+
+    static const char *stageName(Stage stage);
+
+    /// Log one line per hop that has seen packets
+    void logHistograms() const;
+
+    /// @return a JSON array with the statistics of every hop, main thread only
+    std::string buildJson() const;
+
+#ifdef ARCH_PORTDUINO
+    /// Keep what buildJson() gives now for toJson(), main thread only (AirTime calls this every second)
+    void takeSnapshot();
+
+    /// @return the JSON of the last snapshot.  Safe to call from any thread (the web server).
+    std::string toJson();
+#endif
+
+  private:
+    struct Entry {
+        NodeNum from;
+        PacketId id;
+        uint32_t stampUs[NUM_STAGES]; // 0 = not reached
+    };
+
+    Entry entries[PACKET_LATENCY_TRACKED] = {};
+    uint8_t nextEntry = 0;
+    Histogram histograms[NUM_STAGES];
+
+#ifdef ARCH_PORTDUINO
+    std::mutex snapshotLock;
+    std::string snapshot;
+#endif
+
+    Entry *find(NodeNum from, PacketId id);
+};
+
+extern PacketLatency packetLatency;
@@ -1,9 +1,11 @@
 #include "RadioInterface.h"
 #include "Channels.h"
+#include "CongestionControl.h"
 #include "DisplayFormatters.h"
 #include "MeshRadio.h"
 #include "MeshService.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "Router.h"
 #include "configuration.h"
 #include "main.h"
@@ -253,9 +255,10 @@ uint32_t RadioInterface::getRetransmissionMsec(const meshtastic_MeshPacket *p)
     // Make sure enough time has elapsed for this packet to be sent and an ACK is received.
     // LOG_DEBUG("Waiting for flooding message with airtime %d and slotTime is %d", packetAirtime, slotTimeMsec);
     float channelUtil = airTime->channelUtilizationPercent();
-    uint8_t CWsize = map(channelUtil, 0, 100, CWmin, CWmax);
+    uint8_t cwMin = currentCWmin(), cwMax = currentCWmax();
+    uint8_t CWsize = map(channelUtil, 0, 100, cwMin, cwMax);
     // Assuming we pick max. of CWsize and there will be a client with SNR at half the range
-    return 2 * packetAirtime + (pow_of_2(CWsize) + 2 * CWmax + pow_of_2(int((CWmax + CWmin) / 2))) * slotTimeMsec +
+    return 2 * packetAirtime + (pow_of_2(CWsize) + 2 * cwMax + pow_of_2(int((cwMax + cwMin) / 2))) * slotTimeMsec +
            PROCESSING_TIME_MSEC;
 }
 
@@ -266,7 +269,7 @@ uint32_t RadioInterface::getTxDelayMsec()
     The pool to take a random multiple from is the contention window (CW), which size depends on the
     current channel utilization. */
     float channelUtil = airTime->channelUtilizationPercent();
-    uint8_t CWsize = map(channelUtil, 0, 100, CWmin, CWmax);
+    uint8_t CWsize = map(channelUtil, 0, 100, currentCWmin(), currentCWmax());
     // LOG_DEBUG("Current channel utilization is %f so setting CWsize to %d", channelUtil, CWsize);
     return random(0, pow_of_2(CWsize)) * slotTimeMsec;
 }
@@ -280,15 +283,25 @@ uint8_t RadioInterface::getCWsize(float snr)
     // The maximum value for a LoRa SNR
     const int32_t SNR_MAX = 10;
 
-    return map(snr, SNR_MIN, SNR_MAX, CWmin, CWmax);
+    return map(snr, SNR_MIN, SNR_MAX, currentCWmin(), currentCWmax());
+}
+
+uint8_t RadioInterface::currentCWmin()
+{
+    return congestionControl.widen(CWmin);
+}
+
+uint8_t RadioInterface::currentCWmax()
+{
+    return congestionControl.widen(CWmax);
 }
 
 /** The worst-case SNR_based packet delay */
 uint32_t RadioInterface::getTxDelayMsecWeightedWorst(float snr)
 {
     uint8_t CWsize = getCWsize(snr);
-    // offset the maximum delay for routers: (2 * CWmax * slotTimeMsec)
-    return (2 * CWmax * slotTimeMsec) + pow_of_2(CWsize) * slotTimeMsec;
+    // offset the maximum delay for routers: (2 * CWmax * slotTimeMsec), with CWmax as widened
+    return (2 * currentCWmax() * slotTimeMsec) + pow_of_2(CWsize) * slotTimeMsec;
 }
 
 /** Returns true if we should rebroadcast early like a ROUTER */
@@ -315,8 +328,8 @@ uint32_t RadioInterface::getTxDelayMsecWeighted(meshtastic_MeshPacket *p)
         delay = random(0, 2 * CWsize) * slotTimeMsec;
         LOG_DEBUG("rx_snr found in packet. Router: setting tx delay:%d", delay);
     } else {
-        // offset the maximum delay for routers: (2 * CWmax * slotTimeMsec)
-        delay = (2 * CWmax * slotTimeMsec) + random(0, pow_of_2(CWsize)) * slotTimeMsec;
+        // offset the maximum delay for routers: (2 * CWmax * slotTimeMsec), with CWmax as widened so routers still go first
+        delay = (2 * currentCWmax() * slotTimeMsec) + random(0, pow_of_2(CWsize)) * slotTimeMsec;
         LOG_DEBUG("rx_snr found in packet. Setting tx delay:%d", delay);
     }
 
@@ -396,6 +409,11 @@ bool RadioInterface::init()
 {
     LOG_INFO("Start meshradio init");
 
+#ifdef ARCH_PORTDUINO
+    if (portduino_config.lora_congestion_control)
+        congestionControl.setEnabled(true);
+#endif
+
     configChangedObserver.observe(&service->configChanged);
     preflightSleepObserver.observe(&preflightSleep);
     notifyDeepSleepObserver.observe(&notifyDeepSleep);
@@ -702,7 +720,8 @@ void RadioInterface::deliverToReceiver(meshtastic_MeshPacket *p)
 {
     if (router) {
         p->transport_mechanism = meshtastic_MeshPacket_TransportMechanism_TRANSPORT_LORA;
-        router->enqueueReceivedMessage(p);
+        packetLatency.mark(p, PacketLatency::DELIVERED);
+        router->enqueueFromRadio(p);
     }
 }
 
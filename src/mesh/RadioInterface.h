@@ -176,6 +176,10 @@ class RadioInterface
     /** The CW to use when calculating SNR_based delays */
     uint8_t getCWsize(float snr);
 
+    /** The CW size bounds in use, CWmin/CWmax unless congestion control moved them */
+    uint8_t currentCWmin();
+    uint8_t currentCWmax();
+
     /** The worst-case SNR_based packet delay */
     uint32_t getTxDelayMsecWeightedWorst(float snr);
 
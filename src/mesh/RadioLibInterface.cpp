@@ -1,6 +1,7 @@
 #include "RadioLibInterface.h"
 #include "MeshTypes.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "PowerMon.h"
 #include "SPILock.h"
 #include "Throttle.h"
@@ -12,7 +13,9 @@
 #include <pb_encode.h>
 
 #if ARCH_PORTDUINO
+#include "PacketCapture.h"
 #include "PortduinoGlue.h"
+#include "RadioIrqThread.h"
 #include "meshUtils.h"
 #endif
 void LockingArduinoHal::spiBeginTransaction()
@@ -33,6 +36,29 @@ void LockingArduinoHal::spiTransfer(uint8_t *out, size_t len, uint8_t *in)
 {
     spi->transfer(out, in, len);
 }
+
+void LockingArduinoHal::attachInterrupt(uint32_t interruptNum, void (*interruptCb)(void), uint32_t mode)
+{
+    if (radioIrqThread && interruptNum == pinToInterrupt(radioIrqThread->getPin()))
+        radioIrqThread->setCallback(interruptCb); // RadioLib only ever asks for RISING
+    else
+        ArduinoHal::attachInterrupt(interruptNum, interruptCb, mode);
+}
+
+void LockingArduinoHal::detachInterrupt(uint32_t interruptNum)
+{
+    if (radioIrqThread && interruptNum == pinToInterrupt(radioIrqThread->getPin()))
+        radioIrqThread->setCallback(nullptr);
+    else
+        ArduinoHal::detachInterrupt(interruptNum);
+}
+
+uint32_t LockingArduinoHal::digitalRead(uint32_t pin)
+{
+    if (radioIrqThread && pin == (uint32_t)radioIrqThread->getPin())
+        return radioIrqThread->read();
+    return ArduinoHal::digitalRead(pin);
+}
 #endif
 
 RadioLibInterface::RadioLibInterface(LockingArduinoHal *hal, RADIOLIB_PIN_TYPE cs, RADIOLIB_PIN_TYPE irq, RADIOLIB_PIN_TYPE rst,
@@ -68,6 +94,7 @@ void INTERRUPT_ATTR RadioLibInterface::isrLevel0Common(PendingISR cause)
 
 void INTERRUPT_ATTR RadioLibInterface::isrRxLevel0()
 {
+    PacketLatency::rxInterruptUs = micros();
     isrLevel0Common(ISR_RX);
 }
 
@@ -188,6 +215,7 @@ ErrorCode RadioLibInterface::send(meshtastic_MeshPacket *p)
         packetPool.release(p);
         return res;
     }
+    packetLatency.mark(p, PacketLatency::TX_QUEUED);
 
     // set (random) transmit delay to let others reconfigure their radio,
     // to avoid collisions and implement timing-based flooding
@@ -410,7 +438,7 @@ void RadioLibInterface::completeSending()
     if (p) {
         // Packet has been sent, count it toward our TX airtime utilization.
         uint32_t xmitMsec = getPacketTime(p);
-        airTime->logAirtime(TX_LOG, xmitMsec);
+        airTime->logAirtime(TX_LOG, xmitMsec, p->from);
 
         txGood++;
         if (!isFromUs(p))
@@ -451,6 +479,8 @@ void RadioLibInterface::handleReceiveInterrupt()
     if (portduino_config.logoutputlevel == level_trace) {
         printBytes("Raw incoming packet: ", (uint8_t *)&radioBuffer, length);
     }
+    if (state == RADIOLIB_ERR_NONE)
+        capturePacket(false, length, rxMsec);
 #endif
     if (state != RADIOLIB_ERR_NONE) {
         LOG_ERROR("Ignore received packet due to error=%d (maybe to=0x%08x, from=0x%08x, flags=0x%02x)", state,
@@ -494,6 +524,7 @@ void RadioLibInterface::handleReceiveInterrupt()
             // If hop_start is not set, next_hop and relay_node are invalid (firmware <2.3)
             mp->next_hop = mp->hop_start == 0 ? NO_NEXT_HOP_PREFERENCE : radioBuffer.header.next_hop;
             mp->relay_node = mp->hop_start == 0 ? NO_RELAY_NODE : radioBuffer.header.relay_node;
+            packetLatency.mark(mp, PacketLatency::RX_ISR);
 
             addReceiveMetadata(mp);
 
@@ -505,7 +536,7 @@ void RadioLibInterface::handleReceiveInterrupt()
 
             printPacket("Lora RX", mp);
 
-            airTime->logAirtime(RX_LOG, rxMsec);
+            airTime->logAirtime(RX_LOG, rxMsec, mp->from);
 
             deliverToReceiver(mp);
         }
@@ -530,6 +561,21 @@ void RadioLibInterface::setStandby()
     powerMon->clearState(meshtastic_PowerMon_State_Lora_TXOn);
 }
 
+#if ARCH_PORTDUINO
+void RadioLibInterface::capturePacket(bool transmitted, size_t len, uint32_t airtimeMs)
+{
+    if (!packetCapture)
+        return;
+
+    PacketCapture::RadioInfo radio = {getFreq(), bw, sf, cr, 0, 0, airtimeMs};
+    if (!transmitted) {
+        radio.rssi = iface->getRSSI();
+        radio.snr = iface->getSNR();
+    }
+    packetCapture->capture(transmitted, (uint8_t *)&radioBuffer, len, radio);
+}
+#endif
+
 /** start an immediate transmit */
 bool RadioLibInterface::startSend(meshtastic_MeshPacket *txp)
 {
@@ -558,6 +604,10 @@ bool RadioLibInterface::startSend(meshtastic_MeshPacket *txp)
             // bits
             enableInterrupt(isrTxLevel0);
             lastTxStart = millis();
+            packetLatency.mark(txp, PacketLatency::TX_STARTED);
+#if ARCH_PORTDUINO
+            capturePacket(true, numbytes, getPacketTime(txp));
+#endif
             printPacket("Started Tx", txp);
         }
 
@@ -32,6 +32,10 @@ class LockingArduinoHal : public ArduinoHal
 #if ARCH_PORTDUINO
     void spiTransfer(uint8_t *out, size_t len, uint8_t *in) override;
 
+    // The radio IRQ pin may be served by RadioIrqThread rather than the GPIO emulation
+    void attachInterrupt(uint32_t interruptNum, void (*interruptCb)(void), uint32_t mode) override;
+    void detachInterrupt(uint32_t interruptNum) override;
+    uint32_t digitalRead(uint32_t pin) override;
 #endif
 };
 
@@ -190,6 +194,11 @@ class RadioLibInterface : public RadioInterface, protected concurrency::Notified
 
     meshtastic_QueueStatus getQueueStatus();
 
+#if ARCH_PORTDUINO
+    /// Hand the frame in radioBuffer to packetCapture, if capturing is enabled
+    void capturePacket(bool transmitted, size_t len, uint32_t airtimeMs);
+#endif
+
   protected:
     uint32_t activeReceiveStart = 0;
 
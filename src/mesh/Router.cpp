@@ -4,6 +4,7 @@
 #include "MeshRadio.h"
 #include "MeshService.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "RTC.h"
 
 #include "configuration.h"
@@ -23,9 +24,6 @@
 #include "serialization/MeshPacketSerializer.h"
 #endif
 
-#define MAX_RX_FROMRADIO                                                                                                         \
-    4 // max number of packets destined to our queue, we dispatch packets quickly so it doesn't need to be big
-
 // I think this is right, one packet for each of the three fifos + one packet being currently assembled for TX or RX
 // And every TX packet might have a retransmission packet or an ack alive at any moment
 
@@ -63,7 +61,7 @@ static uint8_t bytes[MAX_LORA_PAYLOAD_LEN + 1] __attribute__((__aligned__));
  *
  * Currently we only allow one interface, that may change in the future
  */
-Router::Router() : concurrency::OSThread("Router"), fromRadioQueue(MAX_RX_FROMRADIO)
+Router::Router() : concurrency::OSThread("Router"), fromOtherQueue(MAX_RX_FROMRADIO)
 {
     // This is called pre main(), don't touch anything here, the following code is not safe
 
@@ -72,6 +70,7 @@ Router::Router() : concurrency::OSThread("Router"), fromRadioQueue(MAX_RX_FROMRA
     LOG_DEBUG("Size of MeshPacket %d", sizeof(MeshPacket)); */
 
     fromRadioQueue.setReader(this);
+    fromOtherQueue.setReader(this);
 
     // init Lockguard for crypt operations
     assert(!cryptLock);
@@ -136,8 +135,9 @@ bool Router::shouldDecrementHopLimit(const meshtastic_MeshPacket *p)
 int32_t Router::runOnce()
 {
     meshtastic_MeshPacket *mp;
-    while ((mp = fromRadioQueue.dequeuePtr(0)) != NULL) {
+    while ((mp = fromRadioQueue.dequeuePtr(0)) != NULL || (mp = fromOtherQueue.dequeuePtr(0)) != NULL) {
         // printPacket("handle fromRadioQ", mp);
+        packetLatency.mark(mp, PacketLatency::DEQUEUED);
         perhapsHandleReceived(mp);
     }
 
@@ -146,17 +146,16 @@ int32_t Router::runOnce()
 }
 
 /**
- * RadioInterface calls this to queue up packets that have been received from the radio.  The router is now responsible for
- * freeing the packet
+ * Queue up a packet received from anywhere but our radio.  The router is now responsible for freeing the packet
  */
 void Router::enqueueReceivedMessage(meshtastic_MeshPacket *p)
 {
     // Try enqueue until successful
-    while (!fromRadioQueue.enqueue(p, 0)) {
+    while (!fromOtherQueue.enqueue(p, 0)) {
         meshtastic_MeshPacket *old_p;
-        old_p = fromRadioQueue.dequeuePtr(0); // Dequeue and discard the oldest packet
+        old_p = fromOtherQueue.dequeuePtr(0); // Dequeue and discard the oldest packet
         if (old_p) {
-            printPacket("fromRadioQ full, drop oldest!", old_p);
+            printPacket("fromOtherQ full, drop oldest!", old_p);
             packetPool.release(old_p);
         }
     }
@@ -164,6 +163,21 @@ void Router::enqueueReceivedMessage(meshtastic_MeshPacket *p)
     setReceivedMessage();
 }
 
+/**
+ * RadioInterface calls this to queue up packets that have been received from the radio.  The router is now responsible for
+ * freeing the packet
+ */
+void Router::enqueueFromRadio(meshtastic_MeshPacket *p)
+{
+    // Only the reader may take packets out, so when we are this far behind the newest one has to go
+    if (!fromRadioQueue.enqueue(p, 0)) {
+        printPacket("fromRadioQ full, drop!", p);
+        packetPool.release(p);
+    }
+    // Nasty hack because our threading is primitive.  interfaces shouldn't need to know about routers FIXME
+    setReceivedMessage();
+}
+
 /// Generate a unique packet id
 // FIXME, move this someplace better
 PacketId generatePacketId()
@@ -696,6 +710,7 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
 
     // Take those raw bytes and convert them back into a well structured protobuf we can understand
     auto decodedState = perhapsDecode(p);
+    packetLatency.mark(p, PacketLatency::DECODED);
     if (decodedState == DecodeState::DECODE_FATAL) {
         // Fatal decoding error, we can't do anything with this packet
         LOG_WARN("Fatal decode error, dropping packet");
@@ -743,6 +758,7 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
     // If this could be a spoofed packet, don't let the modules see it.
     if (!skipHandle) {
         MeshModule::callModules(*p, src);
+        packetLatency.mark(p, PacketLatency::HANDLED);
 
 #if !MESHTASTIC_EXCLUDE_MQTT
         if (p_encrypted == nullptr) {
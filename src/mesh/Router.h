@@ -7,8 +7,12 @@
 #include "PacketHistory.h"
 #include "PointerQueue.h"
 #include "RadioInterface.h"
+#include "SPSCPointerQueue.h"
 #include "concurrency/OSThread.h"
 
+#define MAX_RX_FROMRADIO                                                                                                         \
+    4 // max number of packets destined to our queue, we dispatch packets quickly so it doesn't need to be big
+
 /**
  * A mesh aware router that supports multiple interfaces.
  */
@@ -16,8 +20,11 @@ class Router : protected concurrency::OSThread, protected PacketHistory
 {
   private:
     /// Packets which have just arrived from the radio, ready to be processed by this service and possibly
-    /// forwarded to the phone.
-    PointerQueue<meshtastic_MeshPacket> fromRadioQueue;
+    /// forwarded to the phone.  The radio is the only writer, so this needs no locking even if RX runs elsewhere.
+    SPSCPointerQueue<meshtastic_MeshPacket, MAX_RX_FROMRADIO> fromRadioQueue;
+
+    /// Packets from everywhere else (MQTT, UDP, ourselves), which may be queued from several threads
+    PointerQueue<meshtastic_MeshPacket> fromOtherQueue;
 
   protected:
     RadioInterface *iface = NULL;
@@ -54,6 +61,12 @@ class Router : protected concurrency::OSThread, protected PacketHistory
     /** Attempt to find a packet in the TxQueue. Returns true if the packet was found. */
     bool findInTxQueue(NodeNum from, PacketId id);
 
+    /// Duplicate suppression statistics of our packet history
+    using PacketHistory::getStats;
+
+    /// Number of received packets waiting for runOnce()
+    int getRxQueueDepth() { return fromRadioQueue.numUsed() + fromOtherQueue.numUsed(); }
+
     /** Allocate and return a meshpacket which defaults as send to broadcast from the current node.
      * The returned packet is guaranteed to have a unique packet ID already assigned
      */
@@ -72,11 +85,17 @@ class Router : protected concurrency::OSThread, protected PacketHistory
     void setReceivedMessage();
 
     /**
-     * RadioInterface calls this to queue up packets that have been received from the radio.  The router is now responsible for
+     * Queue up a packet received from anywhere but our radio (MQTT, UDP, ourselves).  The router is now responsible for
      * freeing the packet
      */
     virtual void enqueueReceivedMessage(meshtastic_MeshPacket *p);
 
+    /**
+     * RadioInterface calls this to queue up packets that have been received from the radio.  The router is now responsible for
+     * freeing the packet.  Must only be called from one thread (or ISR), whichever receives from the radio.
+     */
+    void enqueueFromRadio(meshtastic_MeshPacket *p);
+
     /**
      * Send a packet on a suitable interface.  This routine will
      * later free() the packet to pool.  This routine is not allowed to stall.
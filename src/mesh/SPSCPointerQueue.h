@@ -0,0 +1,110 @@
+#pragma once
+
+#include "concurrency/OSThread.h"
+#include "freertosinc.h"
+#include <atomic>
+#include <stdint.h>
+
+// Keep the producer's and the consumer's index on separate cache lines so they don't bounce between cores
+#ifndef SPSC_CACHE_LINE
+#ifdef ARCH_PORTDUINO
+#define SPSC_CACHE_LINE 64
+#else
+#define SPSC_CACHE_LINE 4 // internal SRAM of our MCUs isn't behind a data cache, nothing to gain from padding
+#endif
+#endif
+
+/**
+ * A lock free single producer / single consumer circular buffer of pointers.
+ *
+ * One thread (or ISR) may enqueue while another dequeues, without locks or critical sections: each side only ever
+ * writes its own index.  Each side also keeps its last look at the other side's index, so it only has to read the
+ * other side's cache line when the queue looks full (or empty).
+ *
+ * Only aligned 32 bit loads and stores are needed, which every arch we run on does natively, so this is safe from an
+ * ISR too.  Same interface as StaticPointerQueue.  With more than one producer (or consumer) the callers must serialize.
+ */
+template <class T, int MaxElements> class SPSCPointerQueue
+{
+    static_assert(MaxElements > 0 && (MaxElements & (MaxElements - 1)) == 0, "MaxElements must be a power of two");
+
+    // Free running counts, written by the producer (head) or the consumer (tail) only
+    alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> head{0};
+    uint32_t tailSeen = 0; // producer's copy of tail
+    alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> tail{0};
+    uint32_t headSeen = 0; // consumer's copy of head
+
+    alignas(SPSC_CACHE_LINE) T *buffer[MaxElements] = {};
+    concurrency::OSThread *reader = nullptr;
+
+    bool push(T *x)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tailSeen >= (uint32_t)MaxElements) {
+            tailSeen = tail.load(std::memory_order_acquire);
+            if (h - tailSeen >= (uint32_t)MaxElements)
+                return false; // Queue is full
+        }
+
+        buffer[h & (MaxElements - 1)] = x;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+  public:
+    int numFree() const { return MaxElements - numUsed(); }
+
+    bool isEmpty() const { return numUsed() == 0; }
+
+    int numUsed() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+    bool enqueue(T *x, TickType_t maxWait = portMAX_DELAY)
+    {
+        if (!push(x))
+            return false;
+
+        if (reader) {
+            reader->setInterval(0);
+            concurrency::mainDelay.interrupt();
+        }
+        return true;
+    }
+
+    bool enqueueFromISR(T *x, BaseType_t *higherPriWoken)
+    {
+        if (!push(x))
+            return false;
+
+        if (reader) {
+            reader->setInterval(0);
+            concurrency::mainDelay.interruptFromISR(higherPriWoken);
+        }
+        return true;
+    }
+
+    bool dequeue(T **p, TickType_t maxWait = portMAX_DELAY)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == headSeen) {
+            headSeen = head.load(std::memory_order_acquire);
+            if (t == headSeen)
+                return false; // Queue is empty
+        }
+
+        *p = buffer[t & (MaxElements - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // returns a ptr or null if the queue was empty
+    T *dequeuePtr(TickType_t maxWait = portMAX_DELAY)
+    {
+        T *p;
+        return dequeue(&p, maxWait) ? p : nullptr;
+    }
+
+    void setReader(concurrency::OSThread *t) { reader = t; }
+
+    // For compatibility with PointerQueue interface
+    int getMaxLen() const { return MaxElements; }
+};
@@ -0,0 +1,104 @@
+#include "SaveScheduler.h"
+#include "NodeDB.h"
+#include "sleep.h"
+
+SaveScheduler *saveScheduler;
+
+static uint8_t countSegments(int saveWhat)
+{
+    uint8_t n = 0;
+    for (; saveWhat; saveWhat &= saveWhat - 1)
+        n++;
+    return n;
+}
+
+SaveScheduler::SaveScheduler() : concurrency::OSThread("SaveScheduler")
+{
+    deepSleepObserver.observe(&notifyDeepSleep);
+    rebootObserver.observe(&notifyReboot);
+#ifdef ARCH_ESP32
+    lightSleepObserver.observe(&notifyLightSleep);
+#endif
+    disable(); // Nothing to do until someone marks a segment dirty
+}
+
+void SaveScheduler::markDirty(int saveWhat)
+{
+    uint32_t now = millis();
+
+    writesRequested += countSegments(saveWhat);
+    writesAvoided += countSegments(saveWhat & pendingSegments);
+
+    if (!pendingSegments)
+        firstDirtyMs = now;
+    lastDirtyMs = now;
+    pendingSegments |= saveWhat;
+
+    LOG_DEBUG("Defer save of segments %d (pending %d)", saveWhat, pendingSegments);
+
+    enabled = true;
+    setIntervalFromNow(msecUntilDue());
+}
+
+void SaveScheduler::markClean(int saveWhat)
+{
+    // Whatever was waiting for these segments just got written by someone else
+    writesAvoided += countSegments(saveWhat & pendingSegments);
+    pendingSegments &= ~saveWhat;
+}
+
+uint32_t SaveScheduler::msecUntilDue() const
+{
+    uint32_t now = millis();
+    uint32_t quietDue = lastDirtyMs + SAVE_SCHEDULER_QUIET_MS;
+    uint32_t maxDue = firstDirtyMs + SAVE_SCHEDULER_MAX_DELAY_MS;
+    uint32_t due = ((int32_t)(maxDue - quietDue) < 0) ? maxDue : quietDue;
+
+    return ((int32_t)(due - now) > 0) ? (due - now) : 0;
+}
+
+bool SaveScheduler::flush()
+{
+    if (!pendingSegments || !nodeDB)
+        return true;
+
+    int saveWhat = pendingSegments;
+    pendingSegments = 0;
+    uint32_t start = millis();
+
+    bool success = nodeDB->saveToDisk(saveWhat);
+
+    lastFlushMs = millis() - start;
+    if (lastFlushMs > maxFlushMs)
+        maxFlushMs = lastFlushMs;
+    flushCount++;
+
+    LOG_INFO("Flushed segments %d in %u ms (flushes=%u, requested=%u, avoided=%u)", saveWhat, lastFlushMs, flushCount,
+             writesRequested, writesAvoided);
+    return success;
+}
+
+int32_t SaveScheduler::runOnce()
+{
+    if (!pendingSegments)
+        return disable();
+
+    uint32_t wait = msecUntilDue();
+    if (wait > 0)
+        return wait; // Got more changes since we were scheduled
+
+    flush();
+    return disable();
+}
+
+int SaveScheduler::beforeDeepSleep(void *unused)
+{
+    flush();
+    return 0;
+}
+
+int SaveScheduler::beforeReboot(void *unused)
+{
+    flush();
+    return 0;
+}
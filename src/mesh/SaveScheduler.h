@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Observer.h"
+#include "concurrency/OSThread.h"
+#include "configuration.h"
+
+// How long the config must stay untouched before pending segments are written out
+#ifndef SAVE_SCHEDULER_QUIET_MS
+#define SAVE_SCHEDULER_QUIET_MS 2000
+#endif
+
+// Upper bound on how long a dirty segment may wait, so a steady trickle of changes can't starve the flush
+#ifndef SAVE_SCHEDULER_MAX_DELAY_MS
+#define SAVE_SCHEDULER_MAX_DELAY_MS (15 * 1000)
+#endif
+
+/**
+ * Coalesces NodeDB::saveToDisk() requests.
+ *
+ * Callers mark SEGMENT_* bits dirty instead of writing immediately.  Once no new changes have arrived for
+ * SAVE_SCHEDULER_QUIET_MS (or the oldest change is SAVE_SCHEDULER_MAX_DELAY_MS old) every dirty segment is written
+ * exactly once.  Pending segments are also flushed right before reboot and sleep, so nothing is lost.
+ *
+ * A phone applying ten settings in a row therefore costs one rewrite of each touched file, not ten.
+ */
+class SaveScheduler : private concurrency::OSThread
+{
+  public:
+    SaveScheduler();
+
+    /// Mark segments (SEGMENT_* bitmask) as needing a save, they will be written after the quiet period
+    void markDirty(int saveWhat);
+
+    /// Called by NodeDB after a synchronous save, so those segments are no longer considered pending
+    void markClean(int saveWhat);
+
+    /// Write any pending segments right now
+    /// @return true if nothing was pending or the save succeeded
+    bool flush();
+
+    /// @return bitmask of segments waiting to be written
+    int getPendingSegments() const { return pendingSegments; }
+
+    /// Number of segment writes requested through markDirty()
+    uint32_t getWritesRequested() const { return writesRequested; }
+
+    /// Number of segment writes that were folded into an already pending (or just completed) write
+    uint32_t getWritesAvoided() const { return writesAvoided; }
+
+    /// Number of times we actually hit the filesystem
+    uint32_t getFlushCount() const { return flushCount; }
+
+    /// Duration of the most recent / slowest flush, in msec
+    uint32_t getLastFlushMs() const { return lastFlushMs; }
+    uint32_t getMaxFlushMs() const { return maxFlushMs; }
+
+  protected:
+    int32_t runOnce() override;
+
+  private:
+    int pendingSegments = 0;
+    uint32_t firstDirtyMs = 0; // when the oldest pending change was marked
+    uint32_t lastDirtyMs = 0;  // when the newest pending change was marked
+
+    uint32_t writesRequested = 0;
+    uint32_t writesAvoided = 0;
+    uint32_t flushCount = 0;
+    uint32_t lastFlushMs = 0;
+    uint32_t maxFlushMs = 0;
+
+    /// msecs until the pending segments are due to be written
+    uint32_t msecUntilDue() const;
+
+    int beforeDeepSleep(void *unused);
+    int beforeReboot(void *unused);
+
+    CallbackObserver<SaveScheduler, void *> deepSleepObserver =
+        CallbackObserver<SaveScheduler, void *>(this, &SaveScheduler::beforeDeepSleep);
+    CallbackObserver<SaveScheduler, void *> rebootObserver =
+        CallbackObserver<SaveScheduler, void *>(this, &SaveScheduler::beforeReboot);
+#ifdef ARCH_ESP32
+    CallbackObserver<SaveScheduler, void *> lightSleepObserver =
+        CallbackObserver<SaveScheduler, void *>(this, &SaveScheduler::beforeDeepSleep);
+#endif
+};
+
+extern SaveScheduler *saveScheduler;
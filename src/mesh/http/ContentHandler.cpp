@@ -656,6 +656,7 @@ void handleReport(HTTPRequest *req, HTTPResponse *res)
     jsonObjAirtime["rx_log"] = rxLogJsonValue;
     jsonObjAirtime["rx_all_log"] = rxAllLogJsonValue;
     jsonObjAirtime["channel_utilization"] = new JSONValue(airTime->channelUtilizationPercent());
+    jsonObjAirtime["channel_utilization_burst"] = new JSONValue(airTime->channelUtilizationPercent(AIRTIME_BURST_SECONDS));
     jsonObjAirtime["utilization_tx"] = new JSONValue(airTime->utilizationTXPercent());
     jsonObjAirtime["seconds_since_boot"] = new JSONValue(int(airTime->getSecondsSinceBoot()));
     jsonObjAirtime["seconds_per_period"] = new JSONValue(int(airTime->getSecondsPerPeriod()));
@@ -38,10 +38,12 @@ mail:   marchammermann@googlemail.com
 #if __has_include(<ulfius.h>)
 #include "PiWebServer.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "PhoneAPI.h"
 #include "PowerFSM.h"
 #include "RadioLibInterface.h"
 #include "airtime.h"
+#include "concurrency/ThreadProfiler.h"
 #include "graphics/Screen.h"
 #include "main.h"
 #include "mesh/wifi/WiFiAPClient.h"
@@ -302,6 +304,44 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
     return U_CALLBACK_COMPLETE;
 }
 
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+/*
+ * Run time statistics of every OSThread, see ThreadProfiler
+ */
+int handleJsonThreads(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    std::string json = concurrency::ThreadProfiler::toJson();
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_set_string_body_response(res, 200, json.c_str());
+    return U_CALLBACK_COMPLETE;
+}
+#endif
+
+/*
+ * Per hop latency histograms of the packet pipeline, see PacketLatency
+ */
+int handleJsonLatency(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    std::string json = packetLatency.toJson();
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_set_string_body_response(res, 200, json.c_str());
+    return U_CALLBACK_COMPLETE;
+}
+
+/*
+ * Sliding window channel utilization and the nodes using most of the airtime, see AirTime
+ */
+int handleJsonAirtime(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    std::string json = airTime->toJson();
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_set_string_body_response(res, 200, json.c_str());
+    return U_CALLBACK_COMPLETE;
+}
+
 /*
 OpenSSL RSA Key Gen
 */
@@ -503,6 +543,11 @@ PiWebServerThread::PiWebServerThread()
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/fromradio/*", 1, &handleAPIv1FromRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "PUT", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
+#if !MESHTASTIC_EXCLUDE_THREAD_PROFILER
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/threads", 1, &handleJsonThreads, NULL);
+#endif
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/latency", 1, &handleJsonLatency, NULL);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/airtime", 1, &handleJsonAirtime, NULL);
 
         // Add callback function to all endpoints for the Web Server
         ulfius_add_endpoint_by_val(&instanceWeb, "GET", NULL, "/*", 2, &callback_static_file, &configWeb);
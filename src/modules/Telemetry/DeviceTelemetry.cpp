@@ -3,6 +3,7 @@
 #include "Default.h"
 #include "MeshService.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "RadioLibInterface.h"
@@ -149,6 +150,9 @@ meshtastic_Telemetry DeviceTelemetryModule::getLocalStatsTelemetry()
     LOG_INFO("num_packets_tx=%i, num_packets_rx=%i, num_packets_rx_bad=%i", telemetry.variant.local_stats.num_packets_tx,
              telemetry.variant.local_stats.num_packets_rx, telemetry.variant.local_stats.num_packets_rx_bad);
 
+    // LocalStats has no room for these, so they only go to the log
+    packetLatency.logHistograms();
+
     return telemetry;
 }
 
@@ -99,6 +99,7 @@ void NAU7802Sensor::tare()
 bool NAU7802Sensor::saveCalibrationData()
 {
     auto file = SafeFile(nau7802ConfigFileName);
+    file.setMaxSize(meshtastic_Nau7802Config_size);
     nau7802config.zeroOffset = nau7802.getZeroOffset();
     nau7802config.calibrationFactor = nau7802.getCalibrationFactor();
     bool okay = false;
@@ -124,7 +125,13 @@ bool NAU7802Sensor::loadCalibrationData()
     bool okay = false;
     if (file) {
         LOG_INFO("%s state read from %s", sensorName, nau7802ConfigFileName);
-        pb_istream_t stream = {&readcb, &file, meshtastic_Nau7802Config_size};
+        // Stop at the SafeFile footer (if any), so it isn't mistaken for protobuf fields
+        size_t payloadLength;
+        uint32_t crc;
+        SafeFile::readFooter(file, payloadLength, crc);
+        if (payloadLength > meshtastic_Nau7802Config_size)
+            payloadLength = meshtastic_Nau7802Config_size;
+        pb_istream_t stream = {&readcb, &file, payloadLength};
         if (!pb_decode(&stream, &meshtastic_Nau7802Config_msg, &nau7802config)) {
             LOG_ERROR("Error: can't decode protobuf %s", PB_GET_ERROR(&stream));
         } else {
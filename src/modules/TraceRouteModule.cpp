@@ -322,6 +322,7 @@ void TraceRouteModule::maybeSetNextHop(NodeNum target, uint8_t nextHopByte)
     if (node && node->next_hop != nextHopByte) {
         LOG_INFO("Updating next-hop for 0x%08x to 0x%02x based on traceroute", target, nextHopByte);
         node->next_hop = nextHopByte;
+        nodeDB->touchMeshNode(node);
     }
 }
 
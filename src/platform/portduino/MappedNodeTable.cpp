@@ -0,0 +1,99 @@
+#include "MappedNodeTable.h"
+#include "configuration.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAPPED_NODE_TABLE_MAGIC 0x4244444E // "NDDB"
+
+bool MappedNodeTable::open(const char *path, size_t capacity, uint32_t version)
+{
+    close();
+
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Can't open node table %s: %s", path, strerror(errno));
+        return false;
+    }
+
+    size_t headerSize = sysconf(_SC_PAGESIZE);
+    if (headerSize < sizeof(Header))
+        headerSize = sizeof(Header);
+
+    // Check whether the existing file was written with the same layout
+    Header existing = {};
+    struct stat st;
+    fresh = !(fstat(fd, &st) == 0 && (size_t)st.st_size >= headerSize &&
+              pread(fd, &existing, sizeof(existing), 0) == (ssize_t)sizeof(existing) &&
+              existing.magic == MAPPED_NODE_TABLE_MAGIC && existing.version == version &&
+              existing.recordSize == sizeof(meshtastic_NodeInfoLite));
+
+    // Truncating to zero first guarantees a fresh table reads back as all zeros
+    mappedSize = headerSize + capacity * sizeof(meshtastic_NodeInfoLite);
+    if ((fresh && ftruncate(fd, 0) != 0) || ftruncate(fd, mappedSize) != 0) {
+        LOG_ERROR("Can't resize node table %s: %s", path, strerror(errno));
+        close();
+        return false;
+    }
+
+    base = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        LOG_ERROR("Can't map node table %s: %s", path, strerror(errno));
+        close();
+        return false;
+    }
+    // Lookups hop around the table, don't waste page cache on readahead
+    madvise(base, mappedSize, MADV_RANDOM);
+
+    header = static_cast<Header *>(base);
+    nodes = reinterpret_cast<meshtastic_NodeInfoLite *>(static_cast<uint8_t *>(base) + headerSize);
+
+    header->magic = MAPPED_NODE_TABLE_MAGIC;
+    header->version = version;
+    header->recordSize = sizeof(meshtastic_NodeInfoLite);
+    header->capacity = capacity;
+    if (fresh || header->count > capacity)
+        header->count = fresh ? 0 : capacity;
+
+    LOG_INFO("Mapped node table %s, %u of %u records in use%s", path, header->count, header->capacity,
+             fresh ? " (new)" : "");
+    return true;
+}
+
+void MappedNodeTable::close()
+{
+    if (base) {
+        msync(base, mappedSize, MS_SYNC);
+        munmap(base, mappedSize);
+    }
+    if (fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    base = nullptr;
+    mappedSize = 0;
+    header = nullptr;
+    nodes = nullptr;
+}
+
+void MappedNodeTable::setCount(uint32_t count)
+{
+    if (header)
+        header->count = count;
+}
+
+bool MappedNodeTable::sync()
+{
+    if (!base)
+        return false;
+
+    if (msync(base, mappedSize, MS_SYNC) != 0) {
+        LOG_ERROR("Can't sync node table: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
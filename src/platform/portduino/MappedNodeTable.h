@@ -0,0 +1,62 @@
+#pragma once
+
+#include "mesh/generated/meshtastic/deviceonly.pb.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The node database stored as fixed size meshtastic_NodeInfoLite records in a memory mapped file.
+ *
+ * Intended for meshtasticd gateways configured with a very large MaxNodes: the kernel page cache decides which records
+ * stay resident, boot is a single mmap() no matter how many nodes we know about, and saving is an msync() of the dirty
+ * pages rather than a protobuf encode of the entire DB.
+ *
+ * Records are raw structs, so the file is only understood by firmware with the same record layout.  open() notices a
+ * mismatch (magic, version or record size) and starts over with an empty table, which NodeDB then repopulates from
+ * nodes.proto.
+ */
+class MappedNodeTable
+{
+  public:
+    ~MappedNodeTable() { close(); }
+
+    /**
+     * Map the table at path, creating it or resizing it to hold capacity records.
+     * @return false if the file could not be mapped, callers should fall back to the protobuf node database
+     */
+    bool open(const char *path, size_t capacity, uint32_t version);
+
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+
+    /// true if open() had to initialise an empty table (first use, or a layout change)
+    bool isFresh() const { return fresh; }
+
+    meshtastic_NodeInfoLite *getNodes() { return nodes; }
+    size_t getCapacity() const { return header ? header->capacity : 0; }
+
+    /// Number of records in use, persisted in the file header
+    uint32_t getCount() const { return header ? header->count : 0; }
+    void setCount(uint32_t count);
+
+    /// Write dirty pages back to the file
+    bool sync();
+
+  private:
+    /// First page of the file, the records start right after it so they stay page aligned
+    struct Header {
+        uint32_t magic;
+        uint32_t version;    // DEVICESTATE_CUR_VER of the firmware that wrote the file
+        uint32_t recordSize; // sizeof(meshtastic_NodeInfoLite)
+        uint32_t capacity;   // Number of records the file has room for
+        uint32_t count;      // Number of records in use
+    };
+
+    int fd = -1;
+    void *base = nullptr;
+    size_t mappedSize = 0;
+    Header *header = nullptr;
+    meshtastic_NodeInfoLite *nodes = nullptr;
+    bool fresh = false;
+};
@@ -0,0 +1,346 @@
+#include "PacketCapture.h"
+#include "DisplayFormatters.h"
+#include "NodeDB.h"
+#include "configuration.h"
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <sys/time.h>
+
+PacketCapture *packetCapture;
+
+// pcapng block types and option codes
+#define PCAPNG_SECTION_HEADER 0x0A0D0D0A
+#define PCAPNG_INTERFACE_DESCRIPTION 0x00000001
+#define PCAPNG_ENHANCED_PACKET 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_OPT_END 0
+#define PCAPNG_OPT_COMMENT 1
+#define PCAPNG_OPT_SHB_USERAPPL 4
+#define PCAPNG_OPT_IF_NAME 2
+#define PCAPNG_OPT_EPB_FLAGS 2
+#define PCAPNG_EPB_INBOUND 1
+#define PCAPNG_EPB_OUTBOUND 2
+
+// https://www.tcpdump.org/linktypes.html, header format from https://github.com/eriknl/LoRaTap
+#define LINKTYPE_LORATAP 270
+#define LORATAP_HEADER_LEN 15
+#define LORATAP_MESHTASTIC_SYNC_WORD 0x2B
+
+namespace
+{
+
+/// Builds one pcapng block, all fields in host byte order as announced by the section header
+class Block
+{
+  public:
+    explicit Block(uint32_t type)
+    {
+        put32(type);
+        put32(0); // total length, filled in by finish()
+    }
+
+    void put16(uint16_t v) { put(&v, sizeof(v)); }
+    void put32(uint32_t v) { put(&v, sizeof(v)); }
+    void put64(uint64_t v) { put(&v, sizeof(v)); }
+
+    void put(const void *data, size_t len)
+    {
+        const uint8_t *p = (const uint8_t *)data;
+        bytes.insert(bytes.end(), p, p + len);
+    }
+
+    void pad()
+    {
+        while (bytes.size() % 4)
+            bytes.push_back(0);
+    }
+
+    void option(uint16_t code, const void *data, uint16_t len)
+    {
+        put16(code);
+        put16(len);
+        put(data, len);
+        pad();
+    }
+
+    void option(uint16_t code, const char *s) { option(code, s, strlen(s)); }
+
+    const std::vector<uint8_t> &finish()
+    {
+        put16(PCAPNG_OPT_END);
+        put16(0);
+        uint32_t total = bytes.size() + sizeof(uint32_t);
+        put32(total);
+        memcpy(&bytes[4], &total, sizeof(total));
+        return bytes;
+    }
+
+  private:
+    std::vector<uint8_t> bytes;
+};
+
+} // namespace
+
+PacketCapture::PacketCapture(const std::string &path, uint64_t maxBytes, unsigned maxFiles)
+    : path(path), maxBytes(maxBytes), maxFiles(maxFiles ? maxFiles : 1)
+{
+    if (!openFile())
+        return;
+    pending.reserve(64);
+    writer = std::thread(&PacketCapture::run, this);
+}
+
+PacketCapture::~PacketCapture()
+{
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wakeup.notify_one();
+        writer.join();
+    }
+    if (file)
+        fclose(file);
+}
+
+void PacketCapture::capture(bool transmitted, const uint8_t *frame, size_t len, const RadioInfo &radio)
+{
+    if (!writer.joinable())
+        return; // the file could not be opened
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (pending.size() >= PACKET_CAPTURE_MAX_PENDING) {
+        dropped++;
+        return;
+    }
+
+    pending.emplace_back();
+    Frame &f = pending.back();
+    f.timestampUs = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+    f.transmitted = transmitted;
+    f.radio = radio;
+    f.preset = config.lora.use_preset ? DisplayFormatters::getModemPresetDisplayName(config.lora.modem_preset, false, true)
+                                      : "Custom";
+    f.len = (len < sizeof(f.data)) ? len : sizeof(f.data);
+    memcpy(f.data, frame, f.len);
+    wakeup.notify_one();
+}
+
+void PacketCapture::run()
+{
+    std::vector<Frame> batch;
+    batch.reserve(64);
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (!stopping || !pending.empty()) {
+        wakeup.wait(guard, [this] { return stopping || !pending.empty(); });
+        batch.swap(pending);
+        guard.unlock();
+
+        for (const Frame &f : batch)
+            writeFrame(f);
+        if (file)
+            fflush(file);
+        batch.clear();
+
+        guard.lock();
+    }
+}
+
+bool PacketCapture::openFile()
+{
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("Unable to open packet capture %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    fileBytes = 0;
+    writeHeader();
+    return true;
+}
+
+void PacketCapture::rotate()
+{
+    fclose(file);
+    file = nullptr;
+
+    // <file>.N-1 -> <file>.N, ..., <file> -> <file>.1, anything past maxFiles falls off the end
+    for (unsigned i = maxFiles - 1; i > 0; i--) {
+        std::string from = (i == 1) ? path : path + "." + std::to_string(i - 1);
+        std::string to = path + "." + std::to_string(i);
+        rename(from.c_str(), to.c_str());
+    }
+    if (!openFile())
+        LOG_ERROR("Packet capture stopped");
+}
+
+void PacketCapture::writeHeader()
+{
+    Block shb(PCAPNG_SECTION_HEADER);
+    shb.put32(PCAPNG_BYTE_ORDER_MAGIC);
+    shb.put16(1); // version 1.0
+    shb.put16(0);
+    shb.put64(UINT64_MAX); // section length not specified
+    std::string application = std::string("meshtasticd ") + optstr(APP_VERSION);
+    shb.option(PCAPNG_OPT_SHB_USERAPPL, application.c_str());
+    const std::vector<uint8_t> &shbBytes = shb.finish();
+    fwrite(shbBytes.data(), 1, shbBytes.size(), file);
+
+    Block idb(PCAPNG_INTERFACE_DESCRIPTION);
+    idb.put16(LINKTYPE_LORATAP);
+    idb.put16(0);
+    idb.put32(0); // no snap length
+    idb.option(PCAPNG_OPT_IF_NAME, "lora");
+    const std::vector<uint8_t> &idbBytes = idb.finish();
+    fwrite(idbBytes.data(), 1, idbBytes.size(), file);
+
+    fileBytes += shbBytes.size() + idbBytes.size();
+}
+
+void PacketCapture::writeFrame(const Frame &f)
+{
+    if (!file)
+        return;
+
+    // LoRaTap v0, multi byte fields big endian
+    uint8_t tap[LORATAP_HEADER_LEN] = {0};
+    uint32_t freqHz = lround(f.radio.freqMHz * 1e6);
+    tap[0] = 0; // version
+    tap[2] = 0;
+    tap[3] = LORATAP_HEADER_LEN;
+    tap[4] = freqHz >> 24;
+    tap[5] = freqHz >> 16;
+    tap[6] = freqHz >> 8;
+    tap[7] = freqHz;
+    tap[8] = lround(f.radio.bwKHz / 125); // in 125 kHz steps, 0 for the narrow bandwidths LoRaTap can't express
+    tap[9] = f.radio.sf;
+    if (!f.transmitted) {
+        int rssi = lround(f.radio.rssi) + 139; // LoRaTap stores dBm + 139
+        tap[10] = (rssi < 0) ? 0 : (rssi > 255) ? 255 : rssi;
+        tap[11] = tap[10]; // max rssi
+        tap[12] = tap[10]; // current rssi
+        tap[13] = (uint8_t)(int8_t)lround(f.radio.snr * 4);
+    }
+    tap[14] = LORATAP_MESHTASTIC_SYNC_WORD;
+
+    char comment[96];
+    snprintf(comment, sizeof(comment), "%s preset=%s cr=4/%u airtime=%ums", f.transmitted ? "tx" : "rx", f.preset,
+             f.radio.cr, f.radio.airtimeMs);
+    uint32_t flags = f.transmitted ? PCAPNG_EPB_OUTBOUND : PCAPNG_EPB_INBOUND;
+
+    Block epb(PCAPNG_ENHANCED_PACKET);
+    epb.put32(0); // interface id
+    epb.put32(f.timestampUs >> 32);
+    epb.put32(f.timestampUs & 0xffffffff);
+    epb.put32(sizeof(tap) + f.len);
+    epb.put32(sizeof(tap) + f.len);
+    epb.put(tap, sizeof(tap));
+    epb.put(f.data, f.len);
+    epb.pad();
+    epb.option(PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags));
+    epb.option(PCAPNG_OPT_COMMENT, comment);
+    const std::vector<uint8_t> &bytes = epb.finish();
+
+    if (fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size())
+        LOG_WARN("Packet capture write failed: %s", strerror(errno));
+    fileBytes += bytes.size();
+
+    if (fileBytes >= maxBytes)
+        rotate();
+}
+
+bool PacketCapture::read(const std::string &path, const std::function<void(const CapturedFrame &)> &onFrame)
+{
+    FILE *in = fopen(path.c_str(), "rb");
+    if (!in)
+        return false;
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0)
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    fclose(in);
+
+    auto get16 = [&](size_t at) {
+        uint16_t v;
+        memcpy(&v, &bytes[at], sizeof(v));
+        return v;
+    };
+    auto get32 = [&](size_t at) {
+        uint32_t v;
+        memcpy(&v, &bytes[at], sizeof(v));
+        return v;
+    };
+
+    // We only write (and so only read) files in host byte order
+    if (bytes.size() < 12 || get32(0) != PCAPNG_SECTION_HEADER || get32(8) != PCAPNG_BYTE_ORDER_MAGIC)
+        return false;
+
+    std::vector<uint16_t> linkTypes; // per interface, in the order their IDBs appear in the section
+    for (size_t at = 0; at + 12 <= bytes.size();) {
+        uint32_t type = get32(at);
+        uint32_t blockLen = get32(at + 4);
+        if (blockLen < 12 || blockLen % 4 || at + blockLen > bytes.size())
+            break; // truncated, e.g. still being written
+
+        if (type == PCAPNG_SECTION_HEADER) {
+            linkTypes.clear();
+        } else if (type == PCAPNG_INTERFACE_DESCRIPTION && blockLen >= 20) {
+            linkTypes.push_back(get16(at + 8));
+        } else if (type == PCAPNG_ENHANCED_PACKET && blockLen >= 32) {
+            uint32_t interface = get32(at + 8);
+            uint32_t capLen = get32(at + 20);
+            size_t data = at + 28;
+            size_t optionsAt = data + ((capLen + 3) & ~3u);
+            size_t end = at + blockLen - 4;
+
+            if (interface < linkTypes.size() && linkTypes[interface] == LINKTYPE_LORATAP && optionsAt <= end &&
+                capLen >= LORATAP_HEADER_LEN) {
+                const uint8_t *tap = &bytes[data];
+                uint16_t tapLen = (tap[2] << 8) | tap[3];
+
+                CapturedFrame f = {};
+                f.timestampUs = ((uint64_t)get32(at + 12) << 32) | get32(at + 16);
+                f.radio.freqMHz = (((uint32_t)tap[4] << 24) | (tap[5] << 16) | (tap[6] << 8) | tap[7]) / 1e6f;
+                f.radio.bwKHz = tap[8] * 125.0f;
+                f.radio.sf = tap[9];
+                f.radio.rssi = (float)tap[10] - 139;
+                f.radio.snr = (int8_t)tap[13] / 4.0f;
+                if (tapLen <= capLen) {
+                    f.len = std::min<size_t>(capLen - tapLen, sizeof(f.data));
+                    memcpy(f.data, tap + tapLen, f.len);
+                }
+
+                for (size_t opt = optionsAt; opt + 4 <= end;) {
+                    uint16_t code = get16(opt);
+                    uint16_t optLen = get16(opt + 2);
+                    if (code == PCAPNG_OPT_END || opt + 4 + optLen > end)
+                        break;
+                    if (code == PCAPNG_OPT_EPB_FLAGS && optLen == 4) {
+                        f.transmitted = (get32(opt + 4) & 3) == PCAPNG_EPB_OUTBOUND;
+                    } else if (code == PCAPNG_OPT_COMMENT) {
+                        std::string comment((const char *)&bytes[opt + 4], optLen);
+                        unsigned value;
+                        size_t pos = comment.find("airtime=");
+                        if (pos != std::string::npos && sscanf(comment.c_str() + pos, "airtime=%u", &value) == 1)
+                            f.radio.airtimeMs = value;
+                        pos = comment.find("cr=4/");
+                        if (pos != std::string::npos && sscanf(comment.c_str() + pos, "cr=4/%u", &value) == 1)
+                            f.radio.cr = value;
+                    }
+                    opt += 4 + ((optLen + 3) & ~3u);
+                }
+
+                onFrame(f);
+            }
+        }
+        at += blockLen;
+    }
+    return true;
+}
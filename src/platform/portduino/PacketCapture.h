@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Frames allowed to wait for the writer thread, beyond that new frames are dropped (and counted)
+#define PACKET_CAPTURE_MAX_PENDING 4096
+
+/**
+ * Writes every LoRa frame we receive or transmit to a pcapng file, for offline analysis in Wireshark and friends.
+ *
+ * Frames use the LoRaTap link type so frequency, bandwidth, spreading factor, RSSI and SNR show up as fields.  The
+ * direction goes in the epb_flags option and the modem preset and airtime in a comment on each packet.
+ *
+ * capture() only copies the frame into a queue, a separate thread does the file writes.  Once the file grows past
+ * maxBytes it is rotated to <file>.1, <file>.2 ... keeping at most maxFiles files, so a gateway can capture
+ * indefinitely.
+ */
+class PacketCapture
+{
+  public:
+    /// Everything about the radio that goes into the LoRaTap header and packet comment
+    struct RadioInfo {
+        float freqMHz;
+        float bwKHz;
+        uint8_t sf;
+        uint8_t cr;
+        float rssi; // ignored for transmitted frames
+        float snr;  // ignored for transmitted frames
+        uint32_t airtimeMs;
+    };
+
+    PacketCapture(const std::string &path, uint64_t maxBytes, unsigned maxFiles);
+    ~PacketCapture();
+
+    /// @return false if the capture file could not be created, nothing will be captured
+    bool isOpen() const { return writer.joinable(); }
+
+    /// Queue a frame (PacketHeader and payload, exactly as on air) for writing
+    void capture(bool transmitted, const uint8_t *frame, size_t len, const RadioInfo &radio);
+
+    /// Frames lost because the writer could not keep up
+    uint32_t getDropped() const { return dropped; }
+
+    /// A frame read back from a capture file
+    struct CapturedFrame {
+        uint64_t timestampUs;
+        bool transmitted;
+        RadioInfo radio;
+        uint16_t len;
+        uint8_t data[256];
+    };
+
+    /**
+     * Read back a capture (ours, or any pcapng with LoRaTap frames), calling onFrame for every frame in file order.
+     * @return false if the file could not be opened or is not pcapng
+     */
+    static bool read(const std::string &path, const std::function<void(const CapturedFrame &)> &onFrame);
+
+  private:
+    struct Frame {
+        uint64_t timestampUs;
+        bool transmitted;
+        RadioInfo radio;
+        const char *preset;
+        uint16_t len;
+        uint8_t data[256];
+    };
+
+    std::string path;
+    uint64_t maxBytes;
+    unsigned maxFiles;
+
+    FILE *file = nullptr;
+    uint64_t fileBytes = 0;
+
+    std::mutex lock;
+    std::condition_variable wakeup;
+    std::vector<Frame> pending; // guarded by lock
+    bool stopping = false;      // guarded by lock
+    std::atomic<uint32_t> dropped{0};
+    std::thread writer;
+
+    void run();
+    bool openFile();
+    void rotate();
+    void writeHeader();
+    void writeFrame(const Frame &f);
+};
+
+extern PacketCapture *packetCapture;
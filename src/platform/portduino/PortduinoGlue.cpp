@@ -5,7 +5,9 @@
 #include "sleep.h"
 #include "target_specific.h"
 
+#include "PacketCapture.h"
 #include "PortduinoGlue.h"
+#include "RadioIrqThread.h"
 #include "SHA256.h"
 #include "api/ServerAPI.h"
 #include "linux/gpio/LinuxGPIOPin.h"
@@ -505,6 +507,16 @@ void portduinoSetup()
         if (i->config_section == "Lora" && portduino_config.lora_spi_dev == "ch341") {
             continue;
         }
+#ifdef PORTDUINO_LINUX_HARDWARE
+        // The radio IRQ gets its own edge waiting thread when possible, see RadioIrqThread
+        if (i == &portduino_config.lora_irq_pin && i->enabled && portduino_config.lora_irq_edge_events) {
+            radioIrqThread = new RadioIrqThread(i->pin, gpioChipName + std::to_string(i->gpiochip), i->line);
+            if (radioIrqThread->isOpen())
+                continue;
+            delete radioIrqThread;
+            radioIrqThread = nullptr;
+        }
+#endif
         if (i->enabled) {
             if (initGPIOPin(i->pin, gpioChipName + std::to_string(i->gpiochip), i->line) != ERRNO_OK) {
                 printf("Error setting pin number %d. It may not exist, or may already be in use.\n", i->line);
@@ -531,6 +543,16 @@ void portduinoSetup()
         SPI.begin(portduino_config.lora_spi_dev.c_str());
     }
 
+    if (portduino_config.packetCaptureFilename != "") {
+        packetCapture = new PacketCapture(portduino_config.packetCaptureFilename,
+                                          (uint64_t)portduino_config.packetCaptureMaxMB * 1024 * 1024,
+                                          portduino_config.packetCaptureFiles);
+        if (!packetCapture->isOpen()) {
+            std::cout << "*** packet capture open failure" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
     if (portduino_config.traceFilename != "") {
         try {
             traceFile.open(portduino_config.traceFilename, std::ios::out | std::ios::app);
@@ -600,6 +622,9 @@ bool loadConfig(const char *configPath)
                 portduino_config.logoutputlevel = level_error;
             }
             portduino_config.traceFilename = yamlConfig["Logging"]["TraceFile"].as<std::string>("");
+            portduino_config.packetCaptureFilename = yamlConfig["Logging"]["PacketCapture"].as<std::string>("");
+            portduino_config.packetCaptureMaxMB = yamlConfig["Logging"]["PacketCaptureMaxMB"].as<int>(100);
+            portduino_config.packetCaptureFiles = yamlConfig["Logging"]["PacketCaptureFiles"].as<int>(5);
             portduino_config.JSONFilename = yamlConfig["Logging"]["JSONFile"].as<std::string>("");
             portduino_config.JSONFilter = (_meshtastic_PortNum)yamlConfig["Logging"]["JSONFilter"].as<int>(0);
             if (yamlConfig["Logging"]["JSONFilter"].as<std::string>("") == "textmessage")
@@ -681,6 +706,8 @@ bool loadConfig(const char *configPath)
             }
 
             portduino_config.spiSpeed = yamlConfig["Lora"]["spiSpeed"].as<int>(2000000);
+            portduino_config.lora_irq_edge_events = yamlConfig["Lora"]["IRQEdgeEvents"].as<bool>(true);
+            portduino_config.lora_congestion_control = yamlConfig["Lora"]["CongestionControl"].as<bool>(false);
             portduino_config.lora_usb_serial_num = yamlConfig["Lora"]["USB_Serialnum"].as<std::string>("");
             portduino_config.lora_usb_pid = yamlConfig["Lora"]["USB_PID"].as<int>(0x5512);
             portduino_config.lora_usb_vid = yamlConfig["Lora"]["USB_VID"].as<int>(0x1A86);
@@ -878,6 +905,7 @@ bool loadConfig(const char *configPath)
         if (yamlConfig["General"]) {
             portduino_config.MaxNodes = (yamlConfig["General"]["MaxNodes"]).as<int>(200);
             portduino_config.maxtophone = (yamlConfig["General"]["MaxMessageQueue"]).as<int>(100);
+            portduino_config.node_database_map = (yamlConfig["General"]["NodeDatabaseMap"]).as<std::string>("");
             portduino_config.config_directory = (yamlConfig["General"]["ConfigDirectory"]).as<std::string>("");
             portduino_config.available_directory =
                 (yamlConfig["General"]["AvailableDirectory"]).as<std::string>("/etc/meshtasticd/available.d/");
@@ -91,6 +91,8 @@ extern struct portduino_config_struct {
     int lora_usb_pid = 0x5512;
     int lora_usb_vid = 0x1A86;
     int spiSpeed = 2000000;
+    bool lora_irq_edge_events = true;
+    bool lora_congestion_control = false;
     int num_pa_points = 1; // default to 1 point, with 0 gain
     uint16_t tx_gain_lora[22] = {0};
     pinMapping lora_cs_pin = {"Lora", "CS"};
@@ -152,6 +154,9 @@ extern struct portduino_config_struct {
     // Logging
     portduino_log_level logoutputlevel = level_debug;
     std::string traceFilename;
+    std::string packetCaptureFilename;
+    int packetCaptureMaxMB = 100;
+    int packetCaptureFiles = 5;
     bool ascii_logs = !isatty(1);
     bool ascii_logs_explicit = false;
 
@@ -182,6 +187,7 @@ extern struct portduino_config_struct {
     std::string available_directory = "/etc/meshtasticd/available.d/";
     int maxtophone = 100;
     int MaxNodes = 200;
+    std::string node_database_map = "";
 
     pinMapping *all_pins[20] = {&lora_cs_pin,
                                 &lora_irq_pin,
@@ -256,6 +262,10 @@ extern struct portduino_config_struct {
         if (lora_usb_serial_num != "")
             out << YAML::Key << "USB_Serialnum" << YAML::Value << lora_usb_serial_num;
         out << YAML::Key << "spiSpeed" << YAML::Value << spiSpeed;
+        if (!lora_irq_edge_events)
+            out << YAML::Key << "IRQEdgeEvents" << YAML::Value << lora_irq_edge_events;
+        if (lora_congestion_control)
+            out << YAML::Key << "CongestionControl" << YAML::Value << lora_congestion_control;
         if (rfswitch_dio_pins[0] != RADIOLIB_NC) {
             out << YAML::Key << "rfswitch_table" << YAML::Value << YAML::BeginMap;
 
@@ -449,6 +459,11 @@ extern struct portduino_config_struct {
         }
         if (traceFilename != "")
             out << YAML::Key << "TraceFile" << YAML::Value << traceFilename;
+        if (packetCaptureFilename != "") {
+            out << YAML::Key << "PacketCapture" << YAML::Value << packetCaptureFilename;
+            out << YAML::Key << "PacketCaptureMaxMB" << YAML::Value << packetCaptureMaxMB;
+            out << YAML::Key << "PacketCaptureFiles" << YAML::Value << packetCaptureFiles;
+        }
         if (JSONFilename != "") {
             out << YAML::Key << "JSONFile" << YAML::Value << JSONFilename;
             if (JSONFilter == meshtastic_PortNum_TEXT_MESSAGE_APP)
@@ -532,6 +547,8 @@ extern struct portduino_config_struct {
             out << YAML::Key << "AvailableDirectory" << YAML::Value << available_directory;
         out << YAML::Key << "MaxMessageQueue" << YAML::Value << maxtophone;
         out << YAML::Key << "MaxNodes" << YAML::Value << MaxNodes;
+        if (node_database_map != "")
+            out << YAML::Key << "NodeDatabaseMap" << YAML::Value << node_database_map;
         out << YAML::EndMap; // General
         return out.c_str();
     }
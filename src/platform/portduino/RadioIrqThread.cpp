@@ -0,0 +1,80 @@
+#include "RadioIrqThread.h"
+#include "configuration.h"
+
+RadioIrqThread *radioIrqThread;
+
+#ifdef PORTDUINO_LINUX_HARDWARE
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <gpiod.h>
+#include <iostream>
+
+// How often the waiter looks up from gpiod_line_event_wait() to check whether it should stop
+#define RADIO_IRQ_STOP_CHECK_MS 500
+
+RadioIrqThread::RadioIrqThread(int pin, const std::string &chipName, int lineNum) : pin(pin)
+{
+    chip = gpiod_chip_open_by_name(chipName.c_str());
+    if (!chip) {
+        std::cout << "Cannot open " << chipName << " for IRQ edge events: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    line = gpiod_chip_get_line(chip, lineNum);
+    if (!line || gpiod_line_request_rising_edge_events(line, "meshtasticd-irq") != 0) {
+        std::cout << "Cannot request line " << lineNum << " of " << chipName << " for IRQ edge events: " << strerror(errno)
+                  << std::endl;
+        line = nullptr;
+        gpiod_chip_close(chip);
+        chip = nullptr;
+        return;
+    }
+
+    waiter = std::thread(&RadioIrqThread::run, this);
+}
+
+RadioIrqThread::~RadioIrqThread()
+{
+    stopping = true;
+    if (waiter.joinable())
+        waiter.join();
+    if (line)
+        gpiod_line_release(line);
+    if (chip)
+        gpiod_chip_close(chip);
+}
+
+int RadioIrqThread::read()
+{
+    return line ? gpiod_line_get_value(line) : 0;
+}
+
+void RadioIrqThread::run()
+{
+    const timespec timeout = {RADIO_IRQ_STOP_CHECK_MS / 1000, (RADIO_IRQ_STOP_CHECK_MS % 1000) * 1000000L};
+
+    while (!stopping) {
+        int r = gpiod_line_event_wait(line, &timeout);
+        if (r < 0) {
+            // Keep trying, giving up would leave the radio deaf
+            std::cout << "IRQ edge wait failed: " << strerror(errno) << std::endl;
+            std::this_thread::sleep_for(std::chrono::milliseconds(RADIO_IRQ_STOP_CHECK_MS));
+            continue;
+        }
+        if (r == 0)
+            continue;
+
+        gpiod_line_event event;
+        if (gpiod_line_event_read(line, &event) != 0 || event.event_type != GPIOD_LINE_EVENT_RISING_EDGE)
+            continue;
+
+        edges++;
+        // Edges while no handler is attached are dropped, just like a masked interrupt
+        void (*cb)() = callback;
+        if (cb)
+            cb();
+    }
+}
+
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+struct gpiod_chip;
+struct gpiod_line;
+
+/**
+ * Waits for the radio's IRQ line to rise with a blocking gpiod edge event wait, and calls the interrupt handler
+ * RadioLib attached the moment it does.
+ *
+ * Without this the IRQ pin goes through the portduino GPIO emulation like every other pin, which has to keep
+ * checking it.  Here the kernel wakes our thread on the edge, the handler notifies the RadioIf thread and wakes the
+ * main loop, so the packet is read from the FIFO straight away and the process sleeps while the channel is quiet.
+ *
+ * LockingArduinoHal routes RadioLib's attachInterrupt(), detachInterrupt() and digitalRead() for the IRQ pin here.
+ */
+class RadioIrqThread
+{
+  public:
+    RadioIrqThread(int pin, const std::string &chipName, int line);
+    ~RadioIrqThread();
+
+    /// @return false if the line could not be requested for edge events, the pin should be bound as usual then
+    bool isOpen() const { return waiter.joinable(); }
+
+    int getPin() const { return pin; }
+
+    /// Handler to call on a rising edge, null to ignore edges (the equivalent of a disabled interrupt)
+    void setCallback(void (*cb)()) { callback = cb; }
+
+    /// Current level of the line
+    int read();
+
+    /// Rising edges seen since start
+    uint32_t getEdges() const { return edges; }
+
+  private:
+    int pin;
+    gpiod_chip *chip = nullptr;
+    gpiod_line *line = nullptr;
+
+    std::atomic<void (*)()> callback{nullptr};
+    std::atomic<bool> stopping{false};
+    std::atomic<uint32_t> edges{0};
+    std::thread waiter;
+
+    void run();
+};
+
+extern RadioIrqThread *radioIrqThread;
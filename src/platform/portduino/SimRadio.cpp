@@ -188,7 +188,7 @@ void SimRadio::onNotify(uint32_t notification)
                     startSend(txp);
                     // Packet has been sent, count it toward our TX airtime utilization.
                     uint32_t xmitMsec = RadioInterface::getPacketTime(txp);
-                    airTime->logAirtime(TX_LOG, xmitMsec);
+                    airTime->logAirtime(TX_LOG, xmitMsec, txp->from);
 
                     notifyLater(xmitMsec, ISR_TX, false); // Model the time it is busy sending
                 }
@@ -316,7 +316,7 @@ void SimRadio::handleReceiveInterrupt()
 
     printPacket("Lora RX", mp);
 
-    airTime->logAirtime(RX_LOG, RadioInterface::getPacketTime(mp, true));
+    airTime->logAirtime(RX_LOG, RadioInterface::getPacketTime(mp, true), mp->from);
 
     deliverToReceiver(mp);
 }
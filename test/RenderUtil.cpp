@@ -0,0 +1,140 @@
+#include "RenderUtil.h"
+
+#include "NodeDB.h"
+#include "gps/RTC.h"
+
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+
+void populateNodeDB(size_t count)
+{
+    std::mt19937 rng(count);
+    uint32_t now = getTime();
+
+    // Ours, in the middle of them
+    meshtastic_Position ours = meshtastic_Position_init_default;
+    ours.has_latitude_i = ours.has_longitude_i = true;
+    ours.latitude_i = 515000000;
+    ours.longitude_i = -1000000;
+    ours.time = now;
+    nodeDB->updatePosition(nodeDB->getNodeNum(), ours, RX_SRC_LOCAL);
+
+    for (size_t i = 0; i < count; i++) {
+        NodeNum num = 0x10000 + i;
+        meshtastic_Position p = meshtastic_Position_init_default;
+        p.has_latitude_i = p.has_longitude_i = true;
+        p.latitude_i = ours.latitude_i + (int32_t)(rng() % 9000000) - 4500000;
+        p.longitude_i = ours.longitude_i + (int32_t)(rng() % 14000000) - 7000000;
+        p.time = now - rng() % 86400;
+        nodeDB->updatePosition(num, p);
+
+        meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(num);
+        if (!node)
+            continue; // NodeDB full
+        node->has_user = true;
+        snprintf(node->user.long_name, sizeof(node->user.long_name), "Synthetic node %u", (unsigned)i);
+        snprintf(node->user.short_name, sizeof(node->user.short_name), "%04x", (unsigned)(num & 0xFFFF));
+        node->last_heard = now - rng() % 86400;
+        node->snr = (float)(rng() % 40) - 20;
+        node->has_hops_away = rng() % 8 != 0;
+        node->hops_away = rng() % 4;
+        nodeDB->touchMeshNode(node);
+    }
+}
+
+const char *getGoldenDir()
+{
+    const char *dir = getenv("RENDER_GOLDEN_DIR");
+    return (dir && *dir) ? dir : nullptr;
+}
+
+uint32_t hashImage(const uint8_t *data, size_t len)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+static uint32_t crc32(const uint8_t *data, size_t len, uint32_t crc = 0)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static void putBE32(std::vector<uint8_t> &out, uint32_t v)
+{
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+static void writeChunk(FILE *f, const char *type, const std::vector<uint8_t> &data)
+{
+    std::vector<uint8_t> chunk;
+    putBE32(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    putBE32(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    fwrite(chunk.data(), 1, chunk.size(), f);
+}
+
+bool writePNG(const char *path, uint16_t width, uint16_t height, const std::vector<uint8_t> &rows, bool setIsWhite)
+{
+    const size_t stride = (width + 7) / 8;
+    if (rows.size() < stride * height)
+        return false;
+
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    static const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), f);
+
+    // 1 bit grayscale, in which a set bit is white
+    std::vector<uint8_t> header;
+    putBE32(header, width);
+    putBE32(header, height);
+    header.insert(header.end(), {1, 0, 0, 0, 0}); // bit depth, color type, compression, filter, interlace
+    writeChunk(f, "IHDR", header);
+
+    // Each row after a filter type byte (none)
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * height);
+    for (uint16_t y = 0; y < height; y++) {
+        raw.push_back(0);
+        for (size_t i = 0; i < stride; i++)
+            raw.push_back(setIsWhite ? rows[y * stride + i] : ~rows[y * stride + i]);
+    }
+
+    // zlib stream of stored (uncompressed) deflate blocks: golden images are for diffing, not for keeping small
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    for (size_t pos = 0; pos < raw.size() || pos == 0; pos += 0xFFFF) {
+        uint16_t len = raw.size() - pos < 0xFFFF ? raw.size() - pos : 0xFFFF;
+        zlib.push_back(pos + len >= raw.size() ? 1 : 0); // last block?
+        zlib.push_back(len & 0xFF);
+        zlib.push_back(len >> 8);
+        zlib.push_back(~len & 0xFF);
+        zlib.push_back((~len >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + len);
+    }
+    uint32_t a = 1, b = 0; // Adler-32
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBE32(zlib, (b << 16) | a);
+    writeChunk(f, "IDAT", zlib);
+
+    writeChunk(f, "IEND", {});
+    return fclose(f) == 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Shared by the rendering benchmarks (test_screen_render, test_inkhud_render)
+
+// Nodes for the UI to list and plot: names, positions within about 50 km of ours, hops, signal, heard over the last day.
+// NodeDB must have room for them: on native, set portduino_config.MaxNodes before creating it
+void populateNodeDB(size_t count);
+
+// Directory to write rendered frames to, from the RENDER_GOLDEN_DIR environment variable. nullptr if not set
+const char *getGoldenDir();
+
+// Hash of a frame, so logs of two runs show which frames drew differently
+uint32_t hashImage(const uint8_t *data, size_t len);
+
+// Write a 1 bit per pixel image as a grayscale PNG
+// rows: height rows of (width + 7) / 8 bytes, leftmost pixel in the most significant bit
+// setIsWhite: whether a set bit is a lit pixel (OLED) rather than an inked one (E-Ink)
+bool writePNG(const char *path, uint16_t width, uint16_t height, const std::vector<uint8_t> &rows, bool setIsWhite);
@@ -0,0 +1,123 @@
+#include "airtime.h"
+#include "serialization/JSON.h"
+
+#include "TestUtil.h"
+#include <memory>
+#include <unity.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_window_slides_by_the_second(void)
+{
+    static AirtimeWindow w;
+
+    w.add(500);
+    TEST_ASSERT_EQUAL_UINT32(500, w.sumMs(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 50.0, w.percent(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 5.0, w.percent(10));
+
+    for (int i = 0; i < 9; i++)
+        w.tick();
+    TEST_ASSERT_EQUAL_UINT32(500, w.sumMs(10));
+
+    // One more second and it is out of the last 10
+    w.tick();
+    TEST_ASSERT_EQUAL_UINT32(0, w.sumMs(10));
+    TEST_ASSERT_EQUAL_UINT32(500, w.sumMs(11));
+}
+
+void test_long_packet_goes_back_in_time(void)
+{
+    static AirtimeWindow w;
+
+    for (int i = 0; i < 5; i++)
+        w.tick();
+    w.add(2600);
+
+    // Only logged when it ended, but it took the whole of the two seconds before
+    TEST_ASSERT_EQUAL_UINT32(1000, w.sumMs(1));
+    TEST_ASSERT_EQUAL_UINT32(2000, w.sumMs(2));
+    TEST_ASSERT_EQUAL_UINT32(2600, w.sumMs(3));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 100.0, w.percent(2));
+}
+
+void test_window_keeps_small_packets(void)
+{
+    static AirtimeWindow w;
+
+    // Less than a unit each, the remainders must add up rather than get lost
+    for (int i = 0; i < 100; i++)
+        w.add(3);
+    TEST_ASSERT_EQUAL_UINT32(300, w.sumMs(1));
+}
+
+void test_top_senders(void)
+{
+    AirtimeHeavyHitters h;
+
+    // A few heavy nodes among many light ones
+    for (int round = 0; round < 50; round++) {
+        h.add(0x1000, 400);
+        h.add(0x2000, 200);
+        for (NodeNum n = 0; n < 4 * AIRTIME_TOP_NODES; n++)
+            h.add(0x9000 + round * 100 + n, 10);
+    }
+
+    AirtimeHeavyHitters::Entry top[AIRTIME_TOP_NODES];
+    size_t n = h.getTop(top, AIRTIME_TOP_NODES);
+    TEST_ASSERT_EQUAL(AIRTIME_TOP_NODES, n);
+    TEST_ASSERT_EQUAL_UINT32(0x1000, top[0].from);
+    TEST_ASSERT_EQUAL_UINT32(0x2000, top[1].from);
+    TEST_ASSERT_EQUAL_UINT32(50 * 400, top[0].airtimeMs - top[0].errorMs);
+    for (size_t i = 1; i < n; i++)
+        TEST_ASSERT_TRUE(top[i - 1].airtimeMs >= top[i].airtimeMs);
+
+    h.decay();
+    h.getTop(top, 1);
+    TEST_ASSERT_EQUAL_UINT32(0x1000, top[0].from);
+    TEST_ASSERT_EQUAL_UINT16(25, top[0].packets);
+}
+
+/// What /json/airtime serves: it must parse, with every field and a full list of senders
+void test_json_parses(void)
+{
+    AirTime at;
+    for (NodeNum n = 0; n < 2 * AIRTIME_TOP_NODES; n++)
+        at.logAirtime(RX_LOG, 100 + n, 0xfedcba00 + n);
+    at.logAirtime(TX_LOG, 250);
+
+    std::string json = at.buildJson();
+    std::unique_ptr<JSONValue> root(JSON::Parse(json.c_str()));
+    TEST_ASSERT_NOT_NULL_MESSAGE(root.get(), json.c_str());
+    TEST_ASSERT_TRUE(root->IsObject());
+
+    JSONObject obj = root->AsObject();
+    TEST_ASSERT_EQUAL(AIRTIME_WINDOW_SECONDS, (int)obj["window_seconds"]->AsNumber());
+    TEST_ASSERT_TRUE(obj.find("channel_utilization_60s") != obj.end());
+    TEST_ASSERT_TRUE(obj.find("channel_utilization_window") != obj.end());
+    TEST_ASSERT_TRUE(obj.find("utilization_tx") != obj.end());
+    TEST_ASSERT_TRUE(obj["top_senders"]->IsArray());
+
+    const JSONArray &top = obj["top_senders"]->AsArray();
+    TEST_ASSERT_EQUAL(AIRTIME_TOP_NODES, top.size());
+    for (JSONValue *sender : top) {
+        TEST_ASSERT_TRUE(sender->IsObject());
+        TEST_ASSERT_EQUAL(10, sender->Child("from")->AsString().size()); // "!" and 8 hex digits
+        TEST_ASSERT_TRUE(sender->Child("airtime_ms")->AsNumber() >= 100);
+    }
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_window_slides_by_the_second);
+    RUN_TEST(test_long_packet_goes_back_in_time);
+    RUN_TEST(test_window_keeps_small_packets);
+    RUN_TEST(test_top_senders);
+    RUN_TEST(test_json_parses);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,249 @@
+#include "CongestionControl.h"
+#include "MeshRadio.h"
+#include "RadioInterface.h"
+#include "configuration.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+// The defaults of RadioInterface
+static const uint8_t CW_MIN = 3;
+static const uint8_t CW_MAX = 8;
+
+// LongFast-ish: a short packet takes about 20 slot times on air
+static const uint32_t AIRTIME_SLOTS = 20;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static CongestionControl::Sample sample(float util, uint32_t received, uint32_t duplicates, uint32_t canceled)
+{
+    return {util, received, duplicates, canceled};
+}
+
+void test_disabled_keeps_defaults(void)
+{
+    CongestionControl cc;
+    cc.setEnabled(false);
+    cc.update(sample(0, 0, 0, 0));
+    cc.update(sample(90, 100, 90, 0));
+    TEST_ASSERT_EQUAL(CW_MIN, cc.widen(CW_MIN));
+    TEST_ASSERT_EQUAL(CW_MAX, cc.widen(CW_MAX));
+}
+
+void test_busy_channel_widens_at_once(void)
+{
+    CongestionControl cc;
+    cc.setEnabled(true);
+    cc.update(sample(40, 0, 0, 0)); // only a baseline
+    TEST_ASSERT_EQUAL(0, cc.getOffset());
+
+    cc.update(sample(40, 10, 0, 0));
+    TEST_ASSERT_EQUAL(1, cc.getOffset());
+    for (uint32_t i = 2; i < 10; i++)
+        cc.update(sample(40, i * 10, 0, 0));
+    TEST_ASSERT_EQUAL(CONGESTION_MAX_WIDEN, cc.getOffset());
+    TEST_ASSERT_EQUAL(CW_MIN + CONGESTION_MAX_WIDEN, cc.widen(CW_MIN));
+    TEST_ASSERT_EQUAL(CW_MAX + CONGESTION_MAX_WIDEN, cc.widen(CW_MAX));
+}
+
+void test_quiet_channel_narrows_slowly(void)
+{
+    CongestionControl cc;
+    cc.setEnabled(true);
+    cc.update(sample(40, 0, 0, 0));
+    cc.update(sample(40, 10, 0, 0));
+    cc.update(sample(40, 20, 0, 0));
+    TEST_ASSERT_EQUAL(2, cc.getOffset());
+
+    cc.update(sample(2, 30, 0, 0));
+    TEST_ASSERT_EQUAL(2, cc.getOffset());
+    cc.update(sample(2, 40, 0, 0));
+    TEST_ASSERT_EQUAL(1, cc.getOffset());
+
+    // Never below the defaults
+    for (uint32_t i = 5; i < 20; i++)
+        cc.update(sample(2, i * 10, 0, 0));
+    TEST_ASSERT_EQUAL(0, cc.getOffset());
+    TEST_ASSERT_EQUAL(CW_MIN, cc.widen(CW_MIN));
+    TEST_ASSERT_EQUAL(CW_MAX, cc.widen(CW_MAX));
+}
+
+void test_duplicates_count_unless_they_cancel_our_relays(void)
+{
+    // Most packets heard twice, but each second copy cancelled our own relay: suppression works, don't widen
+    CongestionControl suppressed;
+    suppressed.setEnabled(true);
+    suppressed.update(sample(15, 0, 0, 0));
+    suppressed.update(sample(15, 20, 12, 10));
+    TEST_ASSERT_EQUAL(0, suppressed.getOffset());
+
+    // Same duplicates, but we relayed anyway: we are colliding with our neighbours
+    CongestionControl colliding;
+    colliding.setEnabled(true);
+    colliding.update(sample(15, 0, 0, 0));
+    colliding.update(sample(15, 20, 12, 1));
+    TEST_ASSERT_EQUAL(1, colliding.getOffset());
+}
+
+/// Arduino's map()
+static long mapRange(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+struct RelayStats {
+    uint32_t delivered = 0;
+    uint64_t latencySlots = 0;
+    uint32_t collisions = 0;
+};
+
+/**
+ * One flooded packet heard by some clients which all want to relay it, drawing their delays like
+ * RadioInterface::getTxDelayMsecWeighted(): 2 * CWmax slots, plus a random number of slots below 2^CWsize where CWsize
+ * goes from cwMin to cwMax with the SNR.  Relays starting in the same slot can't hear each other (CAD needs a slot) and
+ * collide, a relay that is heard cancels all the others.  Relays that were due while the channel was busy draw a new
+ * delay, like startSend() does.
+ *
+ * This is a model of a single neighbourhood, not a run of the mesh simulator: everyone hears everyone, there is no
+ * capture effect and no multi-hop flooding, so it only shows the trend.
+ */
+static void relayOnce(int neighbours, uint8_t cwMin, uint8_t cwMax, std::mt19937 &rng, RelayStats &stats)
+{
+    std::uniform_int_distribution<int> snrDist(-20, 10);
+    struct Relay {
+        uint32_t at;
+        uint8_t cw;
+    };
+    std::vector<Relay> relays;
+    for (int i = 0; i < neighbours; i++) {
+        uint8_t cw = mapRange(snrDist(rng), -20, 10, cwMin, cwMax);
+        relays.push_back({(uint32_t)(2 * CW_MAX + rng() % (1u << cw)), cw});
+    }
+
+    while (!relays.empty()) {
+        std::sort(relays.begin(), relays.end(), [](const Relay &a, const Relay &b) { return a.at < b.at; });
+        uint32_t start = relays[0].at;
+        size_t together = 1;
+        while (together < relays.size() && relays[together].at == start)
+            together++;
+
+        if (together == 1) {
+            stats.delivered++;
+            stats.latencySlots += start + AIRTIME_SLOTS;
+            return;
+        }
+
+        stats.collisions++;
+        relays.erase(relays.begin(), relays.begin() + together);
+        uint32_t idle = start + AIRTIME_SLOTS;
+        for (auto &r : relays)
+            if (r.at < idle)
+                r.at = idle + rng() % (1u << r.cw);
+    }
+}
+
+/// Relay many packets with the CW sizes moved by offset (which can be below the defaults, unlike the controller's)
+static RelayStats evaluate(int neighbours, int offset)
+{
+    std::mt19937 rng(1234);
+    RelayStats stats;
+    uint8_t cwMin = std::max(1, CW_MIN + offset);
+    for (int i = 0; i < 20000; i++)
+        relayOnce(neighbours, cwMin, CW_MAX + offset, rng, stats);
+    return stats;
+}
+
+void test_evaluate_delivery_and_latency(void)
+{
+    const int neighbourCounts[] = {2, 5, 10, 20, 40};
+    char msg[120];
+
+    const int narrowest = -1;
+
+    TEST_MESSAGE("neighbours offset delivered% latency(slots) collisions/packet");
+    RelayStats results[5][CONGESTION_MAX_WIDEN - narrowest + 1];
+    for (int n = 0; n < 5; n++) {
+        for (int o = narrowest; o <= CONGESTION_MAX_WIDEN; o++) {
+            RelayStats s = evaluate(neighbourCounts[n], o);
+            results[n][o - narrowest] = s;
+            snprintf(msg, sizeof(msg), "%10d %6d %10.2f %15.1f %20.3f", neighbourCounts[n], o, s.delivered / 200.0,
+                     s.delivered ? (double)s.latencySlots / s.delivered : 0.0, s.collisions / 20000.0);
+            TEST_MESSAGE(msg);
+        }
+    }
+
+    // Narrower than the defaults loses packets when only two neighbours can relay, which is why the controller doesn't go there
+    TEST_ASSERT_TRUE(results[0][0].delivered < results[0][-narrowest].delivered);
+
+    // A dense neighbourhood collides less, and so relays sooner, with the widest window
+    const RelayStats &denseWide = results[4][CONGESTION_MAX_WIDEN - narrowest], &denseDefault = results[4][-narrowest];
+    TEST_ASSERT_TRUE(denseWide.collisions < denseDefault.collisions / 2);
+    TEST_ASSERT_TRUE(denseWide.latencySlots < denseDefault.latencySlots);
+    TEST_ASSERT_TRUE(denseWide.delivered >= denseDefault.delivered);
+}
+
+/// Just enough of a radio to ask it for delays
+class DelayRadio : public RadioInterface
+{
+  public:
+    ErrorCode send(meshtastic_MeshPacket *p) override { return ERRNO_OK; }
+    uint32_t getPacketTime(uint32_t totalPacketLen, bool received = false) override { return 0; }
+};
+
+/// Widening the windows must not let a client's rebroadcast come before a router's, at any SNR
+void test_routers_go_first_at_every_offset(void)
+{
+    initRegion();
+    DelayRadio radio;
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    meshtastic_Config_DeviceConfig_Role role = config.device.role;
+
+    congestionControl.setEnabled(true);
+    congestionControl.update(sample(40, 0, 0, 0));
+    for (int offset = 0; offset <= CONGESTION_MAX_WIDEN; offset++) {
+        TEST_ASSERT_EQUAL(offset, congestionControl.getOffset());
+
+        // Enough draws to hit both ends of every window
+        uint32_t routerMax = 0;
+        uint32_t clientMin = UINT32_MAX;
+        for (int snr = -20; snr <= 10; snr++) {
+            p.rx_snr = snr;
+            for (int i = 0; i < 200; i++) {
+                config.device.role = meshtastic_Config_DeviceConfig_Role_ROUTER;
+                routerMax = std::max(routerMax, radio.getTxDelayMsecWeighted(&p));
+                config.device.role = meshtastic_Config_DeviceConfig_Role_CLIENT;
+                clientMin = std::min(clientMin, radio.getTxDelayMsecWeighted(&p));
+            }
+        }
+        char msg[80];
+        snprintf(msg, sizeof(msg), "offset %d: router max %u ms, client min %u ms", offset, (unsigned)routerMax,
+                 (unsigned)clientMin);
+        TEST_ASSERT_TRUE_MESSAGE(routerMax < clientMin, msg);
+
+        congestionControl.update(sample(40, (offset + 1) * 10, 0, 0));
+    }
+
+    congestionControl.setEnabled(MESHTASTIC_CONGESTION_CONTROL);
+    config.device.role = role;
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_disabled_keeps_defaults);
+    RUN_TEST(test_busy_channel_widens_at_once);
+    RUN_TEST(test_quiet_channel_narrows_slowly);
+    RUN_TEST(test_duplicates_count_unless_they_cancel_our_relays);
+    RUN_TEST(test_evaluate_delivery_and_latency);
+    RUN_TEST(test_routers_go_first_at_every_offset);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,224 @@
+#include "graphics/EInkImage.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// A common E-Ink panel (2.13", 250x122), as an OLEDDisplay buffer: 8 pixels per byte
+static const size_t IMAGE_SIZE = 250 * (128 / 8);
+
+#define BENCHMARK_ROUNDS 2000
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/// Pixel by pixel, as EInkDynamicDisplay::countGhostPixels did (though that skipped the top bit of each byte)
+static uint32_t countGhostPixelsByBit(uint8_t *dirty, const uint8_t *image, size_t size, uint8_t bits = 8)
+{
+    uint32_t count = 0;
+    for (size_t i = 0; i < size; i++) {
+        for (uint8_t bit = 0; bit < bits; bit++) {
+            const bool wasDirty = (dirty[i] >> bit) & 1;
+            const bool shouldBeBlank = !((image[i] >> bit) & 1);
+            if (wasDirty && shouldBeBlank)
+                count++;
+            if (!wasDirty && !shouldBeBlank)
+                dirty[i] |= (1 << bit);
+        }
+    }
+    return count;
+}
+
+static std::vector<uint8_t> randomImage(std::mt19937 &rng, size_t size, uint8_t density)
+{
+    // Density: 0 all white, 8 half black. E-Ink frames are mostly white
+    std::vector<uint8_t> image(size);
+    for (auto &b : image) {
+        b = 0;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            if ((rng() % 16) < density)
+                b |= 1 << bit;
+    }
+    return image;
+}
+
+void test_hash_known_values(void)
+{
+    // xxHash32, seed 0
+    TEST_ASSERT_EQUAL_HEX32(0x02CC5D05, einkHashImage((const uint8_t *)"", 0));
+    TEST_ASSERT_EQUAL_HEX32(0x32D153FF, einkHashImage((const uint8_t *)"abc", 3));
+    const char *text = "Nobody inspects the spammish repetition";
+    TEST_ASSERT_EQUAL_HEX32(0xE2293B2F, einkHashImage((const uint8_t *)text, strlen(text)));
+}
+
+void test_hash_sees_every_pixel(void)
+{
+    // The old hash shifted each byte left by its index, so only the first few bytes of the image counted
+    std::mt19937 rng(42);
+    std::vector<uint8_t> image = randomImage(rng, IMAGE_SIZE, 2);
+    uint32_t original = einkHashImage(image.data(), image.size());
+
+    for (size_t i = 0; i < IMAGE_SIZE; i += 7) {
+        uint8_t bit = 1 << (i % 8);
+        image[i] ^= bit;
+        TEST_ASSERT_NOT_EQUAL(original, einkHashImage(image.data(), image.size()));
+        image[i] ^= bit;
+    }
+    TEST_ASSERT_EQUAL_HEX32(original, einkHashImage(image.data(), image.size()));
+}
+
+void test_ghost_count_matches_bit_by_bit(void)
+{
+    std::mt19937 rng(1234);
+
+    // Odd sizes and offsets too, for the bytes left over after the last whole word
+    const size_t sizes[] = {IMAGE_SIZE, IMAGE_SIZE - 3, 1, 7, 9};
+    for (size_t size : sizes) {
+        std::vector<uint8_t> dirtyWord(size, 0), dirtyBit(size, 0);
+        for (int frame = 0; frame < 20; frame++) {
+            std::vector<uint8_t> image = randomImage(rng, size, frame % 9);
+            uint32_t byWord = einkCountGhostPixels(dirtyWord.data(), image.data(), size);
+            uint32_t byBit = countGhostPixelsByBit(dirtyBit.data(), image.data(), size);
+            TEST_ASSERT_EQUAL_UINT32(byBit, byWord);
+            TEST_ASSERT_EQUAL_MEMORY(dirtyBit.data(), dirtyWord.data(), size);
+        }
+    }
+
+    // Unaligned buffers
+    std::vector<uint8_t> dirty(IMAGE_SIZE + 1, 0), dirtyBit(IMAGE_SIZE, 0);
+    std::vector<uint8_t> image = randomImage(rng, IMAGE_SIZE + 1, 4);
+    TEST_ASSERT_EQUAL_UINT32(countGhostPixelsByBit(dirtyBit.data(), image.data() + 1, IMAGE_SIZE),
+                             einkCountGhostPixels(dirty.data() + 1, image.data() + 1, IMAGE_SIZE));
+}
+
+void test_ghost_count_old_semantics(void)
+{
+    // Apart from the top bit of each byte, which it never looked at, the count is what it always was
+    std::mt19937 rng(99);
+    std::vector<uint8_t> dirtyWord(IMAGE_SIZE, 0), dirtyOld(IMAGE_SIZE, 0);
+    for (int frame = 0; frame < 10; frame++) {
+        std::vector<uint8_t> image = randomImage(rng, IMAGE_SIZE, 3);
+        for (auto &b : image)
+            b &= 0x7F;
+        TEST_ASSERT_EQUAL_UINT32(countGhostPixelsByBit(dirtyOld.data(), image.data(), IMAGE_SIZE, 7),
+                                 einkCountGhostPixels(dirtyWord.data(), image.data(), IMAGE_SIZE));
+    }
+}
+
+/// Bounding box of the changed pixels, pixel by pixel, in OLEDDisplay's layout
+static bool changedRegionByPixel(const uint8_t *previous, const uint8_t *image, uint16_t width, uint16_t height,
+                                 EInkRegion *region)
+{
+    int left = width, right = -1, top = height, bottom = -1;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t i = x + (y / 8) * width;
+            if (((previous[i] ^ image[i]) >> (y & 7)) & 1) {
+                left = std::min(left, x);
+                right = std::max(right, x);
+                top = std::min(top, y);
+                bottom = std::max(bottom, y);
+            }
+        }
+    }
+    if (right < 0)
+        return false;
+    *region = {(uint16_t)left, (uint16_t)top, (uint16_t)(right - left + 1), (uint16_t)(bottom - top + 1)};
+    return true;
+}
+
+void test_changed_region(void)
+{
+    // 250x122: the last row of bytes holds two rows of padding, which never count
+    const uint16_t width = 250, height = 122;
+    std::mt19937 rng(5);
+    std::vector<uint8_t> previous = randomImage(rng, IMAGE_SIZE, 2);
+
+    EInkRegion region, expected;
+    TEST_ASSERT_FALSE(einkChangedRegion(previous.data(), previous.data(), width, height, &region));
+
+    for (int round = 0; round < 200; round++) {
+        std::vector<uint8_t> image = previous;
+        int changes = 1 + rng() % 6;
+        for (int c = 0; c < changes; c++)
+            image[rng() % IMAGE_SIZE] ^= 1 << (rng() % 8);
+
+        bool changed = changedRegionByPixel(previous.data(), image.data(), width, height, &expected);
+        TEST_ASSERT_EQUAL(changed, einkChangedRegion(previous.data(), image.data(), width, height, &region));
+        if (changed) {
+            TEST_ASSERT_EQUAL_UINT16(expected.x, region.x);
+            TEST_ASSERT_EQUAL_UINT16(expected.y, region.y);
+            TEST_ASSERT_EQUAL_UINT16(expected.width, region.width);
+            TEST_ASSERT_EQUAL_UINT16(expected.height, region.height);
+        }
+    }
+
+    // A clock ticking over in the corner of the screen: only that much needs sending
+    std::vector<uint8_t> image = previous;
+    for (uint16_t x = 200; x < 240; x++)
+        image[x] ^= 0xF0, image[x + width] ^= 0x0F;
+    TEST_ASSERT_TRUE(einkChangedRegion(previous.data(), image.data(), width, height, &region));
+    TEST_ASSERT_EQUAL_UINT16(200, region.x);
+    TEST_ASSERT_EQUAL_UINT16(4, region.y);
+    TEST_ASSERT_EQUAL_UINT16(40, region.width);
+    TEST_ASSERT_EQUAL_UINT16(8, region.height);
+}
+
+void test_benchmark(void)
+{
+    std::mt19937 rng(7);
+    std::vector<uint8_t> image = randomImage(rng, IMAGE_SIZE, 2);
+    std::vector<uint8_t> dirty = randomImage(rng, IMAGE_SIZE, 2);
+    char msg[120];
+    volatile uint32_t sink = 0;
+
+    auto time = [](auto fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_ROUNDS; i++)
+            fn();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCHMARK_ROUNDS;
+    };
+
+    // Dirty pixels accumulate, so restart from the same state each round
+    std::vector<uint8_t> d(IMAGE_SIZE);
+    double byBit = time([&] {
+        memcpy(d.data(), dirty.data(), IMAGE_SIZE);
+        sink = sink + countGhostPixelsByBit(d.data(), image.data(), IMAGE_SIZE);
+    });
+    double byWord = time([&] {
+        memcpy(d.data(), dirty.data(), IMAGE_SIZE);
+        sink = sink + einkCountGhostPixels(d.data(), image.data(), IMAGE_SIZE);
+    });
+    double hash = time([&] { sink = sink + einkHashImage(image.data(), IMAGE_SIZE); });
+
+    std::vector<uint8_t> changed = image;
+    changed[IMAGE_SIZE / 2] ^= 1;
+    EInkRegion region;
+    double diff = time([&] { sink = sink + einkChangedRegion(image.data(), changed.data(), 250, 122, &region); });
+
+    snprintf(msg, sizeof(msg), "ghost pixels: %.2f us bit by bit, %.2f us by word; hash: %.2f us; changed region: %.2f us",
+             byBit, byWord, hash, diff);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(byWord < byBit);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_hash_known_values);
+    RUN_TEST(test_hash_sees_every_pixel);
+    RUN_TEST(test_ghost_count_matches_bit_by_bit);
+    RUN_TEST(test_ghost_count_old_semantics);
+    RUN_TEST(test_changed_region);
+    RUN_TEST(test_benchmark);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,392 @@
+#include "DebugConfiguration.h"
+#include "RenderUtil.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef MESHTASTIC_INCLUDE_INKHUD
+
+#include "NodeDB.h"
+#include "graphics/niche/Drivers/EInk/MemoryEInk.h"
+#include "graphics/niche/InkHUD/Applets/Bases/Map/MapApplet.h"
+#include "graphics/niche/InkHUD/Applets/System/Logo/LogoApplet.h"
+#include "graphics/niche/InkHUD/Applets/User/AllMessage/AllMessageApplet.h"
+#include "graphics/niche/InkHUD/Applets/User/DM/DMApplet.h"
+#include "graphics/niche/InkHUD/Applets/User/Heard/HeardApplet.h"
+#include "graphics/niche/InkHUD/Applets/User/Positions/PositionsApplet.h"
+#include "graphics/niche/InkHUD/Applets/User/ThreadedMessage/ThreadedMessageApplet.h"
+#include "graphics/niche/InkHUD/InkHUD.h"
+#include "graphics/niche/InkHUD/Tile.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace NicheGraphics;
+
+// A common InkHUD panel (2.13", 250x122)
+#define DISPLAY_WIDTH 250
+#define DISPLAY_HEIGHT 122
+
+#define RENDERS_PER_APPLET 50
+
+#define RENDER_NODES 1000
+
+static InkHUD::InkHUD *inkhud;
+static Drivers::MemoryEInk *driver;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/// Render the applet alone, filling the display, the way WindowManager would. @return usec per render
+static double renderApplet(InkHUD::Applet *applet, uint8_t rotation, bool bulk, std::vector<uint8_t> &image)
+{
+    inkhud->persistence->settings.rotation = rotation;
+    InkHUD::Tile tile(0, 0, inkhud->width(), inkhud->height());
+    tile.assignApplet(applet);
+    InkHUD::Applet::bulkDrawing = bulk;
+
+    uint8_t *buffer = inkhud->getImageBuffer();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < RENDERS_PER_APPLET; i++) {
+        memset(buffer, 0xFF, driver->getImageSize()); // White, as Renderer::clearBuffer leaves it
+        tile.discardRender(); // Time the drawing, not the copy of the last render
+        applet->render();
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    image.assign(buffer, buffer + driver->getImageSize());
+    tile.assignApplet(nullptr);
+    InkHUD::Applet::bulkDrawing = true;
+    return (double)us / RENDERS_PER_APPLET;
+}
+
+static void benchmark(const char *name, InkHUD::Applet *applet)
+{
+    char msg[120];
+    std::vector<uint8_t> bulkImage, pixelImage;
+
+    for (uint8_t rotation = 0; rotation < 4; rotation++) {
+        double bulkUs = renderApplet(applet, rotation, true, bulkImage);
+        double pixelUs = renderApplet(applet, rotation, false, pixelImage);
+
+        // The fast path must draw exactly what drawing pixel by pixel does
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(pixelImage.data(), bulkImage.data(), bulkImage.size(), name);
+
+        if (rotation == 0 || rotation == 1) {
+            snprintf(msg, sizeof(msg), "%-16s rotation %u: %8.1f us per render, %8.1f us pixel by pixel (%.1fx), hash %08x",
+                     name, rotation, bulkUs, pixelUs, bulkUs > 0 ? pixelUs / bulkUs : 0.0,
+                     hashImage(bulkImage.data(), bulkImage.size()));
+            TEST_MESSAGE(msg);
+        }
+
+        // The driver's image is MSB first rows, with a set bit white
+        const char *dir = getGoldenDir();
+        if (dir && rotation == 0) {
+            char path[256];
+            snprintf(path, sizeof(path), "%s/inkhud_%ux%u_%s.png", dir, DISPLAY_WIDTH, DISPLAY_HEIGHT, name);
+            for (char *c = strrchr(path, '/') + 1; *c; c++)
+                if (*c == ' ')
+                    *c = '_';
+            TEST_ASSERT_TRUE_MESSAGE(writePNG(path, DISPLAY_WIDTH, DISPLAY_HEIGHT, bulkImage, true), path);
+        }
+    }
+}
+
+/// The fast path's edge cases: off the applet, negative sizes, a crop, white over black, text on the edges
+class PrimitivesApplet : public InkHUD::Applet
+{
+  public:
+    void onRender() override
+    {
+        fillRect(-5, -5, 20, 12, BLACK);
+        fillRect(width() - 7, height() - 3, 30, 30, BLACK);
+        fillRect(40, 20, -6, 10, BLACK); // Negative sizes must draw whatever AdafruitGFX draws
+        fillRect(60, 20, 6, -10, BLACK);
+        drawFastHLine(10, 40, -8, BLACK);
+        drawFastVLine(20, 40, -8, BLACK);
+        drawFastHLine(-3, height() / 2, width() + 6, BLACK);
+        drawFastVLine(width() / 3, -3, height() + 6, BLACK);
+        fillRect(75, 25, 30, 30, BLACK);
+        fillRect(80, 30, 20, 20, WHITE);
+
+        setCrop(110, 10, 50, 40);
+        fillRect(100, 0, 80, 80, BLACK);
+        setTextColor(WHITE);
+        printAt(105, 20, "Cropped text");
+        setTextColor(BLACK);
+        resetCrop();
+
+        printAt(-4, height() - 2, "Off the edge", LEFT, BOTTOM);
+        printAt(width() + 3, 60, "Right aligned", RIGHT, MIDDLE);
+    }
+};
+
+/// Whether a pixel of an unrotated image is white
+static bool isWhite(const std::vector<uint8_t> &image, uint16_t x, uint16_t y)
+{
+    return image[(y * ((DISPLAY_WIDTH + 7) / 8)) + (x / 8)] & (0x80 >> (x % 8));
+}
+
+void test_primitives(void)
+{
+    PrimitivesApplet primitives;
+    benchmark("Primitives", &primitives);
+
+    // Matching the pixel by pixel path isn't enough if both are wrong: the colors must be the ones asked for
+    std::vector<uint8_t> image;
+    renderApplet(&primitives, 0, true, image);
+    TEST_ASSERT_FALSE(isWhite(image, 77, 27));  // Black square
+    TEST_ASSERT_TRUE(isWhite(image, 90, 40));   // White inside it
+    TEST_ASSERT_TRUE(isWhite(image, 150, 100)); // Untouched
+    TEST_ASSERT_FALSE(isWhite(image, 0, 0));    // Rect hanging off the top left
+}
+
+void test_logo(void)
+{
+    InkHUD::LogoApplet logo;
+    benchmark("Logo", &logo);
+}
+
+void test_all_messages(void)
+{
+    InkHUD::AllMessageApplet allMessages;
+    benchmark("All Messages", &allMessages);
+}
+
+void test_dm(void)
+{
+    InkHUD::DMApplet dms;
+    benchmark("DMs", &dms);
+}
+
+void test_threaded_message(void)
+{
+    InkHUD::ThreadedMessageApplet channel(0);
+    benchmark("Channel 0", &channel);
+}
+
+void test_heard(void)
+{
+    InkHUD::HeardApplet heard;
+    heard.onActivate(); // Fill from NodeDB
+    benchmark("Heard", &heard);
+}
+
+void test_positions(void)
+{
+    InkHUD::PositionsApplet positions;
+    benchmark("Positions", &positions);
+}
+
+/// The map alone, checked against a walk of every node in NodeDB
+class MapUnderTest : public InkHUD::MapApplet
+{
+  public:
+    /// Every node's marker, binned into the cells of the screen the slow way
+    std::vector<uint32_t> bruteForceCells(uint16_t cols, uint16_t rows)
+    {
+        std::vector<uint32_t> counts((size_t)cols * rows, 0);
+        const float marginPx = clusterPx / 2;
+        for (uint32_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
+            meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
+            if (!nodeDB->hasValidPosition(node) || node->num == nodeDB->getNodeNum())
+                continue;
+            Marker m = calculateMarker(node->position.latitude_i * 1e-7, node->position.longitude_i * 1e-7, false, 0);
+            float xPx = X(0.5) + (m.eastMeters * metersToPx);
+            float yPx = Y(0.5) - (m.northMeters * metersToPx);
+            if (xPx < -marginPx || xPx >= width() + marginPx || yPx < -marginPx || yPx >= height() + marginPx)
+                continue;
+            int16_t x = xPx;
+            int16_t y = yPx;
+            uint16_t cellX = (x < 0 ? 0 : x >= width() ? width() - 1 : x) / clusterPx;
+            uint16_t cellY = (y < 0 ? 0 : y >= height() ? height() - 1 : y) / clusterPx;
+            counts[cellY * cols + cellX]++;
+        }
+        return counts;
+    }
+};
+
+/// The grid index, the culling to the view and the clustering find exactly what checking every node does
+void test_map_index(void)
+{
+    MapUnderTest map;
+    InkHUD::Tile tile(0, 0, inkhud->width(), inkhud->height());
+    tile.assignApplet(&map);
+    map.render(); // Indexes NodeDB, and fits the map to all of it
+
+    // Every positioned node but ours, each in the cell it was sorted into
+    size_t positioned = 0;
+    for (uint32_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
+        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
+        if (nodeDB->hasValidPosition(node) && node->num != nodeDB->getNodeNum())
+            positioned++;
+    }
+    TEST_ASSERT_EQUAL(positioned, map.nodes.size());
+    TEST_ASSERT_EQUAL(positioned, map.cellStart[map.gridSize * map.gridSize]);
+    for (uint32_t cell = 0; cell < map.gridSize * map.gridSize; cell++) {
+        for (uint32_t i = map.cellStart[cell]; i < map.cellStart[cell + 1]; i++) {
+            uint32_t row = ((int64_t)map.nodes[i].latitudeI - map.gridLatMin) / map.gridLatStep;
+            uint32_t col = ((int64_t)map.nodes[i].longitudeI - map.gridLngMin) / map.gridLngStep;
+            TEST_ASSERT_EQUAL(cell, row * map.gridSize + col);
+        }
+    }
+
+    // Zoomed in and panned about, so most of the grid is out of view
+    const float fitted = map.metersToPx;
+    const float fittedLat = map.latCenter;
+    const float fittedLng = map.lngCenter;
+    const float zooms[] = {1, 2, 5, 20, 100};
+    const float pans[] = {0, 0.1, -0.2, 0.35};
+    uint16_t cols = (map.width() + map.clusterPx - 1) / map.clusterPx;
+    uint16_t rows = (map.height() + map.clusterPx - 1) / map.clusterPx;
+    size_t views = 0;
+    size_t clustered = 0;
+
+    for (float zoom : zooms) {
+        for (float panLat : pans) {
+            for (float panLng : pans) {
+                map.metersToPx = fitted * zoom;
+                map.latCenter = fittedLat + panLat;
+                map.lngCenter = fittedLng + panLng;
+                map.clusterMarkers();
+
+                std::vector<uint32_t> want = map.bruteForceCells(cols, rows);
+                size_t occupied = 0;
+                for (size_t cell = 0; cell < want.size(); cell++) {
+                    uint16_t slot = map.cellClusters[cell];
+                    TEST_ASSERT_EQUAL(want[cell], slot ? map.clusters[slot - 1].count : 0);
+                    if (want[cell])
+                        occupied++;
+                }
+                TEST_ASSERT_EQUAL(occupied, map.clusters.size());
+                views++;
+                clustered += occupied;
+            }
+        }
+    }
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "Map: %u nodes indexed, %u views checked, %u clusters", (unsigned)positioned, (unsigned)views,
+             (unsigned)clustered);
+    TEST_MESSAGE(msg);
+    tile.assignApplet(nullptr);
+}
+
+/// An applet with nothing new to show is redrawn from its tile's copy, which must match rendering it again
+void test_cached_render(void)
+{
+    InkHUD::AllMessageApplet allMessages;
+    TEST_ASSERT_TRUE(allMessages.cacheRender);
+
+    std::vector<uint8_t> fresh, cached;
+    uint8_t *buffer = inkhud->getImageBuffer();
+    char msg[120];
+
+    for (uint8_t rotation = 0; rotation < 4; rotation++) {
+        inkhud->persistence->settings.rotation = rotation;
+
+        // Offset, so the tile doesn't start on a byte boundary in any rotation
+        InkHUD::Tile tile(3, 5, inkhud->width() - 11, inkhud->height() - 7);
+        tile.assignApplet(&allMessages);
+
+        memset(buffer, 0xFF, driver->getImageSize());
+        auto start = std::chrono::steady_clock::now();
+        allMessages.render();
+        auto freshUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        fresh.assign(buffer, buffer + driver->getImageSize());
+
+        // Nothing changed since: the tile's copy is put back
+        memset(buffer, 0xFF, driver->getImageSize());
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < RENDERS_PER_APPLET; i++)
+            allMessages.render();
+        auto cachedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        cached.assign(buffer, buffer + driver->getImageSize());
+
+        TEST_ASSERT_EQUAL_MEMORY(fresh.data(), cached.data(), fresh.size());
+
+        if (rotation == 0) {
+            snprintf(msg, sizeof(msg), "All Messages: %lld us rendered, %.1f us from the cache", (long long)freshUs,
+                     (double)cachedUs / RENDERS_PER_APPLET);
+            TEST_MESSAGE(msg);
+        }
+
+        tile.assignApplet(nullptr);
+    }
+
+    // The copy is for one rotation only
+    InkHUD::Tile tile(0, 0, inkhud->width(), inkhud->height());
+    tile.assignApplet(&allMessages);
+    allMessages.render();
+    inkhud->persistence->settings.rotation = 1;
+    TEST_ASSERT_FALSE(tile.restoreRender());
+
+    // A discarded copy keeps its buffer, but is never put back
+    allMessages.render();
+    TEST_ASSERT_TRUE(tile.restoreRender());
+    tile.discardRender();
+    TEST_ASSERT_FALSE(tile.restoreRender());
+    tile.assignApplet(nullptr);
+    inkhud->persistence->settings.rotation = 0;
+}
+
+/// Enough for the message applets to wrap text, and a big mesh for the list and map applets
+static void populate()
+{
+    InkHUD::Persistence::LatestMessage *latest = &inkhud->persistence->latestMessage;
+    latest->broadcast = {1700000000, 0x1234, 0,
+                         "The quick brown fox jumps over the lazy dog, then keeps on running across the whole width of the "
+                         "display so that the text has to wrap over several lines."};
+    latest->dm = {1700000100, 0x5678, 0, "Meet at the north gate at six?"};
+    latest->wasBroadcast = true;
+
+    populateNodeDB(RENDER_NODES);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    portduino_config.MaxNodes = RENDER_NODES + 1; // and ours
+    nodeDB = new NodeDB;
+
+    driver = new Drivers::MemoryEInk(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    inkhud = InkHUD::InkHUD::getInstance();
+    inkhud->setDriver(driver);
+    InkHUD::Applet::fontLarge = FREESANS_12PT_WIN1252;
+    InkHUD::Applet::fontMedium = FREESANS_9PT_WIN1252;
+    InkHUD::Applet::fontSmall = FREESANS_6PT_WIN1252;
+    populate();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_primitives);
+    RUN_TEST(test_logo);
+    RUN_TEST(test_all_messages);
+    RUN_TEST(test_dm);
+    RUN_TEST(test_threaded_message);
+    RUN_TEST(test_heard);
+    RUN_TEST(test_positions);
+    RUN_TEST(test_map_index);
+    RUN_TEST(test_cached_render);
+    exit(UNITY_END());
+}
+
+#else
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_skipped(void)
+{
+    TEST_IGNORE_MESSAGE("This test requires an InkHUD build, such as native-inkhud");
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_skipped);
+    exit(UNITY_END());
+}
+#endif
+
+void loop() {}
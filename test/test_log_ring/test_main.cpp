@@ -0,0 +1,247 @@
+#include "LogRing.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <chrono>
+#include <cstring>
+#include <stdio.h>
+
+static LogRing ring;
+
+/// push() with printf style arguments
+static bool pushf(const char *format, ...)
+{
+    va_list arg;
+    va_start(arg, format);
+    bool ok = ring.push("DEBUG", "Router", 1234, format, arg);
+    va_end(arg);
+    return ok;
+}
+
+/// Capture and format through the ring, and check the result matches vsnprintf
+static void checkFormat(const char *format, ...)
+{
+    char expected[LOG_RING_MAX_RECORD];
+    char actual[LOG_RING_MAX_RECORD];
+    va_list arg;
+
+    va_start(arg, format);
+    vsnprintf(expected, sizeof(expected), format, arg);
+    va_end(arg);
+
+    va_start(arg, format);
+    TEST_ASSERT_TRUE(ring.push("INFO ", nullptr, 0, format, arg));
+    va_end(arg);
+
+    LogRing::Entry entry;
+    TEST_ASSERT_TRUE(ring.pop(entry, actual, sizeof(actual)));
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+    TEST_ASSERT_TRUE(ring.isEmpty());
+}
+
+void setUp(void)
+{
+    LogRing::Entry entry;
+    char buf[8];
+    while (ring.pop(entry, buf, sizeof(buf)))
+        ;
+}
+void tearDown(void) {}
+
+void test_formats_match_vsnprintf(void)
+{
+    checkFormat("no arguments");
+    checkFormat("100%% literal");
+    checkFormat("ints %d %i %u %x %X %o", -42, 7, 3000000000u, 0xbeef, 0xBEEF, 8);
+    checkFormat("widths %5d|%-5d|%05d|%+d|% d", 12, 12, 12, 12, 12);
+    checkFormat("star %*d|%-*d|%.*f", 6, 1, 6, 2, 3, 3.14159);
+    checkFormat("lengths %hhd %hd %ld %lld %lu %llu %zu", (char)-3, (short)-300, -70000L, -5000000000LL, 4000000000UL,
+                18000000000000000000ULL, (size_t)123456);
+    checkFormat("hex id=0x%08x fr=0x%08lx", 0x1234u, 0xdeadbeefUL);
+    checkFormat("floats %f %.2f %e %g %8.3f", 1.5, -0.125, 12345.678, 0.0001, 2.0f);
+    checkFormat("char %c%c", 'o', 'k');
+    checkFormat("strings %s|%10s|%-4s|%.3s", "hello", "right", "l", "truncated");
+    checkFormat("null %s", (const char *)nullptr);
+    checkFormat("pointer %p", (void *)&ring);
+}
+
+void test_source_and_time_are_kept(void)
+{
+    TEST_ASSERT_TRUE(pushf("x=%d", 5));
+
+    LogRing::Entry entry;
+    char buf[32];
+    TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("x=5", buf);
+    TEST_ASSERT_EQUAL_STRING("DEBUG", entry.logLevel);
+    TEST_ASSERT_EQUAL_STRING("Router", entry.source);
+    TEST_ASSERT_EQUAL_UINT32(1234, entry.millis);
+}
+
+void test_string_arguments_are_copied(void)
+{
+    char temp[16];
+    strcpy(temp, "before");
+    TEST_ASSERT_TRUE(pushf("%s", temp));
+    strcpy(temp, "after");
+
+    LogRing::Entry entry;
+    char buf[32];
+    TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("before", buf);
+}
+
+/// Payload bytes are logged with %.*s, there is no nul after them and the copy must stop at the precision
+void test_precision_bounds_string_copy(void)
+{
+    // Right at the end of a heap block, so AddressSanitizer catches a read past it
+    const char text[] = {'h', 'e', 'l', 'l', 'o'};
+    char *payload = new char[sizeof(text)];
+    memcpy(payload, text, sizeof(text));
+    TEST_ASSERT_TRUE(pushf("Received text msg from=0x%0x, id=0x%x, msg=%.*s|%.3s", 0x1234, 7, (int)sizeof(text), payload,
+                           payload));
+    delete[] payload;
+
+    LogRing::Entry entry;
+    char buf[64];
+    TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("Received text msg from=0x1234, id=0x7, msg=hello|hel", buf);
+}
+
+void test_runtime_format_is_copied(void)
+{
+    char format[16];
+    strcpy(format, "n=%d");
+    TEST_ASSERT_TRUE(pushf(format, 3));
+    strcpy(format, "garbage %s");
+
+    LogRing::Entry entry;
+    char buf[32];
+    TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("n=3", buf);
+}
+
+void test_fills_up_and_wraps(void)
+{
+    size_t pushed = 0;
+    while (pushf("message %u with some padding to make it longer", (unsigned)pushed))
+        pushed++;
+    TEST_ASSERT_GREATER_THAN(10, pushed);
+    TEST_ASSERT_FALSE(ring.isEmpty());
+
+    // Keep the ring cycling past its end many times, order must be preserved
+    LogRing::Entry entry;
+    char buf[LOG_RING_MAX_RECORD];
+    char expected[LOG_RING_MAX_RECORD];
+    size_t popped = 0;
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+        snprintf(expected, sizeof(expected), "message %u with some padding to make it longer", (unsigned)popped++);
+        TEST_ASSERT_EQUAL_STRING(expected, buf);
+        TEST_ASSERT_TRUE(pushf("message %u with some padding to make it longer", (unsigned)pushed++));
+    }
+}
+
+void test_long_string_is_truncated(void)
+{
+    char big[LOG_RING_MAX_RECORD * 2];
+    memset(big, 'a', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    TEST_ASSERT_TRUE(pushf("%s", big));
+
+    LogRing::Entry entry;
+    char buf[LOG_RING_MAX_RECORD * 2];
+    TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+    TEST_ASSERT_GREATER_THAN(LOG_RING_MAX_RECORD / 2, strlen(buf));
+    TEST_ASSERT_LESS_THAN(LOG_RING_MAX_RECORD, strlen(buf));
+}
+
+/// A record length no producer could have written (two of them pushing at once) empties the ring, it isn't copied out
+void test_corrupt_length_resets(void)
+{
+    LogRing::Entry entry;
+    char buf[LOG_RING_MAX_RECORD];
+    const uint16_t bad[] = {0, 1, LOG_RING_MAX_RECORD + 1, 0xFFFF};
+
+    for (uint16_t len : bad) {
+        TEST_ASSERT_TRUE(pushf("first %d", 1));
+        TEST_ASSERT_TRUE(pushf("second %d", 2));
+        uint32_t t = ring.tail.load();
+        ring.copyIn(t, (const uint8_t *)&len, sizeof(len));
+
+        TEST_ASSERT_FALSE(ring.pop(entry, buf, sizeof(buf)));
+        TEST_ASSERT_TRUE(ring.isEmpty());
+    }
+
+    // Still usable afterwards
+    TEST_ASSERT_TRUE(pushf("after %d", 3));
+    TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("after 3", buf);
+}
+
+void test_output_is_bounded(void)
+{
+    TEST_ASSERT_TRUE(pushf("%s and %d more", "a rather long line", 12345));
+
+    LogRing::Entry entry;
+    char buf[8];
+    TEST_ASSERT_TRUE(ring.pop(entry, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("a rathe", buf);
+}
+
+static void vsnprintfOnce(char *buf, size_t len, const char *format, ...)
+{
+    va_list arg;
+    va_start(arg, format);
+    vsnprintf(buf, len, format, arg);
+    va_end(arg);
+}
+
+void test_benchmark_capture_vs_format(void)
+{
+    const int rounds = 20000;
+    const char *format = "Rx packet id=0x%08x fr=0x%08x to=0x%08x, snr=%.2f rssi=%d from %s";
+    char buf[LOG_RING_MAX_RECORD];
+    LogRing::Entry entry;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+        vsnprintfOnce(buf, sizeof(buf), format, i, 0x1234, 0xffffffff, 6.25, -90, "Router");
+    auto formatUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Capture in batches that fit in the ring, draining in between is what the writer thread pays later
+    const int batch = 32;
+    long long captureUs = 0;
+    for (int i = 0; i < rounds; i += batch) {
+        auto t = std::chrono::steady_clock::now();
+        for (int j = 0; j < batch; j++)
+            pushf(format, i + j, 0x1234, 0xffffffff, 6.25, -90, "Router");
+        captureUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t).count();
+        while (ring.pop(entry, buf, sizeof(buf)))
+            ;
+    }
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%d messages: vsnprintf %lld us, capture %lld us", rounds, (long long)formatUs, captureUs);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_formats_match_vsnprintf);
+    RUN_TEST(test_source_and_time_are_kept);
+    RUN_TEST(test_string_arguments_are_copied);
+    RUN_TEST(test_precision_bounds_string_copy);
+    RUN_TEST(test_runtime_format_is_copied);
+    RUN_TEST(test_fills_up_and_wraps);
+    RUN_TEST(test_long_string_is_truncated);
+    RUN_TEST(test_corrupt_length_resets);
+    RUN_TEST(test_output_is_bounded);
+    RUN_TEST(test_benchmark_capture_vs_format);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,307 @@
+#include "DebugConfiguration.h"
+#include "FSCommon.h"
+#include "MessageStore.h"
+#include "TestUtil.h"
+#include "configuration.h"
+#include <unity.h>
+
+#if HAS_SCREEN && ENABLE_MESSAGE_PERSISTENCE && defined(FSCom)
+
+#include "NodeDB.h"
+#include "SafeFile.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Where MessageStore("test") keeps its log, and the snapshot older firmware wrote
+#define LOG_FILE "/Messages_test.log"
+#define LEGACY_FILE "/Messages_test.msgs"
+
+static std::vector<uint8_t> readFile(const char *name)
+{
+    std::vector<uint8_t> data;
+    auto f = FSCom.open(name, FILE_O_READ);
+    if (!f)
+        return data;
+    data.resize(f.size());
+    if (!data.empty())
+        f.read(data.data(), data.size());
+    f.close();
+    return data;
+}
+
+static void writeFile(const char *name, const std::vector<uint8_t> &data)
+{
+    FSCom.remove(name);
+    auto f = FSCom.open(name, FILE_O_WRITE);
+    TEST_ASSERT_TRUE(f);
+    f.write(data.data(), data.size());
+    f.close();
+}
+
+static const StoredMessage &addBroadcast(MessageStore &store, uint32_t from, uint8_t channel, const char *text)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = from;
+    p.to = NODENUM_BROADCAST;
+    p.channel = channel;
+    p.decoded.payload.size = strlen(text);
+    memcpy(p.decoded.payload.bytes, text, p.decoded.payload.size);
+    return store.addFromPacket(p);
+}
+
+/// What a freshly booted device would see
+static std::deque<StoredMessage> reload()
+{
+    MessageStore store("test");
+    store.loadFromFlash();
+    return store.getMessages();
+}
+
+void setUp(void)
+{
+    FSCom.remove(LOG_FILE);
+    FSCom.remove(LEGACY_FILE);
+}
+void tearDown(void) {}
+
+void test_replay(void)
+{
+    MessageStore store("test");
+    store.clearAllMessages();
+    addBroadcast(store, 0x1111, 0, "first");
+    addBroadcast(store, 0x2222, 1, "second");
+    store.addFromString(0x3333, 0, "third");
+    store.saveToFlash();
+
+    // Appended after the first save
+    addBroadcast(store, 0x4444, 2, "fourth");
+    store.saveToFlash();
+
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(4, loaded.size());
+    const auto &live = store.getMessages();
+    for (size_t i = 0; i < loaded.size(); i++) {
+        TEST_ASSERT_EQUAL(live[i].id, loaded[i].id);
+        TEST_ASSERT_EQUAL(live[i].sender, loaded[i].sender);
+        TEST_ASSERT_EQUAL(live[i].channelIndex, loaded[i].channelIndex);
+        TEST_ASSERT_EQUAL(live[i].dest, loaded[i].dest);
+        TEST_ASSERT_EQUAL(static_cast<uint8_t>(live[i].type), static_cast<uint8_t>(loaded[i].type));
+    }
+    TEST_ASSERT_EQUAL_STRING("fourth", MessageStore::getText(loaded[3]));
+}
+
+void test_tombstones(void)
+{
+    MessageStore store("test");
+    store.clearAllMessages();
+    for (int i = 0; i < 3; i++)
+        addBroadcast(store, 0x1111, 0, "keep");
+    for (int i = 0; i < 4; i++)
+        addBroadcast(store, 0x2222, 1, "drop");
+    store.saveToFlash();
+    size_t sizeBefore = readFile(LOG_FILE).size();
+
+    // One tombstone per message, appended straight away
+    store.deleteAllMessagesInChannel(1);
+    TEST_ASSERT_EQUAL(sizeBefore + 4 * (3 + sizeof(uint32_t) + sizeof(uint32_t)), readFile(LOG_FILE).size());
+
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(3, loaded.size());
+    for (const auto &m : loaded)
+        TEST_ASSERT_EQUAL(0, m.channelIndex);
+}
+
+/// Tombstones that can't be appended are not lost: the next save rewrites the log without those messages
+void test_tombstones_without_log(void)
+{
+    MessageStore store("test");
+    store.clearAllMessages();
+    for (int i = 0; i < 3; i++)
+        addBroadcast(store, 0x1111, 0, "keep");
+    for (int i = 0; i < 4; i++)
+        addBroadcast(store, 0x2222, 1, "drop");
+    store.saveToFlash();
+
+    FSCom.remove(LOG_FILE);
+    store.deleteAllMessagesInChannel(1);
+    TEST_ASSERT_FALSE(FSCom.exists(LOG_FILE));
+
+    store.saveToFlash();
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(3, loaded.size());
+    for (const auto &m : loaded)
+        TEST_ASSERT_EQUAL(0, m.channelIndex);
+}
+
+/// Messages pushed out by the history limit are tombstoned at the next save
+void test_history_limit_tombstones(void)
+{
+    MessageStore store("test");
+    store.clearAllMessages();
+    for (int i = 0; i < MAX_MESSAGES_SAVED; i++)
+        addBroadcast(store, 0x1000 + i, 0, "old");
+    store.saveToFlash();
+
+    addBroadcast(store, 0x2000, 0, "new");
+    addBroadcast(store, 0x2001, 0, "newer");
+    store.saveToFlash();
+
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(MAX_MESSAGES_SAVED, loaded.size());
+    TEST_ASSERT_EQUAL(0x1002, loaded.front().sender);
+    TEST_ASSERT_EQUAL_STRING("newer", MessageStore::getText(loaded.back()));
+}
+
+void test_ack_records(void)
+{
+    MessageStore store("test");
+    store.clearAllMessages();
+    uint32_t ours = addBroadcast(store, 0, 0, "sent by us").id;
+    addBroadcast(store, 0x1111, 0, "heard");
+    store.saveToFlash();
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(AckStatus::NONE), static_cast<uint8_t>(store.getMessages().front().ackStatus));
+
+    store.setAckStatus(ours, AckStatus::RELAYED);
+    store.setAckStatus(ours, AckStatus::ACKED); // The last one wins
+
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(2, loaded.size());
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(AckStatus::ACKED), static_cast<uint8_t>(loaded.front().ackStatus));
+}
+
+/// Power lost part way through an append: everything before the torn record survives, and the log is rewritten clean
+void test_torn_tail(void)
+{
+    MessageStore store("test");
+    store.clearAllMessages();
+    addBroadcast(store, 0x1111, 0, "one");
+    addBroadcast(store, 0x2222, 0, "two");
+    store.saveToFlash();
+    size_t intact = readFile(LOG_FILE).size();
+
+    addBroadcast(store, 0x3333, 0, "lost in the power cut");
+    store.saveToFlash();
+    std::vector<uint8_t> data = readFile(LOG_FILE);
+    TEST_ASSERT_TRUE(data.size() > intact);
+    data.resize(data.size() - 5);
+    writeFile(LOG_FILE, data);
+
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(2, loaded.size());
+    TEST_ASSERT_EQUAL_STRING("two", MessageStore::getText(loaded.back()));
+
+    // Compacted at load, so appends land after a valid record again
+    TEST_ASSERT_EQUAL(intact, readFile(LOG_FILE).size());
+    MessageStore again("test");
+    again.loadFromFlash();
+    addBroadcast(again, 0x4444, 0, "after");
+    again.saveToFlash();
+    TEST_ASSERT_EQUAL(3, reload().size());
+}
+
+/// Records too short for their kind are skipped, not read past
+void test_short_records(void)
+{
+    MessageStore store("test");
+    store.clearAllMessages();
+    addBroadcast(store, 0x1111, 0, "survivor");
+    store.saveToFlash();
+
+    std::vector<uint8_t> data = readFile(LOG_FILE);
+    for (uint8_t kind : {2, 3}) { // DELETE, ACK with no payload but a valid CRC
+        uint8_t record[3 + sizeof(uint32_t)] = {kind, 0, 0};
+        uint32_t crc = SafeFile::updateCRC(0, record, 3);
+        memcpy(record + 3, &crc, sizeof(crc));
+        data.insert(data.end(), record, record + sizeof(record));
+    }
+    writeFile(LOG_FILE, data);
+
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(1, loaded.size());
+    TEST_ASSERT_EQUAL_STRING("survivor", MessageStore::getText(loaded.front()));
+}
+
+void test_legacy_migration(void)
+{
+    // The fixed size records older firmware wrote, after a count byte
+    struct __attribute__((packed)) LegacyMessageRecord {
+        uint32_t timestamp;
+        uint32_t sender;
+        uint8_t channelIndex;
+        uint32_t dest;
+        uint8_t isBootRelative;
+        uint8_t ackStatus;
+        uint8_t type;
+        uint16_t textLength;
+        char text[MAX_MESSAGE_SIZE];
+    };
+
+    std::vector<uint8_t> data = {2};
+    const char *texts[] = {"from the old days", "still here"};
+    for (int i = 0; i < 2; i++) {
+        LegacyMessageRecord rec = {};
+        rec.timestamp = 1700000000 + i;
+        rec.sender = 0x1111 * (i + 1);
+        rec.channelIndex = i;
+        rec.dest = NODENUM_BROADCAST;
+        rec.ackStatus = static_cast<uint8_t>(AckStatus::ACKED);
+        rec.type = static_cast<uint8_t>(MessageType::BROADCAST);
+        rec.textLength = strlen(texts[i]);
+        strcpy(rec.text, texts[i]);
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&rec);
+        data.insert(data.end(), bytes, bytes + sizeof(rec));
+    }
+    writeFile(LEGACY_FILE, data);
+
+    auto loaded = reload();
+    TEST_ASSERT_EQUAL(2, loaded.size());
+    TEST_ASSERT_EQUAL(0x2222, loaded.back().sender);
+    TEST_ASSERT_EQUAL(1700000001, loaded.back().timestamp);
+    TEST_ASSERT_EQUAL_STRING("still here", MessageStore::getText(loaded.back()));
+
+    // Rewritten in the log format, and the old file is gone
+    TEST_ASSERT_TRUE(FSCom.exists(LOG_FILE));
+    TEST_ASSERT_FALSE(FSCom.exists(LEGACY_FILE));
+    loaded = reload();
+    TEST_ASSERT_EQUAL(2, loaded.size());
+    TEST_ASSERT_EQUAL_STRING("from the old days", MessageStore::getText(loaded.front()));
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    nodeDB = new NodeDB;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_replay);
+    RUN_TEST(test_tombstones);
+    RUN_TEST(test_tombstones_without_log);
+    RUN_TEST(test_history_limit_tombstones);
+    RUN_TEST(test_ack_records);
+    RUN_TEST(test_torn_tail);
+    RUN_TEST(test_short_records);
+    RUN_TEST(test_legacy_migration);
+    exit(UNITY_END());
+}
+
+#else
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_skipped(void)
+{
+    TEST_IGNORE_MESSAGE("This test requires a build with a Screen, message persistence and a filesystem");
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_skipped);
+    exit(UNITY_END());
+}
+#endif
+
+void loop() {}
@@ -237,7 +237,7 @@ bool loopUntil(std::function<bool()> conditionMet)
 {
     long start = millis();
     while (start + 4000 > millis()) {
-        long delayMsec = concurrency::mainController.runOrDelay();
+        long delayMsec = concurrency::mainScheduler.runOrDelay();
         if (conditionMet())
             return true;
         concurrency::mainDelay.delay(std::min(delayMsec, 5L));
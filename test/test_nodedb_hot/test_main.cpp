@@ -0,0 +1,285 @@
+#include "SafeFile.h"
+#include "mesh/NodeDB.h"
+#include "mesh/NodeHotTable.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Full-DB scans over the NodeInfoLite records vs. the hot table, at sizes a big meshtasticd gateway sees.
+static const size_t SMALL_DB = 1000;
+static const size_t LARGE_DB = 5000;
+static const int SCAN_ROUNDS = 200;
+
+struct TestDB {
+    std::vector<meshtastic_NodeInfoLite> nodes;
+    NodeHotTable hot;
+
+    explicit TestDB(size_t count) : nodes(count)
+    {
+        std::mt19937 rng(count);
+        hot.reset(count);
+        for (size_t i = 0; i < count; i++) {
+            meshtastic_NodeInfoLite &node = nodes[i];
+            node = meshtastic_NodeInfoLite_init_zero;
+            node.num = rng() | 1; // never 0, which we use as "missing"
+            node.last_heard = rng();
+            node.snr = (float)(rng() % 40) - 20;
+            node.next_hop = rng();
+            node.has_hops_away = rng() & 1;
+            node.hops_away = rng() % 8;
+            node.channel = rng() % 8;
+            node.is_favorite = (rng() % 16) == 0;
+            node.via_mqtt = rng() & 1;
+            hot.set(i, node);
+        }
+    }
+};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void assertSlotMatches(const TestDB &db, size_t i)
+{
+    const meshtastic_NodeInfoLite &node = db.nodes[i];
+    TEST_ASSERT_EQUAL_UINT32(node.num, db.hot.getNum(i));
+    TEST_ASSERT_EQUAL_UINT32(node.last_heard, db.hot.getLastHeard(i));
+    TEST_ASSERT_EQUAL_FLOAT(node.snr, db.hot.getSnr(i));
+    TEST_ASSERT_EQUAL_UINT8(node.next_hop, db.hot.getNextHop(i));
+    TEST_ASSERT_EQUAL(node.has_hops_away, db.hot.hasHopsAway(i));
+    TEST_ASSERT_EQUAL_UINT8(node.hops_away, db.hot.getHopsAway(i));
+    TEST_ASSERT_EQUAL_UINT8(node.channel, db.hot.getChannel(i));
+    TEST_ASSERT_EQUAL(node.is_favorite, db.hot.isFavorite(i));
+    TEST_ASSERT_EQUAL(node.via_mqtt, db.hot.isViaMqtt(i));
+}
+
+void test_set_mirrors_record(void)
+{
+    TestDB db(SMALL_DB);
+    for (size_t i = 0; i < db.nodes.size(); i++)
+        assertSlotMatches(db, i);
+}
+
+void test_move_copies_slot(void)
+{
+    TestDB db(16);
+    db.hot.move(3, 9);
+    db.nodes[3] = db.nodes[9];
+    assertSlotMatches(db, 3);
+    assertSlotMatches(db, 9);
+}
+
+void test_find_matches_record_scan(void)
+{
+    TestDB db(SMALL_DB);
+    for (size_t i = 0; i < db.nodes.size(); i += 7) {
+        NodeNum n = db.nodes[i].num;
+        size_t expected = 0;
+        while (db.nodes[expected].num != n)
+            expected++;
+        TEST_ASSERT_EQUAL_INT((int)expected, db.hot.find(n, db.nodes.size()));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, db.hot.find(0, db.nodes.size()));
+
+    // Slots past count are not searched
+    TEST_ASSERT_EQUAL_INT(-1, db.hot.find(db.nodes[10].num, 10));
+}
+
+static int recordScan(const std::vector<meshtastic_NodeInfoLite> &nodes, NodeNum n)
+{
+    for (size_t i = 0; i < nodes.size(); i++)
+        if (nodes[i].num == n)
+            return i;
+    return -1;
+}
+
+static size_t recordCountFavorites(const std::vector<meshtastic_NodeInfoLite> &nodes)
+{
+    size_t favorites = 0;
+    for (const auto &node : nodes)
+        favorites += node.is_favorite;
+    return favorites;
+}
+
+static size_t hotCountFavorites(const NodeHotTable &hot, size_t count)
+{
+    size_t favorites = 0;
+    for (size_t i = 0; i < count; i++)
+        favorites += hot.isFavorite(i);
+    return favorites;
+}
+
+/// Every slot of NodeDB's hot table must mirror the record at the same index
+static void assertNodeDBInStep(void)
+{
+    for (size_t i = 0; i < nodeDB->numMeshNodes; i++) {
+        const meshtastic_NodeInfoLite &node = nodeDB->meshNodes->at(i);
+        TEST_ASSERT_EQUAL_UINT32(node.num, nodeDB->hot.getNum(i));
+        TEST_ASSERT_EQUAL_UINT32(node.last_heard, nodeDB->hot.getLastHeard(i));
+        TEST_ASSERT_EQUAL_FLOAT(node.snr, nodeDB->hot.getSnr(i));
+        TEST_ASSERT_EQUAL(node.is_favorite, nodeDB->hot.isFavorite(i));
+        TEST_ASSERT_EQUAL_UINT8(node.hops_away, nodeDB->hot.getHopsAway(i));
+        TEST_ASSERT_TRUE(nodeDB->getMeshNode(node.num) == &node);
+    }
+}
+
+/// Just our own node, then count more with mixed favorites and last heard times
+static void fillNodeDB(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    nodeDB->meshNodes->at(0) = meshtastic_NodeInfoLite_init_zero;
+    nodeDB->meshNodes->at(0).num = nodeDB->getNodeNum();
+    nodeDB->numMeshNodes = 1;
+    nodeDB->rebuildHotTable();
+    for (size_t i = 0; i < count; i++) {
+        meshtastic_NodeInfoLite *node = nodeDB->getOrCreateMeshNode(0x20000 + i);
+        node->last_heard = 1000 + rng() % 100000;
+        node->snr = (float)(rng() % 40) - 20;
+        node->is_favorite = (rng() % 8) == 0;
+        node->has_hops_away = true;
+        node->hops_away = rng() % 8;
+        nodeDB->touchMeshNode(node);
+    }
+}
+
+void test_nodedb_sort_keeps_hot_in_step(void)
+{
+    fillNodeDB(MAX_NUM_NODES / 2, 1);
+
+    // Our own node starts out last, so the permutation has long cycles to follow
+    std::swap(nodeDB->meshNodes->at(0), nodeDB->meshNodes->at(nodeDB->numMeshNodes - 1));
+    nodeDB->rebuildHotTable();
+    std::vector<NodeNum> before;
+    for (size_t i = 0; i < nodeDB->numMeshNodes; i++)
+        before.push_back(nodeDB->meshNodes->at(i).num);
+
+    nodeDB->lastSort = 0; // Not throttled
+    nodeDB->sortMeshDB();
+    assertNodeDBInStep();
+
+    // Same nodes, in the sorted order
+    std::vector<NodeNum> after;
+    for (size_t i = 0; i < nodeDB->numMeshNodes; i++)
+        after.push_back(nodeDB->meshNodes->at(i).num);
+    std::sort(before.begin(), before.end());
+    std::sort(after.begin(), after.end());
+    TEST_ASSERT_TRUE(before == after);
+
+    TEST_ASSERT_EQUAL_UINT32(nodeDB->getNodeNum(), nodeDB->meshNodes->at(0).num);
+    for (size_t i = 2; i < nodeDB->numMeshNodes; i++) {
+        const meshtastic_NodeInfoLite &prev = nodeDB->meshNodes->at(i - 1), &node = nodeDB->meshNodes->at(i);
+        TEST_ASSERT_TRUE(prev.is_favorite >= node.is_favorite);
+        if (prev.is_favorite == node.is_favorite)
+            TEST_ASSERT_TRUE(prev.last_heard >= node.last_heard);
+    }
+}
+
+void test_nodedb_eviction_keeps_hot_in_step(void)
+{
+    fillNodeDB(MAX_NUM_NODES - 1, 2);
+    TEST_ASSERT_TRUE(nodeDB->isFull());
+
+    // The oldest node which isn't a favorite is the one to go
+    size_t oldest = 0;
+    for (size_t i = 1; i < nodeDB->numMeshNodes; i++) {
+        const meshtastic_NodeInfoLite &node = nodeDB->meshNodes->at(i);
+        if (!node.is_favorite && (oldest == 0 || node.last_heard < nodeDB->meshNodes->at(oldest).last_heard))
+            oldest = i;
+    }
+    NodeNum evicted = nodeDB->meshNodes->at(oldest).num;
+    size_t count = nodeDB->numMeshNodes;
+
+    meshtastic_NodeInfoLite *added = nodeDB->getOrCreateMeshNode(0x30000);
+    TEST_ASSERT_EQUAL(count, nodeDB->numMeshNodes);
+    TEST_ASSERT_TRUE(nodeDB->getMeshNode(evicted) == NULL);
+    TEST_ASSERT_TRUE(added == &nodeDB->meshNodes->at(count - 1));
+    assertNodeDBInStep();
+}
+
+#ifdef FSCom
+/// nodes.proto is encoded to its exact size, the footer must still be written (and check out) after it
+void test_nodes_proto_has_footer(void)
+{
+    fillNodeDB(MAX_NUM_NODES / 2, 3);
+    TEST_ASSERT_TRUE(nodeDB->saveNodeDatabaseToDisk());
+
+    auto f = FSCom.open(nodeDatabaseFileName, FILE_O_READ);
+    TEST_ASSERT_TRUE(f);
+    size_t payloadLength = 0;
+    uint32_t footerCrc = 0;
+    TEST_ASSERT_TRUE(SafeFile::readFooter(f, payloadLength, footerCrc));
+    TEST_ASSERT_EQUAL(f.size(), payloadLength + sizeof(SafeFileFooter));
+    TEST_ASSERT_TRUE(f.size() <= nodeDB->getMaxNodesAllocatedSize()); // Within what older firmware reads
+
+    std::vector<uint8_t> payload(payloadLength);
+    TEST_ASSERT_EQUAL(payloadLength, f.read(payload.data(), payload.size()));
+    f.close();
+    TEST_ASSERT_EQUAL_UINT32(footerCrc, SafeFile::updateCRC(0, payload.data(), payload.size()));
+}
+#else
+void test_nodes_proto_has_footer(void)
+{
+    TEST_IGNORE_MESSAGE("This test requires a filesystem");
+}
+#endif
+
+template <typename F> static uint64_t timeRounds(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < SCAN_ROUNDS; r++)
+        f();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void benchmarkScans(size_t count)
+{
+    TestDB db(count);
+    volatile int sink = 0;
+
+    // A miss is the worst case for getMeshNode(): every slot is looked at
+    uint64_t recordLookup = timeRounds([&] { sink = sink + recordScan(db.nodes, 0); });
+    uint64_t hotLookup = timeRounds([&] { sink = sink + db.hot.find(0, count); });
+    uint64_t recordFavorites = timeRounds([&] { sink = sink + recordCountFavorites(db.nodes); });
+    uint64_t hotFavorites = timeRounds([&] { sink = sink + hotCountFavorites(db.hot, count); });
+
+    TEST_ASSERT_EQUAL(recordCountFavorites(db.nodes), hotCountFavorites(db.hot, count));
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u nodes, %d scans: lookup %llu us -> %llu us, favorites %llu us -> %llu us", (unsigned)count,
+             SCAN_ROUNDS, (unsigned long long)recordLookup, (unsigned long long)hotLookup,
+             (unsigned long long)recordFavorites, (unsigned long long)hotFavorites);
+    TEST_MESSAGE(msg);
+}
+
+void test_benchmark_1k_nodes(void)
+{
+    benchmarkScans(SMALL_DB);
+}
+
+void test_benchmark_5k_nodes(void)
+{
+    benchmarkScans(LARGE_DB);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    nodeDB = new NodeDB;
+    UNITY_BEGIN();
+    RUN_TEST(test_set_mirrors_record);
+    RUN_TEST(test_move_copies_slot);
+    RUN_TEST(test_find_matches_record_scan);
+    RUN_TEST(test_nodedb_sort_keeps_hot_in_step);
+    RUN_TEST(test_nodedb_eviction_keeps_hot_in_step);
+    RUN_TEST(test_nodes_proto_has_footer);
+    RUN_TEST(test_benchmark_1k_nodes);
+    RUN_TEST(test_benchmark_5k_nodes);
+    exit(UNITY_END());
+}
+
+void loop() {}
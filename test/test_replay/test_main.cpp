@@ -0,0 +1,354 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "PacketCapture.h"
+#include "PowerFSM.h"
+#include "airtime.h"
+#include "concurrency/OSThread.h"
+#include "concurrency/Scheduler.h"
+#include "gps/RTC.h"
+#include "mesh/MeshService.h"
+#include "mesh/NodeDB.h"
+#include "mesh/RadioInterface.h"
+#include "mesh/ReliableRouter.h"
+#include "mesh/Router.h"
+#include "modules/Modules.h"
+#include <pb_encode.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/*
+ * Replays raw LoRa frames through the real receive path: RadioInterface::deliverToReceiver -> ReliableRouter (with its
+ * PacketHistory and NextHopRouter logic) -> perhapsDecode -> the module chain -> MeshService's to-phone queue.
+ *
+ * Set MESHTASTIC_REPLAY_CAPTURE to a pcapng written by meshtasticd's Logging: PacketCapture option to replay traffic
+ * from the field, otherwise a synthetic flood of text, position and nodeinfo packets with relayed duplicates is used.
+ * Frames are injected back to back (capture timestamps only decide the order), and every thread that is due runs
+ * between frames, so this measures how much CPU each frame costs rather than how long the capture took.
+ */
+
+static const int SYNTHETIC_NODES = 40;
+static const int SYNTHETIC_MESSAGES = 1500;
+
+struct Frame {
+    float rssi = -80;
+    float snr = 5;
+    std::vector<uint8_t> bytes;
+};
+
+/// A radio that takes its input from a list of captured frames and just counts what we would have transmitted
+class ReplayRadio : public RadioInterface
+{
+  public:
+    uint32_t transmitted = 0;
+    uint32_t relayed = 0;
+
+    using RadioInterface::getPacketTime;
+
+    ErrorCode send(meshtastic_MeshPacket *p) override
+    {
+        transmitted++;
+        if (!isFromUs(p))
+            relayed++;
+        packetPool.release(p);
+        return ERRNO_OK;
+    }
+
+    /// Standard LoRa time on air formula, explicit header with CRC and our 16 symbol preamble
+    uint32_t getPacketTime(uint32_t totalPacketLen, bool received = false) override
+    {
+        float symbolMs = (1 << sf) / bw;
+        bool lowDataRate = symbolMs > 16;
+        float payloadSymbols =
+            8 + std::max(std::ceil((8.0f * totalPacketLen - 4 * sf + 28 + 16) / (4 * (sf - 2 * lowDataRate))) * cr, 0.0f);
+        return (16 + 4.25f + payloadSymbols) * symbolMs;
+    }
+
+    /// Hand a raw frame to the router, the same way RadioLibInterface::handleReceiveInterrupt does
+    bool inject(const Frame &frame)
+    {
+        PacketHeader header;
+        if (frame.bytes.size() < sizeof(header))
+            return false;
+        memcpy(&header, frame.bytes.data(), sizeof(header));
+        size_t payloadLen = frame.bytes.size() - sizeof(header);
+        if (header.from == 0 || payloadLen > sizeof(meshtastic_MeshPacket::encrypted.bytes))
+            return false;
+
+        meshtastic_MeshPacket *mp = packetPool.allocZeroed();
+        if (!mp)
+            return false;
+        mp->from = header.from;
+        mp->to = header.to;
+        mp->id = header.id;
+        mp->channel = header.channel;
+        mp->hop_limit = header.flags & PACKET_FLAGS_HOP_LIMIT_MASK;
+        mp->hop_start = (header.flags & PACKET_FLAGS_HOP_START_MASK) >> PACKET_FLAGS_HOP_START_SHIFT;
+        mp->want_ack = !!(header.flags & PACKET_FLAGS_WANT_ACK_MASK);
+        mp->via_mqtt = !!(header.flags & PACKET_FLAGS_VIA_MQTT_MASK);
+        mp->next_hop = mp->hop_start == 0 ? NO_NEXT_HOP_PREFERENCE : header.next_hop;
+        mp->relay_node = mp->hop_start == 0 ? NO_RELAY_NODE : header.relay_node;
+        mp->rx_snr = frame.snr;
+        mp->rx_rssi = lround(frame.rssi);
+        mp->which_payload_variant = meshtastic_MeshPacket_encrypted_tag;
+        memcpy(mp->encrypted.bytes, frame.bytes.data() + sizeof(header), payloadLen);
+        mp->encrypted.size = payloadLen;
+
+        deliverToReceiver(mp);
+        return true;
+    }
+};
+
+static ReplayRadio *radio;
+
+/// Run every thread that is due until the router has nothing left to do, without waiting for future timers
+static void runUntilIdle()
+{
+    for (int i = 0; i < 100; i++) {
+        long delayMsec = concurrency::mainScheduler.runOrDelay();
+        if (delayMsec > 0 && router->getRxQueueDepth() == 0)
+            break;
+    }
+}
+
+/// Encrypt a broadcast on the primary channel and lay it out as it would be on air
+static Frame buildFrame(NodeNum from, PacketId id, uint8_t hopStart, uint8_t hopLimit, uint8_t relayNode,
+                        meshtastic_PortNum port, const meshtastic_Data_payload_t &payload)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = from;
+    p.to = NODENUM_BROADCAST;
+    p.id = id;
+    p.channel = 0;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = port;
+    p.decoded.payload = payload;
+    TEST_ASSERT_EQUAL(meshtastic_Routing_Error_NONE, perhapsEncode(&p));
+
+    PacketHeader header = {};
+    header.to = p.to;
+    header.from = p.from;
+    header.id = p.id;
+    header.flags = (hopLimit & PACKET_FLAGS_HOP_LIMIT_MASK) | (hopStart << PACKET_FLAGS_HOP_START_SHIFT);
+    header.channel = p.channel;
+    header.next_hop = NO_NEXT_HOP_PREFERENCE;
+    header.relay_node = relayNode;
+
+    Frame f;
+    f.bytes.resize(sizeof(header) + p.encrypted.size);
+    memcpy(f.bytes.data(), &header, sizeof(header));
+    memcpy(f.bytes.data() + sizeof(header), p.encrypted.bytes, p.encrypted.size);
+    return f;
+}
+
+static meshtastic_Data_payload_t encodePayload(const pb_msgdesc_t *fields, const void *src)
+{
+    meshtastic_Data_payload_t payload;
+    payload.size = pb_encode_to_bytes(payload.bytes, sizeof(payload.bytes), fields, src);
+    return payload;
+}
+
+/// Messages from SYNTHETIC_NODES nodes, each heard directly and then again via zero to three relays
+static std::vector<Frame> syntheticTrace()
+{
+    std::mt19937 rng(42);
+    std::vector<Frame> frames;
+
+    for (int i = 0; i < SYNTHETIC_MESSAGES; i++) {
+        NodeNum from = 0x10000 + rng() % SYNTHETIC_NODES;
+        PacketId id = 0x1000 + i;
+        Frame original;
+
+        switch (rng() % 3) {
+        case 0: {
+            meshtastic_Data_payload_t text;
+            text.size = snprintf((char *)text.bytes, sizeof(text.bytes), "message %d from !%08x", i, from);
+            original = buildFrame(from, id, 3, 3, from & 0xff, meshtastic_PortNum_TEXT_MESSAGE_APP, text);
+            break;
+        }
+        case 1: {
+            meshtastic_Position pos = meshtastic_Position_init_zero;
+            pos.has_latitude_i = pos.has_longitude_i = true;
+            pos.latitude_i = 520000000 + rng() % 100000;
+            pos.longitude_i = 40000000 + rng() % 100000;
+            pos.time = 1700000000 + i;
+            original = buildFrame(from, id, 3, 3, from & 0xff, meshtastic_PortNum_POSITION_APP,
+                                  encodePayload(&meshtastic_Position_msg, &pos));
+            break;
+        }
+        default: {
+            meshtastic_User user = meshtastic_User_init_zero;
+            snprintf(user.id, sizeof(user.id), "!%08x", from);
+            snprintf(user.long_name, sizeof(user.long_name), "Replay node %u", from & 0xff);
+            snprintf(user.short_name, sizeof(user.short_name), "R%02x", from & 0xff);
+            original = buildFrame(from, id, 3, 3, from & 0xff, meshtastic_PortNum_NODEINFO_APP,
+                                  encodePayload(&meshtastic_User_msg, &user));
+            break;
+        }
+        }
+        original.rssi = -60 - (int)(rng() % 60);
+        original.snr = (int)(rng() % 40) / 4.0f - 5;
+        frames.push_back(original);
+
+        // Rebroadcasts: same packet, fewer hops left, a different relayer
+        int relays = rng() % 4;
+        for (int r = 1; r <= relays && r < 3; r++) {
+            Frame copy = original;
+            PacketHeader *h = (PacketHeader *)copy.bytes.data();
+            h->flags = (h->flags & ~PACKET_FLAGS_HOP_LIMIT_MASK) | (3 - r);
+            h->relay_node = 0x80 + rng() % 0x40;
+            copy.rssi = -70 - (int)(rng() % 50);
+            frames.push_back(copy);
+        }
+    }
+    return frames;
+}
+
+static std::vector<Frame> loadTrace()
+{
+    const char *path = getenv("MESHTASTIC_REPLAY_CAPTURE");
+    if (!path)
+        return syntheticTrace();
+
+    std::vector<Frame> frames;
+    bool ok = PacketCapture::read(path, [&](const PacketCapture::CapturedFrame &c) {
+        if (c.transmitted)
+            return; // what we sent back then is what the router is supposed to work out now
+        Frame f;
+        f.rssi = c.radio.rssi;
+        f.snr = c.radio.snr;
+        f.bytes.assign(c.data, c.data + c.len);
+        frames.push_back(std::move(f));
+    });
+    TEST_ASSERT_TRUE_MESSAGE(ok, "Unable to read MESHTASTIC_REPLAY_CAPTURE");
+    return frames;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_duplicate_is_suppressed(void)
+{
+    meshtastic_Position pos = meshtastic_Position_init_zero;
+    pos.has_latitude_i = true;
+    pos.latitude_i = 1;
+    Frame f = buildFrame(0x20001, 0x7777, 3, 3, 0x01, meshtastic_PortNum_POSITION_APP,
+                         encodePayload(&meshtastic_Position_msg, &pos));
+
+    PacketHistory::Stats before = router->getStats();
+    TEST_ASSERT_TRUE(radio->inject(f));
+    runUntilIdle();
+    TEST_ASSERT_TRUE(radio->inject(f));
+    runUntilIdle();
+    PacketHistory::Stats after = router->getStats();
+
+    TEST_ASSERT_GREATER_OR_EQUAL(2, after.lookups - before.lookups);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, after.duplicates - before.duplicates);
+}
+
+void test_replay_trace(void)
+{
+    std::vector<Frame> frames = loadTrace();
+    TEST_ASSERT_GREATER_THAN(0, frames.size());
+
+    PacketHistory::Stats before = router->getStats();
+    uint32_t relayedBefore = radio->relayed;
+    int maxRxQueue = 0;
+    int maxToPhone = 0;
+    uint64_t injectUs = 0;
+    uint64_t decodeUs = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Frame &f : frames) {
+        // perhapsDecode alone, on a copy, to split decoding from the rest of the router's work
+        meshtastic_MeshPacket copy = meshtastic_MeshPacket_init_zero;
+        PacketHeader header;
+        memcpy(&header, f.bytes.data(), sizeof(header));
+        copy.from = header.from;
+        copy.id = header.id;
+        copy.channel = header.channel;
+        copy.which_payload_variant = meshtastic_MeshPacket_encrypted_tag;
+        copy.encrypted.size = f.bytes.size() - sizeof(header);
+        memcpy(copy.encrypted.bytes, f.bytes.data() + sizeof(header), copy.encrypted.size);
+        auto t0 = std::chrono::steady_clock::now();
+        perhapsDecode(&copy);
+        auto t1 = std::chrono::steady_clock::now();
+        radio->inject(f);
+        auto t2 = std::chrono::steady_clock::now();
+        decodeUs += std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+        injectUs += std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+        maxRxQueue = std::max(maxRxQueue, router->getRxQueueDepth());
+        runUntilIdle();
+        maxToPhone = std::max(maxToPhone, service->getToPhoneQueueDepth());
+    }
+    auto wallUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    PacketHistory::Stats after = router->getStats();
+    uint32_t lookups = after.lookups - before.lookups;
+    uint32_t duplicates = after.duplicates - before.duplicates;
+
+    char msg[200];
+    snprintf(msg, sizeof(msg), "%u frames in %llu ms (%llu us/frame): inject %llu us, decode %llu us", (unsigned)frames.size(),
+             (unsigned long long)wallUs / 1000, (unsigned long long)wallUs / frames.size(), (unsigned long long)injectUs,
+             (unsigned long long)decodeUs);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "duplicates %u of %u lookups (%.1f%%), relays scheduled %u", duplicates, lookups,
+             lookups ? 100.0 * duplicates / lookups : 0.0, radio->relayed - relayedBefore);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "rx queue max %d, to-phone queue max %d, packet pool high water %u", maxRxQueue, maxToPhone,
+             packetPool.getHighWater());
+    TEST_MESSAGE(msg);
+
+    // Per-stage CPU time: whatever each thread (Router, modules...) spent in runOnce during the replay
+    for (int i = 0; i < MAX_THREADS; i++) {
+        auto thread = static_cast<concurrency::OSThread *>(concurrency::mainController.get(i));
+        if (!thread || !thread->getProfile().count)
+            continue;
+        const concurrency::ThreadProfile &p = thread->getProfile();
+        snprintf(msg, sizeof(msg), "thread %s: runs=%u total=%llu us max=%u us p99<%u us", thread->ThreadName.c_str(),
+                 p.count, (unsigned long long)p.totalUs, p.maxUs, p.percentileUs(99));
+        TEST_MESSAGE(msg);
+    }
+
+    TEST_ASSERT_GREATER_THAN(0, lookups);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+
+    // The same order main.cpp brings the mesh up in
+    nodeDB = new NodeDB;
+    router = new ReliableRouter();
+    service = new MeshService();
+    service->init();
+    setupModules();
+    airTime = new AirTime();
+    radio = new ReplayRadio();
+    radio->init();
+    router->addInterface(radio);
+    PowerFSM_setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_duplicate_is_suppressed);
+    RUN_TEST(test_replay_trace);
+    exit(UNITY_END());
+}
+
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires the ARCH_PORTDUINO variant");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
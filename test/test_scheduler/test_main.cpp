@@ -0,0 +1,157 @@
+#include "concurrency/OSThread.h"
+#include "concurrency/Scheduler.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <vector>
+
+using namespace concurrency;
+
+class TestThread;
+static std::vector<TestThread *> ran; // In the order the scheduler ran them
+
+/// Counts its runs, then waits next msecs (or disables itself)
+class TestThread : public OSThread
+{
+  public:
+    TestThread(const char *name, uint32_t period, int32_t next = -1) : OSThread(name, period), period(period), next(next) {}
+
+    uint32_t period;
+    int runs = 0;
+    int32_t next;                 // Interval after each run, -1 to disable
+    TestThread *victim = nullptr; // Deleted when we run
+
+  protected:
+    virtual int32_t runOnce() override
+    {
+        runs++;
+        ran.push_back(this);
+        if (victim) {
+            delete victim;
+            victim = nullptr;
+        }
+        return next < 0 ? disable() : next;
+    }
+};
+
+/// Spin the main loop for a while, as main.cpp does (other than actually sleeping)
+static void runFor(uint32_t ms)
+{
+    uint32_t start = millis();
+    while (millis() - start < ms) {
+        mainScheduler.runOrDelay();
+        delay(1);
+    }
+}
+
+void setUp(void)
+{
+    ran.clear();
+}
+void tearDown(void) {}
+
+void test_runs_in_deadline_order(void)
+{
+    // Added out of order, each due 10 ms after the one before
+    const uint32_t periods[] = {50, 20, 80, 10, 40, 70, 30, 60};
+    std::vector<TestThread *> threads;
+    for (uint32_t period : periods)
+        threads.push_back(new TestThread("order", period));
+
+    runFor(150);
+
+    TEST_ASSERT_EQUAL(8, ran.size());
+    for (size_t i = 1; i < ran.size(); i++)
+        TEST_ASSERT_TRUE(ran[i - 1]->period < ran[i]->period);
+
+    for (TestThread *t : threads) {
+        TEST_ASSERT_EQUAL(1, t->runs); // Disabled after its one run
+        delete t;
+    }
+}
+
+void test_delay_is_time_to_next_deadline(void)
+{
+    TestThread t("delay", 200);
+
+    // Whatever else is registered (e.g. the console) may be due sooner, never later
+    long delayMs = mainScheduler.runOrDelay();
+    TEST_ASSERT_TRUE(delayMs <= 200);
+    TEST_ASSERT_EQUAL(0, t.runs);
+}
+
+void test_set_interval_rekeys_waiting_thread(void)
+{
+    TestThread sooner("sooner", 10000);
+    TestThread later("later", 20, -1);
+
+    // While both wait, one is pulled in and the other pushed out
+    sooner.setInterval(0);
+    later.setIntervalFromNow(10000);
+    runFor(60);
+    TEST_ASSERT_EQUAL(1, sooner.runs);
+    TEST_ASSERT_EQUAL(0, later.runs);
+
+    // And back again
+    later.setInterval(0);
+    runFor(20);
+    TEST_ASSERT_EQUAL(1, later.runs);
+}
+
+void test_repeating_thread_keeps_its_period(void)
+{
+    TestThread t("repeat", 10, 10);
+    runFor(105);
+    TEST_ASSERT_TRUE(t.runs >= 5);
+    TEST_ASSERT_TRUE(t.runs <= 11);
+}
+
+void test_disabled_thread_parks_until_enabled(void)
+{
+    TestThread t("parked", 10, 10);
+    t.enabled = false; // Directly, the way some modules do, without disable()
+
+    runFor(50);
+    TEST_ASSERT_EQUAL(0, t.runs);
+
+    t.enabled = true;
+    runFor(5);
+    TEST_ASSERT_TRUE(t.runs >= 1);
+
+    // Parked again while waiting, then removed while parked
+    t.enabled = false;
+    runFor(30);
+    int runs = t.runs;
+    runFor(30);
+    TEST_ASSERT_EQUAL(runs, t.runs);
+}
+
+void test_thread_deleted_by_another(void)
+{
+    TestThread *victim = new TestThread("victim", 40);
+    TestThread killer("killer", 10);
+    TestThread bystander("bystander", 30);
+    killer.victim = victim;
+
+    runFor(80);
+    TEST_ASSERT_EQUAL(1, killer.runs);
+    TEST_ASSERT_EQUAL(1, bystander.runs);
+    TEST_ASSERT_EQUAL(2, ran.size()); // Never the victim
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_runs_in_deadline_order);
+    RUN_TEST(test_delay_is_time_to_next_deadline);
+    RUN_TEST(test_set_interval_rekeys_waiting_thread);
+    RUN_TEST(test_repeating_thread_keeps_its_period);
+    RUN_TEST(test_disabled_thread_parks_until_enabled);
+    RUN_TEST(test_thread_deleted_by_another);
+    exit(UNITY_END());
+}
+
+void loop() {}
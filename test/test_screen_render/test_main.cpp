@@ -0,0 +1,291 @@
+#include "DebugConfiguration.h"
+#include "RenderUtil.h"
+#include "TestUtil.h"
+#include "configuration.h"
+#include <unity.h>
+
+#if HAS_SCREEN
+
+#include "mesh/MeshService.h"
+#include "MessageStore.h"
+#include "NodeDB.h"
+#include "graphics/Screen.h"
+#include "graphics/SharedUIDisplay.h"
+#include "graphics/draw/ClockRenderer.h"
+#include "graphics/draw/DebugRenderer.h"
+#include "graphics/draw/MessageRenderer.h"
+#include "graphics/draw/NodeListRenderer.h"
+#include "graphics/draw/UIRenderer.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// The common 0.96" OLED. Try others with -D RENDER_WIDTH=... -D RENDER_HEIGHT=...
+#ifndef RENDER_WIDTH
+#define RENDER_WIDTH 128
+#endif
+#ifndef RENDER_HEIGHT
+#define RENDER_HEIGHT 64
+#endif
+
+// A big mesh (MessageStore keeps MESSAGE_HISTORY_LIMIT of the messages, see env:native-render)
+#define RENDER_NODES 1000
+#define RENDER_MESSAGES 500
+
+#define RENDERS_PER_FRAME 20
+
+/// An OLEDDisplay which only keeps its buffer in memory
+class MemoryOLED : public OLEDDisplay
+{
+  public:
+    MemoryOLED(uint16_t width, uint16_t height) { setGeometry(GEOMETRY_RAWMODE, width, height); }
+    virtual void display() override { flushes++; }
+
+    /// The buffer, in the SSD1306 layout: a byte is 8 rows of one column, pages of 8 rows from the top
+    const uint8_t *getBuffer() { return buffer; }
+    size_t getBufferSize() { return (size_t)width() * ((height() + 7) / 8); }
+    bool getPixel(uint16_t x, uint16_t y) { return buffer[x + (y / 8) * width()] & (1 << (y & 7)); }
+
+    uint32_t flushes = 0;
+
+  protected:
+    virtual int getBufferOffset(void) override { return 0; }
+    virtual void sendCommand(uint8_t com) override {}
+    virtual bool connect() override { return true; }
+};
+
+static MemoryOLED *display;
+static OLEDDisplayUiState uiState;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+struct Frame {
+    const char *name;
+    FrameCallback draw;
+};
+
+// Every frame of the normal frameset which needs no radio or module behind it
+static const Frame frames[] = {
+    {"home", graphics::UIRenderer::drawDeviceFocused},
+    {"messages", graphics::MessageRenderer::drawTextMessageFrame},
+    {"nodes", graphics::NodeListRenderer::drawDynamicListScreen_Nodes},
+    {"location", graphics::NodeListRenderer::drawDynamicListScreen_Location},
+    {"last_heard", graphics::NodeListRenderer::drawLastHeardScreen},
+    {"hop_signal", graphics::NodeListRenderer::drawHopSignalScreen},
+    {"distance", graphics::NodeListRenderer::drawDistanceScreen},
+    {"bearings", graphics::NodeListRenderer::drawNodeListWithCompasses},
+#if HAS_GPS
+    {"gps", graphics::UIRenderer::drawCompassAndLocationScreen},
+#endif
+    {"system", graphics::DebugRenderer::drawSystemScreen},
+    {"clock_digital", graphics::ClockRenderer::drawDigitalClockFrame},
+    {"clock_analog", graphics::ClockRenderer::drawAnalogClockFrame},
+};
+
+static size_t countLit(const std::vector<uint8_t> &image)
+{
+    size_t lit = 0;
+    for (uint8_t b : image)
+        lit += __builtin_popcount(b);
+    return lit;
+}
+
+static size_t countChanged(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b)
+{
+    size_t changed = 0;
+    for (size_t i = 0; i < a.size() && i < b.size(); i++)
+        changed += __builtin_popcount(a[i] ^ b[i]);
+    return changed;
+}
+
+static void dumpPNG(const char *name)
+{
+    const char *dir = getGoldenDir();
+    if (!dir)
+        return;
+
+    // Pages of columns to rows of pixels
+    const size_t stride = (display->width() + 7) / 8;
+    std::vector<uint8_t> rows(stride * display->height(), 0);
+    for (uint16_t y = 0; y < display->height(); y++)
+        for (uint16_t x = 0; x < display->width(); x++)
+            if (display->getPixel(x, y))
+                rows[y * stride + x / 8] |= 0x80 >> (x % 8);
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/screen_%ux%u_%s.png", dir, display->width(), display->height(), name);
+    TEST_ASSERT_TRUE_MESSAGE(writePNG(path, display->width(), display->height(), rows, true), path);
+}
+
+/// Render every frame, as the carousel would show them one after the other
+void test_render_frames(void)
+{
+    char msg[160];
+    std::vector<uint8_t> image, previous(display->getBufferSize(), 0);
+
+    TEST_MESSAGE("frame            first us   avg us   lit px  changed px  hash");
+    for (const Frame &frame : frames) {
+        // The first render fills the caches, the rest are what an idle screen costs
+        auto start = std::chrono::steady_clock::now();
+        display->clear();
+        frame.draw(display, &uiState, 0, 0);
+        auto firstUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < RENDERS_PER_FRAME; i++) {
+            display->clear();
+            frame.draw(display, &uiState, 0, 0);
+        }
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        image.assign(display->getBuffer(), display->getBuffer() + display->getBufferSize());
+        size_t lit = countLit(image);
+
+        // Pixels a panel would have to rewrite, coming from the frame before
+        size_t changed = countChanged(image, previous);
+        previous = image;
+
+        snprintf(msg, sizeof(msg), "%-14s %10lld %8.1f %8u %11u  %08x", frame.name, (long long)firstUs,
+                 (double)us / RENDERS_PER_FRAME, (unsigned)lit, (unsigned)changed, hashImage(image.data(), image.size()));
+        TEST_MESSAGE(msg);
+
+        TEST_ASSERT_TRUE_MESSAGE(lit > 0, frame.name); // Every frame has at least its header
+        dumpPNG(frame.name);
+    }
+}
+
+/// Nothing in NodeDB changed: the node list is drawn from its cached rows, and must look the same
+void test_node_list_repeatable(void)
+{
+    display->clear();
+    graphics::NodeListRenderer::drawLastHeardScreen(display, &uiState, 0, 0);
+    std::vector<uint8_t> first(display->getBuffer(), display->getBuffer() + display->getBufferSize());
+
+    display->clear();
+    graphics::NodeListRenderer::drawLastHeardScreen(display, &uiState, 0, 0);
+    TEST_ASSERT_EQUAL_MEMORY(first.data(), display->getBuffer(), first.size());
+}
+
+#if SCREEN_CHANGE_DRIVEN
+/// Mark the frame as just drawn, the way runOnce does after ui->update()
+static void frameDrawn()
+{
+    screen->frameNeedsRender(); // Take in whatever changed before
+    screen->frameDirty = false;
+    screen->lastRenderMs = millis();
+}
+
+/// A node list with nothing new is skipped, anything it shows changing (or any reason to animate) draws it again
+void test_change_driven_skip_and_force(void)
+{
+    // A node list on show and settled: no transition, banner or recent input
+    OLEDDisplayUiState *state = screen->ui->getUiState();
+    screen->showingNormalScreen = true;
+    screen->framesetInfo.positions.nodelist_lastheard = 0;
+    state->currentFrame = 0;
+    state->frameState = FIXED;
+    screen->lastInputMs = millis() - 60 * 1000;
+
+    frameDrawn();
+    TEST_ASSERT_FALSE(screen->frameNeedsRender());
+
+    nodeDB->touchMeshNode(nodeDB->getMeshNodeByIndex(1));
+    TEST_ASSERT_TRUE(screen->frameNeedsRender());
+    frameDrawn();
+    TEST_ASSERT_FALSE(screen->frameNeedsRender());
+
+    messageStore.addFromString(0x10001, 0, "one more");
+    TEST_ASSERT_TRUE(screen->frameNeedsRender());
+    frameDrawn();
+
+    // Nothing changed, but it is time for the periodic refresh
+    screen->lastRenderMs = millis() - 24 * 60 * 60 * 1000;
+    TEST_ASSERT_TRUE(screen->frameNeedsRender());
+    frameDrawn();
+
+    screen->lastInputMs = millis();
+    TEST_ASSERT_TRUE(screen->frameNeedsRender());
+    screen->lastInputMs = millis() - 60 * 1000;
+
+    state->frameState = IN_TRANSITION;
+    TEST_ASSERT_TRUE(screen->frameNeedsRender());
+    state->frameState = FIXED;
+
+    // Any other frame has a clock or other content we don't watch
+    state->currentFrame = 1;
+    TEST_ASSERT_TRUE(screen->frameNeedsRender());
+    state->currentFrame = 0;
+
+    TEST_ASSERT_FALSE(screen->frameNeedsRender());
+    screen->framesetInfo.positions.nodelist_lastheard = 255;
+}
+#else
+void test_change_driven_skip_and_force(void)
+{
+    TEST_IGNORE_MESSAGE("This test requires SCREEN_CHANGE_DRIVEN, such as native-render");
+}
+#endif
+
+static void populateMessages()
+{
+    static const char *texts[] = {
+        "On my way",
+        "Anyone hearing this from the north ridge? Signal is patchy up here but the view is worth it",
+        "Meet at the north gate at six?",
+        "The quick brown fox jumps over the lazy dog, then keeps on running across the whole width of the display so that "
+        "the text has to wrap over several lines.",
+    };
+    for (uint32_t i = 0; i < RENDER_MESSAGES; i++)
+        messageStore.addFromString(0x10000 + (i * 7919) % RENDER_NODES, 0, texts[i % 4]);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    portduino_config.MaxNodes = RENDER_NODES + 1; // and ours
+    nodeDB = new NodeDB;
+    service = new MeshService();
+    populateNodeDB(RENDER_NODES);
+    populateMessages();
+
+    // Screen's frames draw to our display, without running Screen::setup() (which needs the modules)
+    display = new MemoryOLED(RENDER_WIDTH, RENDER_HEIGHT);
+    display->init();
+    screen = new graphics::Screen(display);
+    graphics::currentResolution = graphics::determineScreenResolution(display->height(), display->width());
+    uiState.userData = screen;
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%ux%u, %u nodes, %u messages kept", display->width(), display->height(),
+             (unsigned)nodeDB->getNumMeshNodes(), (unsigned)messageStore.getMessages().size());
+    TEST_MESSAGE(msg);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_render_frames);
+    RUN_TEST(test_node_list_repeatable);
+    RUN_TEST(test_change_driven_skip_and_force);
+    exit(UNITY_END());
+}
+
+#else
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_skipped(void)
+{
+    TEST_IGNORE_MESSAGE("This test requires a build with a Screen, such as native-render");
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_skipped);
+    exit(UNITY_END());
+}
+#endif
+
+void loop() {}
@@ -0,0 +1,274 @@
+#include "PointerQueue.h"
+#include "concurrency/OSThread.h"
+#include "SPSCPointerQueue.h"
+#include "StaticPointerQueue.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <chrono>
+#include <stdio.h>
+
+#ifdef ARCH_PORTDUINO
+#include "concurrency/InterruptableDelay.h"
+#include <atomic>
+#include <thread>
+#endif
+
+static int items[64];
+static volatile uintptr_t sink; // keeps the optimizer from dropping benchmark loops
+
+/// Stands in for the Router thread, which is the fromRadioQueue's reader
+class IdleThread : public concurrency::OSThread
+{
+  public:
+    IdleThread() : OSThread("idle", 60 * 1000) {}
+
+  protected:
+    virtual int32_t runOnce() override { return 60 * 1000; }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fifo_order_full_and_empty(void)
+{
+    SPSCPointerQueue<int, 8> q;
+    TEST_ASSERT_TRUE(q.isEmpty());
+    TEST_ASSERT_NULL(q.dequeuePtr(0));
+
+    for (int i = 0; i < 8; i++)
+        TEST_ASSERT_TRUE(q.enqueue(&items[i], 0));
+    TEST_ASSERT_FALSE(q.enqueue(&items[8], 0));
+    TEST_ASSERT_EQUAL(8, q.numUsed());
+    TEST_ASSERT_EQUAL(0, q.numFree());
+
+    for (int i = 0; i < 8; i++)
+        TEST_ASSERT_EQUAL_PTR(&items[i], q.dequeuePtr(0));
+    TEST_ASSERT_TRUE(q.isEmpty());
+    TEST_ASSERT_NULL(q.dequeuePtr(0));
+}
+
+/// A full queue refuses new entries (the caller counts them as dropped) and keeps the ones it has
+void test_full_queue_drops_newest(void)
+{
+    SPSCPointerQueue<int, 8> q;
+    int dropped = 0;
+    for (int i = 0; i < 20; i++)
+        if (!q.enqueue(&items[i], 0))
+            dropped++;
+    TEST_ASSERT_EQUAL(12, dropped);
+
+    // Room again after one is taken, and the oldest are still there in order
+    TEST_ASSERT_EQUAL_PTR(&items[0], q.dequeuePtr(0));
+    TEST_ASSERT_TRUE(q.enqueue(&items[20], 0));
+    for (int i = 1; i < 8; i++)
+        TEST_ASSERT_EQUAL_PTR(&items[i], q.dequeuePtr(0));
+    TEST_ASSERT_EQUAL_PTR(&items[20], q.dequeuePtr(0));
+    TEST_ASSERT_TRUE(q.isEmpty());
+}
+
+/// Enqueueing makes the reader due straight away and wakes the main loop out of its delay
+void test_enqueue_wakes_reader(void)
+{
+    SPSCPointerQueue<int, 4> q;
+    IdleThread reader;
+    q.setReader(&reader);
+    concurrency::mainDelay.delay(0); // forget any wakeup still pending from earlier
+
+    TEST_ASSERT_FALSE(reader.shouldRun(millis()));
+    TEST_ASSERT_TRUE(q.enqueue(&items[0], 0));
+    TEST_ASSERT_TRUE(reader.shouldRun(millis()));
+    TEST_ASSERT_FALSE(concurrency::mainDelay.delay(1000)); // false: interrupted, not timed out
+
+    // A refused enqueue doesn't wake anyone
+    SPSCPointerQueue<int, 1> full;
+    IdleThread other;
+    full.setReader(&other);
+    TEST_ASSERT_TRUE(full.enqueue(&items[0], 0));
+    other.setIntervalFromNow(60 * 1000);
+    concurrency::mainDelay.delay(0);
+    TEST_ASSERT_FALSE(full.enqueue(&items[1], 0));
+    TEST_ASSERT_FALSE(other.shouldRun(millis()));
+}
+
+void test_wraps_around(void)
+{
+    SPSCPointerQueue<int, 4> q;
+    int next = 0, expected = 0;
+
+    // Keep it partly full while the indexes go round many times
+    for (int round = 0; round < 1000; round++) {
+        while (q.numFree() > 1)
+            TEST_ASSERT_TRUE(q.enqueue(&items[next++ % 64], 0));
+        while (q.numUsed() > 1)
+            TEST_ASSERT_EQUAL_PTR(&items[expected++ % 64], q.dequeuePtr(0));
+    }
+    TEST_ASSERT_EQUAL(1, q.numUsed());
+}
+
+#ifdef ARCH_PORTDUINO
+void test_two_threads_keep_order(void)
+{
+    static SPSCPointerQueue<int, 4> q;
+    const uintptr_t count = 200000;
+    std::atomic<bool> failed{false};
+
+    // The 'pointers' are just a counter, so order and loss are easy to check
+    std::thread producer([&] {
+        for (uintptr_t i = 1; i <= count; i++)
+            while (!q.enqueue((int *)i, 0))
+                std::this_thread::yield();
+    });
+    uintptr_t expected = 1;
+    while (expected <= count) {
+        int *p = q.dequeuePtr(0);
+        if (!p) {
+            std::this_thread::yield();
+            continue;
+        }
+        if ((uintptr_t)p != expected)
+            failed = true;
+        expected++;
+    }
+    producer.join();
+
+    TEST_ASSERT_FALSE(failed);
+    TEST_ASSERT_TRUE(q.isEmpty());
+}
+
+/// A producer that never waits, as the radio ISR doesn't: whatever didn't fit is counted, the rest arrives in order
+void test_two_threads_count_drops(void)
+{
+    static SPSCPointerQueue<int, 4> q;
+    const uintptr_t count = 200000;
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> dropped{0};
+
+    std::thread producer([&] {
+        for (uintptr_t i = 1; i <= count; i++)
+            if (!q.enqueue((int *)i, 0))
+                dropped++;
+        done = true;
+    });
+    uintptr_t received = 0, last = 0;
+    bool ordered = true;
+    for (;;) {
+        bool finished = done; // read before the queue, so nothing can be enqueued after our last look
+        int *p = q.dequeuePtr(0);
+        if (p) {
+            ordered = ordered && (uintptr_t)p > last;
+            last = (uintptr_t)p;
+            received++;
+        } else if (finished) {
+            break;
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT32(count, received + dropped);
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "unthrottled producer: %u of %u dropped", (unsigned)dropped, (unsigned)count);
+    TEST_MESSAGE(msg);
+}
+#endif
+
+/// ns per enqueue+dequeue pair, keeping a few packets in flight like the router does
+template <class Q> static double benchmarkPairs(Q &q)
+{
+    const int rounds = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        q.enqueue(&items[i & 63], 0);
+        if (q.numUsed() > 2)
+            sink = sink + (uintptr_t)q.dequeuePtr(0);
+    }
+    while (q.dequeuePtr(0))
+        ;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return (double)ns / rounds;
+}
+
+void test_benchmark_enqueue_dequeue(void)
+{
+    SPSCPointerQueue<int, 4> spsc;
+    StaticPointerQueue<int, 4> fixed;
+    PointerQueue<int> pointer(4);
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "enqueue+dequeue: SPSCPointerQueue %.1f ns, StaticPointerQueue %.1f ns, PointerQueue %.1f ns",
+             benchmarkPairs(spsc), benchmarkPairs(fixed), benchmarkPairs(pointer));
+    TEST_MESSAGE(msg);
+}
+
+#ifdef ARCH_PORTDUINO
+void test_benchmark_wake_latency(void)
+{
+    // What the router sees: the RX side enqueues and interrupts the delay the main loop is sleeping in
+    static SPSCPointerQueue<int, 4> q;
+    static concurrency::InterruptableDelay wakeup;
+    const int rounds = 2000;
+    std::atomic<bool> ready{false};
+    std::chrono::steady_clock::time_point sent;
+    uint64_t totalUs = 0, maxUs = 0;
+    int received = 0, timeouts = 0;
+
+    std::thread consumer([&] {
+        for (int i = 0; i < rounds; i++) {
+            ready = true;
+            while (q.isEmpty())
+                if (wakeup.delay(10 * 1000))
+                    timeouts++;
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sent).count();
+            if (q.dequeuePtr(0) == &items[0])
+                received++;
+            totalUs += us;
+            if ((uint64_t)us > maxUs)
+                maxUs = us;
+        }
+    });
+    for (int i = 0; i < rounds; i++) {
+        while (!ready)
+            std::this_thread::yield();
+        ready = false;
+        std::this_thread::sleep_for(std::chrono::microseconds(200)); // let the consumer go to sleep
+        sent = std::chrono::steady_clock::now();
+        q.enqueue(&items[0], 0);
+        wakeup.interrupt();
+    }
+    consumer.join();
+
+    char msg[100];
+    snprintf(msg, sizeof(msg), "wake latency: avg %llu us, max %llu us over %d packets", (unsigned long long)(totalUs / rounds),
+             (unsigned long long)maxUs, rounds);
+    TEST_MESSAGE(msg);
+
+    // Every packet arrived, and every sleep ended because of one rather than by timing out
+    TEST_ASSERT_EQUAL(rounds, received);
+    TEST_ASSERT_EQUAL(0, timeouts);
+    TEST_ASSERT_TRUE(q.isEmpty());
+}
+#endif
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_order_full_and_empty);
+    RUN_TEST(test_full_queue_drops_newest);
+    RUN_TEST(test_enqueue_wakes_reader);
+    RUN_TEST(test_wraps_around);
+#ifdef ARCH_PORTDUINO
+    RUN_TEST(test_two_threads_keep_order);
+    RUN_TEST(test_two_threads_count_drops);
+#endif
+    RUN_TEST(test_benchmark_enqueue_dequeue);
+#ifdef ARCH_PORTDUINO
+    RUN_TEST(test_benchmark_wake_latency);
+#endif
+    exit(UNITY_END());
+}
+
+void loop() {}